@@ -0,0 +1,921 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Scores every WAV file below a directory with the impulse in lib/audio_classifire.
+ *
+ * Files are cut into windows of EI_CLASSIFIER_RAW_SAMPLE_COUNT samples (files shorter
+ * than a window are zero padded to one window). Runs of up to --batch windows of a file
+ * go through run_classifier_batch() on a work-stealing thread pool. Results go to stdout
+ * (or --out) as CSV or JSONL, in file and window order no matter how many threads ran.
+ * Throughput and, for files whose parent directory or name prefix ("<label>.<id>.wav")
+ * is a label, a confusion matrix go to stderr.
+ *
+ * Samples are converted like src/main.cpp does on the device (int16 / 32767), and the
+ * DSP uses the same real FFT and no fused multiply-add (-ffp-contract=off, as in
+ * platformio.ini). The C library is still different: glibc and newlib may round
+ * logf / expf differently in the last bit, which can move a quantized feature by one
+ * step. Scores therefore agree with the device to within a few output quantization
+ * steps (1/256 each), not bit for bit. --check compares the results with a CSV from an
+ * earlier run within such a tolerance. golden/ holds the regression case the CMake test
+ * runs, one WAV with its scores, recorded with --raw --hop 4000.
+ * Build with CMakeLists.txt next to this file, which sets EI_CLASSIFIER_TFLITE_REENTRANT.
+ *
+ * With --early-exit <head> the corpus is scored twice, first with the full model and
+ * then with the early exit head attached, and the exit rate, the agreement with the
+ * full model and the throughput of both passes go to stderr. The results are those
+ * of the second pass.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <dirent.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+#if !EI_CLASSIFIER_TFLITE_REENTRANT
+#error "batch_scorer runs the model from several threads, build with EI_CLASSIFIER_TFLITE_REENTRANT=1"
+#endif
+
+/** Decoded audio of one file, shared by its windows */
+typedef struct {
+    std::vector<int16_t> samples;
+    uint32_t frequency;
+} wav_data_t;
+
+/** Scores of one window */
+typedef struct {
+    size_t offset;
+    EI_IMPULSE_ERROR status;
+    float scores[EI_CLASSIFIER_LABEL_COUNT];
+    int predicted;
+} window_result_t;
+
+/** A file still to load (wav == nullptr) or a run of windows of a loaded file */
+typedef struct {
+    size_t file_ix;
+    size_t window_ix;
+    size_t count;
+    std::shared_ptr<const wav_data_t> wav;
+} task_t;
+
+typedef struct {
+    std::string path;
+    int label;      // index into ei_classifier_inferencing_categories, -1 if unknown
+    bool loaded;
+    std::vector<window_result_t> windows;
+} file_entry_t;
+
+typedef struct {
+    std::mutex lock;
+    std::deque<task_t> tasks;
+} worker_queue_t;
+
+/* Private variables ------------------------------------------------------- */
+static std::vector<file_entry_t> files;
+static std::vector<std::unique_ptr<worker_queue_t>> queues;
+// tasks queued or running, workers stop when this reaches zero
+static std::atomic<size_t> pending(0);
+// idle workers sleep on work_ready until work_epoch moves: new windows were queued or
+// the last task finished
+static std::mutex work_lock;
+static std::condition_variable work_ready;
+static uint64_t work_epoch = 0;
+static size_t hop = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+static size_t batch_size = 8;
+static bool scale_samples = true;
+
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+static std::vector<float> head_weights;
+static std::vector<float> head_bias;
+static ei_tflite_early_exit_head_t head = { 0 };
+#endif
+
+/**
+ * SDK messages go to stderr so they cannot end up in the results on stdout
+ */
+void ei_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+/* Private functions ------------------------------------------------------- */
+
+static int label_index(const std::string &name) {
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (name == ei_classifier_inferencing_categories[ix]) {
+            return (int)ix;
+        }
+    }
+    return -1;
+}
+
+static bool ends_with_wav(const char *name) {
+    size_t len = strlen(name);
+    return len > 4 && strcasecmp(name + len - 4, ".wav") == 0;
+}
+
+/**
+ * Collect WAV files below dir, the label comes from the parent directory or the name prefix
+ */
+static void find_files(const std::string &dir, const std::string &dir_name) {
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+        fprintf(stderr, "ERR: Cannot open directory %s\n", dir.c_str());
+        return;
+    }
+
+    std::vector<std::string> names;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for (const std::string &name : names) {
+        std::string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            find_files(path, name);
+        }
+        else if (S_ISREG(st.st_mode) && ends_with_wav(name.c_str())) {
+            file_entry_t file;
+            file.path = path;
+            file.label = label_index(dir_name);
+            if (file.label < 0) {
+                file.label = label_index(name.substr(0, name.find('.')));
+            }
+            file.loaded = false;
+            files.push_back(file);
+        }
+    }
+}
+
+static uint32_t read_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * Read a 16 bit PCM or 32 bit float WAV file, keeps the first channel
+ *
+ * @return true if successful
+ */
+static bool read_wav(const char *path, wav_data_t *wav) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "ERR: Cannot open %s\n", path);
+        return false;
+    }
+
+    uint8_t header[12];
+    if (fread(header, 1, 12, f) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "ERR: %s is not a WAV file\n", path);
+        fclose(f);
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    bool have_fmt = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, f) == 8) {
+        uint32_t size = read_u32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint8_t fmt[16];
+            if (fread(fmt, 1, 16, f) != 16) {
+                break;
+            }
+            format = read_u16(fmt);
+            channels = read_u16(fmt + 2);
+            wav->frequency = read_u32(fmt + 4);
+            bits = read_u16(fmt + 14);
+            have_fmt = true;
+            fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        }
+        else if (memcmp(chunk, "data", 4) == 0 && have_fmt) {
+            bool pcm16 = format == 1 && bits == 16;
+            bool float32 = format == 3 && bits == 32;
+            if ((!pcm16 && !float32) || channels == 0) {
+                fprintf(stderr, "ERR: %s: only 16 bit PCM and 32 bit float WAV files are supported\n", path);
+                break;
+            }
+
+            // streaming WAVs say 0xFFFFFFFF and truncated files say more than they hold,
+            // only trust the size as far as the file goes
+            long data_start = ftell(f);
+            fseek(f, 0, SEEK_END);
+            long file_end = ftell(f);
+            fseek(f, data_start, SEEK_SET);
+            if (data_start >= 0 && file_end >= data_start && (uint64_t)(file_end - data_start) < size) {
+                size = (uint32_t)(file_end - data_start);
+            }
+
+            size_t frame_bytes = (size_t)channels * (bits / 8);
+            std::vector<uint8_t> data(size);
+            size = (uint32_t)fread(data.data(), 1, size, f);
+            size_t frames = size / frame_bytes;
+
+            wav->samples.resize(frames);
+            for (size_t ix = 0; ix < frames; ix++) {
+                const uint8_t *p = &data[ix * frame_bytes];
+                if (pcm16) {
+                    wav->samples[ix] = (int16_t)read_u16(p);
+                }
+                else {
+                    uint32_t u = read_u32(p);
+                    float v;
+                    memcpy(&v, &u, sizeof(v));
+                    // the device records int16, quantize the same way
+                    v = std::max(-1.0f, std::min(1.0f, v)) * 32767.0f;
+                    wav->samples[ix] = (int16_t)lrintf(v);
+                }
+            }
+            fclose(f);
+            return true;
+        }
+        else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fprintf(stderr, "ERR: %s has no usable audio\n", path);
+    fclose(f);
+    return false;
+}
+
+/**
+ * Wake up the idle workers
+ */
+static void signal_work() {
+    {
+        std::lock_guard<std::mutex> guard(work_lock);
+        work_epoch++;
+    }
+    work_ready.notify_all();
+}
+
+/**
+ * Load a file and queue its windows on the queue of the worker that loaded it
+ */
+static void load_file(size_t worker_ix, size_t file_ix) {
+    file_entry_t *file = &files[file_ix];
+
+    std::shared_ptr<wav_data_t> wav = std::make_shared<wav_data_t>();
+    if (!read_wav(file->path.c_str(), wav.get())) {
+        return;
+    }
+    if (wav->frequency != EI_CLASSIFIER_FREQUENCY) {
+        fprintf(stderr, "ERR: %s is sampled at %u Hz, the model expects %u Hz\n",
+            file->path.c_str(), (unsigned)wav->frequency, (unsigned)EI_CLASSIFIER_FREQUENCY);
+        return;
+    }
+
+    size_t window_count = 1;
+    if (wav->samples.size() > EI_CLASSIFIER_RAW_SAMPLE_COUNT) {
+        window_count = (wav->samples.size() - EI_CLASSIFIER_RAW_SAMPLE_COUNT) / hop + 1;
+    }
+    // results are written by whichever worker runs the window, each in its own slot
+    file->windows.resize(window_count);
+    file->loaded = true;
+
+    worker_queue_t *queue = queues[worker_ix].get();
+    size_t task_count = (window_count + batch_size - 1) / batch_size;
+    pending += task_count;
+    {
+        std::lock_guard<std::mutex> guard(queue->lock);
+        for (size_t ix = 0; ix < window_count; ix += batch_size) {
+            queue->tasks.push_back({ file_ix, ix, std::min(batch_size, window_count - ix), wav });
+        }
+    }
+    signal_work();
+}
+
+static void set_window_result(window_result_t *res, EI_IMPULSE_ERROR status, const ei_impulse_result_t &result) {
+    res->status = status;
+    res->predicted = -1;
+
+    float best = -1.0f;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        res->scores[ix] = result.classification[ix].value;
+        if (status == EI_IMPULSE_OK && res->scores[ix] > best) {
+            best = res->scores[ix];
+            res->predicted = (int)ix;
+        }
+    }
+}
+
+static void run_windows(const task_t &task) {
+    const wav_data_t *wav = task.wav.get();
+    std::vector<signal_t> signals(task.count);
+    std::vector<ei_impulse_result_t> results(task.count);
+
+    for (size_t w = 0; w < task.count; w++) {
+        size_t start = (task.window_ix + w) * hop;
+        files[task.file_ix].windows[task.window_ix + w].offset = start;
+
+        signals[w].total_length = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+        signals[w].get_data = [wav, start](size_t offset, size_t length, float *out_ptr) {
+            for (size_t ix = 0; ix < length; ix++) {
+                size_t sample_ix = start + offset + ix;
+                if (sample_ix >= wav->samples.size()) {
+                    out_ptr[ix] = 0.0f;
+                }
+                else if (scale_samples) {
+                    // same conversion as audio_signal_get_data() in src/main.cpp
+                    out_ptr[ix] = (float)wav->samples[sample_ix] / 32767.0f;
+                }
+                else {
+                    out_ptr[ix] = (float)wav->samples[sample_ix];
+                }
+            }
+            return 0;
+        };
+    }
+
+    EI_IMPULSE_ERROR status = run_classifier_batch(signals.data(), results.data(), task.count, false);
+    for (size_t w = 0; w < task.count; w++) {
+        window_result_t *res = &files[task.file_ix].windows[task.window_ix + w];
+        if (status == EI_IMPULSE_OK) {
+            set_window_result(res, status, results[w]);
+        }
+        else {
+            // the batch stops at the first failure, find out which windows failed
+            ei_impulse_result_t result = { 0 };
+            set_window_result(res, run_classifier(&signals[w], &result, false), result);
+        }
+    }
+}
+
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+/**
+ * Read an early exit head: channels and margin, then one bias per label and
+ * labels * channels weights (label-major), all whitespace separated
+ *
+ * @return true if successful
+ */
+static bool read_head(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "ERR: Cannot open %s\n", path);
+        return false;
+    }
+
+    unsigned channels = 0;
+    bool ok = fscanf(f, "%u %f", &channels, &head.margin) == 2 && channels > 0;
+    head_bias.resize(EI_CLASSIFIER_LABEL_COUNT);
+    head_weights.resize(EI_CLASSIFIER_LABEL_COUNT * channels);
+    for (size_t ix = 0; ok && ix < head_bias.size(); ix++) {
+        ok = fscanf(f, "%f", &head_bias[ix]) == 1;
+    }
+    for (size_t ix = 0; ok && ix < head_weights.size(); ix++) {
+        ok = fscanf(f, "%f", &head_weights[ix]) == 1;
+    }
+    fclose(f);
+
+    if (!ok) {
+        fprintf(stderr, "ERR: %s is not a head with %u labels\n", path, (unsigned)EI_CLASSIFIER_LABEL_COUNT);
+        return false;
+    }
+    head.channels = (uint16_t)channels;
+    head.weights = head_weights.data();
+    head.bias = head_bias.data();
+    return true;
+}
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
+/**
+ * Take from the back of the own queue, otherwise steal from the front of another one
+ */
+static bool next_task(size_t worker_ix, task_t *task) {
+    {
+        worker_queue_t *own = queues[worker_ix].get();
+        std::lock_guard<std::mutex> guard(own->lock);
+        if (!own->tasks.empty()) {
+            *task = std::move(own->tasks.back());
+            own->tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t ix = 1; ix < queues.size(); ix++) {
+        worker_queue_t *victim = queues[(worker_ix + ix) % queues.size()].get();
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if (!victim->tasks.empty()) {
+            *task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+static void worker(size_t worker_ix) {
+    task_t task;
+    while (pending > 0) {
+        uint64_t epoch;
+        {
+            std::lock_guard<std::mutex> guard(work_lock);
+            epoch = work_epoch;
+        }
+        if (!next_task(worker_ix, &task)) {
+            // a file is being loaded somewhere, wait for its windows (or the end)
+            std::unique_lock<std::mutex> lock(work_lock);
+            work_ready.wait(lock, [epoch]() { return work_epoch != epoch || pending == 0; });
+            continue;
+        }
+        if (!task.wav) {
+            load_file(worker_ix, task.file_ix);
+        }
+        else {
+            run_windows(task);
+        }
+        task.wav.reset();
+        if (--pending == 0) {
+            signal_work();
+        }
+    }
+}
+
+static void print_csv(FILE *out) {
+    fprintf(out, "file,offset,label,predicted");
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        fprintf(out, ",%s", ei_classifier_inferencing_categories[ix]);
+    }
+    fprintf(out, "\n");
+
+    for (const file_entry_t &file : files) {
+        for (const window_result_t &w : file.windows) {
+            fprintf(out, "\"%s\",%u,%s,%s", file.path.c_str(), (unsigned)w.offset,
+                file.label >= 0 ? ei_classifier_inferencing_categories[file.label] : "",
+                w.predicted >= 0 ? ei_classifier_inferencing_categories[w.predicted] : "");
+            for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+                fprintf(out, ",%.5f", w.scores[ix]);
+            }
+            fprintf(out, "\n");
+        }
+    }
+}
+
+static void print_json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', out);
+        }
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void print_jsonl(FILE *out) {
+    for (const file_entry_t &file : files) {
+        for (const window_result_t &w : file.windows) {
+            fprintf(out, "{\"file\":");
+            print_json_string(out, file.path.c_str());
+            fprintf(out, ",\"offset\":%u,\"status\":%d,\"label\":", (unsigned)w.offset, (int)w.status);
+            if (file.label >= 0) {
+                print_json_string(out, ei_classifier_inferencing_categories[file.label]);
+            }
+            else {
+                fprintf(out, "null");
+            }
+            fprintf(out, ",\"predicted\":");
+            if (w.predicted >= 0) {
+                print_json_string(out, ei_classifier_inferencing_categories[w.predicted]);
+            }
+            else {
+                fprintf(out, "null");
+            }
+            fprintf(out, ",\"scores\":{");
+            for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+                fprintf(out, "%s", ix > 0 ? "," : "");
+                print_json_string(out, ei_classifier_inferencing_categories[ix]);
+                fprintf(out, ":%.5f", w.scores[ix]);
+            }
+            fprintf(out, "}}\n");
+        }
+    }
+}
+
+/**
+ * Confusion matrix (rows: label, columns: prediction) with per-label precision and recall
+ */
+static void print_confusion() {
+    size_t confusion[EI_CLASSIFIER_LABEL_COUNT][EI_CLASSIFIER_LABEL_COUNT] = { { 0 } };
+    size_t labelled = 0, correct = 0;
+
+    for (const file_entry_t &file : files) {
+        if (file.label < 0) {
+            continue;
+        }
+        for (const window_result_t &w : file.windows) {
+            if (w.predicted < 0) {
+                continue;
+            }
+            confusion[file.label][w.predicted]++;
+            labelled++;
+            if (w.predicted == file.label) {
+                correct++;
+            }
+        }
+    }
+
+    if (labelled == 0) {
+        fprintf(stderr, "No labelled windows, skipping confusion matrix\n");
+        return;
+    }
+
+    fprintf(stderr, "\nConfusion matrix (rows: label, columns: predicted)\n%12s", "");
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        fprintf(stderr, " %10.10s", ei_classifier_inferencing_categories[ix]);
+    }
+    fprintf(stderr, " %10s %10s\n", "precision", "recall");
+
+    for (size_t row = 0; row < EI_CLASSIFIER_LABEL_COUNT; row++) {
+        size_t row_total = 0, col_total = 0;
+        fprintf(stderr, "%12.12s", ei_classifier_inferencing_categories[row]);
+        for (size_t col = 0; col < EI_CLASSIFIER_LABEL_COUNT; col++) {
+            fprintf(stderr, " %10u", (unsigned)confusion[row][col]);
+            row_total += confusion[row][col];
+            col_total += confusion[col][row];
+        }
+        float precision = col_total ? (float)confusion[row][row] / col_total : 0.0f;
+        float recall = row_total ? (float)confusion[row][row] / row_total : 0.0f;
+        fprintf(stderr, " %10.4f %10.4f\n", precision, recall);
+    }
+    fprintf(stderr, "Accuracy: %.4f (%u / %u windows)\n",
+        (float)correct / labelled, (unsigned)correct, (unsigned)labelled);
+}
+
+static std::string base_name(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+/**
+ * Compare the results with a CSV written by an earlier run (print_csv() format). Rows
+ * are matched by file name and offset, so the directory may be somewhere else.
+ *
+ * @return true if every window is in the CSV and no score differs by more than tolerance
+ */
+static bool check_scores(const char *path, float tolerance) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "ERR: Cannot open %s\n", path);
+        return false;
+    }
+
+    typedef struct {
+        std::string file;
+        unsigned offset;
+        float scores[EI_CLASSIFIER_LABEL_COUNT];
+    } golden_row_t;
+    std::vector<golden_row_t> golden;
+
+    char line[1024];
+    bool header = true;
+    while (fgets(line, sizeof(line), f)) {
+        if (header) {
+            header = false;
+            continue;
+        }
+        // "file",offset,label,predicted,score...
+        char *name_end = line[0] == '"' ? strchr(line + 1, '"') : NULL;
+        if (!name_end) {
+            continue;
+        }
+        golden_row_t row;
+        row.file = base_name(std::string(line + 1, name_end));
+        char *p = name_end + 2;
+        row.offset = (unsigned)strtoul(p, &p, 10);
+        // skip label and predicted
+        for (int field = 0; field < 2 && p; field++) {
+            p = strchr(p + 1, ',');
+        }
+        bool ok = p != NULL;
+        for (size_t ix = 0; ok && ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+            char *end;
+            row.scores[ix] = strtof(p + 1, &end);
+            ok = end != p + 1;
+            p = end;
+        }
+        if (ok) {
+            golden.push_back(row);
+        }
+    }
+    fclose(f);
+
+    size_t compared = 0, mismatches = 0;
+    float worst = 0.0f;
+    for (const file_entry_t &file : files) {
+        std::string name = base_name(file.path);
+        for (const window_result_t &w : file.windows) {
+            const golden_row_t *row = NULL;
+            for (const golden_row_t &g : golden) {
+                if (g.file == name && g.offset == (unsigned)w.offset) {
+                    row = &g;
+                    break;
+                }
+            }
+            if (!row) {
+                fprintf(stderr, "ERR: %s offset %u is not in %s\n", name.c_str(), (unsigned)w.offset, path);
+                mismatches++;
+                continue;
+            }
+            compared++;
+            for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+                float diff = fabsf(w.scores[ix] - row->scores[ix]);
+                worst = std::max(worst, diff);
+                if (diff > tolerance) {
+                    fprintf(stderr, "ERR: %s offset %u, %s: %.5f, expected %.5f\n", name.c_str(),
+                        (unsigned)w.offset, ei_classifier_inferencing_categories[ix], w.scores[ix], row->scores[ix]);
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    fprintf(stderr, "Check against %s: %u windows, largest difference %.5f (tolerance %.5f), %u mismatches\n",
+        path, (unsigned)compared, worst, tolerance, (unsigned)mismatches);
+    return mismatches == 0 && compared > 0;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+        "Usage: %s [options] <directory>\n"
+        "  --hop <samples>     distance between windows (default %u, no overlap)\n"
+        "  --threads <n>       worker threads (default: number of cores)\n"
+        "  --batch <n>         windows per run_classifier_batch() call (default 8)\n"
+        "  --format csv|jsonl  result format (default csv)\n"
+        "  --out <file>        write results to a file instead of stdout\n"
+        "  --raw               feed int16 sample values instead of scaling to [-1, 1]\n"
+        "  --check <csv>       compare the scores with a CSV of an earlier run, exit 1 on a mismatch\n"
+        "  --tolerance <t>     largest score difference --check accepts (default 0.0118, 3 / 256)\n"
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+        "  --early-exit <file> compare the full model with the model plus this early exit head\n"
+#endif
+        ,
+        name, (unsigned)EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+}
+
+/**
+ * Score all files once, the results end up in files[].windows
+ *
+ * @return wall time in seconds
+ */
+static double run_pass(size_t thread_count) {
+    queues.clear();
+    for (size_t ix = 0; ix < thread_count; ix++) {
+        queues.emplace_back(new worker_queue_t());
+    }
+    // files are dealt out round-robin, the windows they expand into get stolen
+    for (size_t ix = 0; ix < files.size(); ix++) {
+        files[ix].loaded = false;
+        files[ix].windows.clear();
+        queues[ix % thread_count]->tasks.push_back({ ix, 0, 0, nullptr });
+    }
+    pending = files.size();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t ix = 0; ix < thread_count; ix++) {
+        threads.emplace_back(worker, ix);
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+/**
+ * Score the corpus with the full model, then with the head attached, and compare
+ *
+ * @return wall time of the pass with the head, or a negative value on error
+ */
+static double run_early_exit(size_t thread_count) {
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+    // learning block 0 is the EON compiled model
+    if (inference_tflite_set_early_exit(impulse, 0, nullptr) != EI_IMPULSE_OK) {
+        fprintf(stderr, "ERR: The model does not support an early exit head\n");
+        return -1.0;
+    }
+    double full_seconds = run_pass(thread_count);
+
+    std::vector<std::vector<int>> full_predicted(files.size());
+    for (size_t ix = 0; ix < files.size(); ix++) {
+        for (const window_result_t &w : files[ix].windows) {
+            full_predicted[ix].push_back(w.predicted);
+        }
+    }
+
+    if (inference_tflite_set_early_exit(impulse, 0, &head) != EI_IMPULSE_OK) {
+        fprintf(stderr, "ERR: Early exit head does not fit the model\n");
+        return -1.0;
+    }
+    ei_tflite_early_exit_stats_t stats;
+    inference_tflite_early_exit_stats(impulse, 0, &stats, true);
+    double seconds = run_pass(thread_count);
+    inference_tflite_early_exit_stats(impulse, 0, &stats);
+    inference_tflite_set_early_exit(impulse, 0, nullptr);
+
+    size_t windows = 0, agree = 0, labelled = 0, full_correct = 0, exit_correct = 0;
+    for (size_t ix = 0; ix < files.size(); ix++) {
+        const file_entry_t &file = files[ix];
+        for (size_t w = 0; w < file.windows.size() && w < full_predicted[ix].size(); w++) {
+            int predicted = file.windows[w].predicted;
+            windows++;
+            agree += predicted == full_predicted[ix][w];
+            if (file.label >= 0) {
+                labelled++;
+                full_correct += full_predicted[ix][w] == file.label;
+                exit_correct += predicted == file.label;
+            }
+        }
+    }
+
+    fprintf(stderr, "Early exit: %u of %u invokes exited (%.1f%%), top-1 agrees with the full model on %.2f%% of %u windows\n",
+        (unsigned)stats.exits, (unsigned)stats.invokes, stats.invokes ? 100.0 * stats.exits / stats.invokes : 0.0,
+        windows ? 100.0 * agree / windows : 0.0, (unsigned)windows);
+    fprintf(stderr, "Full model %.1f windows/s, with early exit %.1f windows/s\n",
+        full_seconds > 0 ? windows / full_seconds : 0.0, seconds > 0 ? windows / seconds : 0.0);
+    if (labelled > 0) {
+        fprintf(stderr, "Accuracy: full model %.4f, with early exit %.4f (%u windows)\n",
+            (float)full_correct / labelled, (float)exit_correct / labelled, (unsigned)labelled);
+    }
+    return seconds;
+}
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
+int main(int argc, char **argv) {
+    size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    bool jsonl = false;
+    const char *out_path = NULL;
+    const char *dir = NULL;
+    const char *head_path = NULL;
+    const char *check_path = NULL;
+    float tolerance = 3.0f / 256.0f;
+
+    for (int ix = 1; ix < argc; ix++) {
+        bool has_value = ix + 1 < argc;
+        if (strcmp(argv[ix], "--hop") == 0 && has_value) {
+            hop = (size_t)strtoul(argv[++ix], NULL, 10);
+        }
+        else if (strcmp(argv[ix], "--threads") == 0 && has_value) {
+            thread_count = (size_t)strtoul(argv[++ix], NULL, 10);
+        }
+        else if (strcmp(argv[ix], "--batch") == 0 && has_value) {
+            batch_size = (size_t)strtoul(argv[++ix], NULL, 10);
+        }
+        else if (strcmp(argv[ix], "--check") == 0 && has_value) {
+            check_path = argv[++ix];
+        }
+        else if (strcmp(argv[ix], "--tolerance") == 0 && has_value) {
+            tolerance = strtof(argv[++ix], NULL);
+        }
+        else if (strcmp(argv[ix], "--format") == 0 && has_value) {
+            jsonl = strcmp(argv[++ix], "jsonl") == 0;
+        }
+        else if (strcmp(argv[ix], "--out") == 0 && has_value) {
+            out_path = argv[++ix];
+        }
+        else if (strcmp(argv[ix], "--raw") == 0) {
+            scale_samples = false;
+        }
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+        else if (strcmp(argv[ix], "--early-exit") == 0 && has_value) {
+            head_path = argv[++ix];
+        }
+#endif
+        else if (argv[ix][0] != '-' && !dir) {
+            dir = argv[ix];
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!dir || hop == 0 || thread_count == 0 || batch_size == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::string root(dir);
+    while (root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+    find_files(root, root.substr(root.find_last_of('/') + 1));
+    if (files.empty()) {
+        fprintf(stderr, "ERR: No WAV files found in %s\n", dir);
+        return 1;
+    }
+
+    double seconds = 0.0;
+    if (head_path) {
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+        if (!read_head(head_path)) {
+            return 1;
+        }
+        seconds = run_early_exit(thread_count);
+        if (seconds < 0) {
+            return 1;
+        }
+#endif
+    }
+    else {
+        seconds = run_pass(thread_count);
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "ERR: Cannot open %s for writing\n", out_path);
+            return 1;
+        }
+    }
+    if (jsonl) {
+        print_jsonl(out);
+    }
+    else {
+        print_csv(out);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    size_t window_count = 0, failed_files = 0, failed_windows = 0;
+    for (const file_entry_t &file : files) {
+        if (!file.loaded) {
+            failed_files++;
+        }
+        for (const window_result_t &w : file.windows) {
+            window_count++;
+            if (w.status != EI_IMPULSE_OK) {
+                failed_windows++;
+            }
+        }
+    }
+
+    fprintf(stderr, "Scored %u windows from %u files in %.2f s (%.1f windows/s, %u threads)\n",
+        (unsigned)window_count, (unsigned)(files.size() - failed_files), seconds,
+        seconds > 0 ? window_count / seconds : 0.0, (unsigned)thread_count);
+    if (failed_files || failed_windows) {
+        fprintf(stderr, "%u files could not be read, %u windows failed\n",
+            (unsigned)failed_files, (unsigned)failed_windows);
+    }
+    print_confusion();
+
+    if (check_path && !check_scores(check_path, tolerance)) {
+        return 1;
+    }
+
+    return failed_windows ? 1 : 0;
+}
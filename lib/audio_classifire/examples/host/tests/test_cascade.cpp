@@ -0,0 +1,169 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the cascade: a first stage score inside the accept band, for a label
+ * the first stage may answer, skips the full model and its scores come out of the
+ * postprocessing chain. Scores below the band, above it, or for another label fall
+ * through to the full model, which then gives the result of a run without cascade.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const size_t labels = EI_CLASSIFIER_LABEL_COUNT;
+static const size_t background = 0;
+
+// first stage that answers with the fixed scores in its config
+typedef struct {
+    float scores[labels];
+} fixed_gate_t;
+
+static int gate_calls = 0;
+
+static EI_IMPULSE_ERROR fixed_gate(const ei_impulse_t *impulse, const ei::matrix_t *features,
+                                   const void *config, float *scores)
+{
+    const fixed_gate_t *gate = (const fixed_gate_t *)config;
+    gate_calls++;
+    memcpy(scores, gate->scores, sizeof(gate->scores));
+    return EI_IMPULSE_OK;
+}
+
+static void set_top(fixed_gate_t *gate, size_t top, float score)
+{
+    for (size_t ix = 0; ix < labels; ix++) {
+        gate->scores[ix] = ix == top ? score : (1.0f - score) / (labels - 1);
+    }
+}
+
+static EI_IMPULSE_ERROR classify(signal_t *signal, ei_impulse_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    return run_classifier(signal, result);
+}
+
+static bool same_scores(const ei_impulse_result_t *a, const ei_impulse_result_t *b)
+{
+    for (size_t ix = 0; ix < labels; ix++) {
+        if (a->classification[ix].value != b->classification[ix].value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::vector<float> audio(EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+    for (size_t ix = 0; ix < audio.size(); ix++) {
+        audio[ix] = roundf(3000.0f * sinf(2.0f * (float)M_PI * 700.0f * ix / EI_CLASSIFIER_FREQUENCY));
+    }
+    signal_t signal;
+    CHECK(numpy::signal_from_buffer(audio.data(), audio.size(), &signal) == 0);
+
+    // the full model alone
+    ei_impulse_result_t full;
+    CHECK(classify(&signal, &full) == EI_IMPULSE_OK);
+
+    fixed_gate_t gate = { };
+    ei_cascade_t cascade;
+    ei_cascade_init(&cascade, fixed_gate, &gate, ei_default_impulse.impulse->learning_blocks[0].blockId,
+                    0.9f, 0.99f, 1u << background);
+    ei_default_impulse.cascade = &cascade;
+
+    // inside the band: the first stage answers, within the int8 quantization of the output
+    ei_impulse_result_t result;
+    set_top(&gate, background, 0.95f);
+    CHECK(classify(&signal, &result) == EI_IMPULSE_OK);
+    CHECK(gate_calls == 1);
+    CHECK(result.timing.cascade_skipped);
+    CHECK(fabsf(result.timing.cascade_score - 0.95f) < 1e-6f);
+    for (size_t ix = 0; ix < labels; ix++) {
+        CHECK(fabsf(result.classification[ix].value - gate.scores[ix]) <= 1.0f / 256.0f);
+    }
+
+    // below the band, above it, and a label the first stage may not answer: the full model runs
+    const struct {
+        size_t top;
+        float score;
+    } fall_through[] = {
+        { background, 0.85f },
+        { background, 0.995f },
+        { 3, 0.95f },
+    };
+    for (const auto &window : fall_through) {
+        set_top(&gate, window.top, window.score);
+        CHECK(classify(&signal, &result) == EI_IMPULSE_OK);
+        CHECK(!result.timing.cascade_skipped);
+        CHECK(fabsf(result.timing.cascade_score - window.score) < 1e-6f);
+        CHECK(same_scores(&result, &full));
+    }
+
+    CHECK(gate_calls == 4);
+    CHECK(cascade.windows == 4);
+    CHECK(cascade.skipped == 1);
+    CHECK(fabsf(ei_cascade_skip_rate(&cascade) - 0.25f) < 1e-6f);
+
+    // the band edges are inclusive
+    ei_cascade_reset_stats(&cascade);
+    set_top(&gate, background, 0.9f);
+    CHECK(classify(&signal, &result) == EI_IMPULSE_OK);
+    CHECK(result.timing.cascade_skipped);
+    cascade.accept_confidence_max = 1.0f;
+    set_top(&gate, background, 1.0f);
+    CHECK(classify(&signal, &result) == EI_IMPULSE_OK);
+    CHECK(result.timing.cascade_skipped);
+    CHECK(cascade.windows == 2 && cascade.skipped == 2);
+
+    // another learning block id: the first stage is not consulted
+    cascade.block_id = ei_default_impulse.impulse->learning_blocks[0].blockId + 1;
+    gate_calls = 0;
+    CHECK(classify(&signal, &result) == EI_IMPULSE_OK);
+    CHECK(gate_calls == 0);
+    CHECK(!result.timing.cascade_skipped);
+    CHECK(same_scores(&result, &full));
+
+    ei_default_impulse.cascade = nullptr;
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
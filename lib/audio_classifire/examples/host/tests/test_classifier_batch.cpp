@@ -0,0 +1,129 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of run_classifier_batch(): N windows in one batch give exactly the results
+ * of N run_classifier() calls, for a single window, a small batch, a full chunk of the
+ * EON batched path (32) and one window past it (33).
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const size_t window = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+static const size_t max_windows = 33;
+
+// a different chirp and level per window, so the windows classify differently
+static std::vector<float> make_audio(size_t windows)
+{
+    std::vector<float> audio(windows * window);
+    uint32_t seed = 1;
+    for (size_t w = 0; w < windows; w++) {
+        float start = 100.0f + 150.0f * w;
+        float gain = 500.0f + 800.0f * (w % 7);
+        for (size_t ix = 0; ix < window; ix++) {
+            float t = (float)ix / EI_CLASSIFIER_FREQUENCY;
+            seed = seed * 1664525u + 1013904223u;
+            float noise = ((seed >> 8) / 16777216.0f - 0.5f) * 100.0f;
+            audio[w * window + ix] = roundf(gain * sinf(2.0f * (float)M_PI * (start + 400.0f * t) * t) + noise);
+        }
+    }
+    return audio;
+}
+
+static bool same_result(const ei_impulse_result_t *a, const ei_impulse_result_t *b)
+{
+    if (a->quantized.count != b->quantized.count ||
+        a->quantized.dequantized != b->quantized.dequantized ||
+        memcmp(a->quantized.value, b->quantized.value, a->quantized.count * sizeof(a->quantized.value[0])) != 0) {
+        return false;
+    }
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (memcmp(&a->classification[ix].value, &b->classification[ix].value, sizeof(float)) != 0 ||
+            a->classification[ix].label != b->classification[ix].label) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::vector<float> audio = make_audio(max_windows);
+
+    std::vector<signal_t> signals(max_windows);
+    for (size_t w = 0; w < max_windows; w++) {
+        CHECK(numpy::signal_from_buffer(audio.data() + w * window, window, &signals[w]) == 0);
+    }
+
+    // one window at a time
+    std::vector<ei_impulse_result_t> single(max_windows);
+    for (size_t w = 0; w < max_windows; w++) {
+        memset(&single[w], 0, sizeof(single[w]));
+        CHECK(run_classifier(&signals[w], &single[w]) == EI_IMPULSE_OK);
+    }
+
+    // the windows differ, or the comparison below would prove little
+    bool differ = false;
+    for (size_t w = 1; w < max_windows; w++) {
+        differ |= !same_result(&single[0], &single[w]);
+    }
+    CHECK(differ);
+
+    // the batched EON path runs, not the loop over run_classifier()
+    CHECK(can_run_classifier_batch(ei_default_impulse.impulse));
+
+    const size_t batch_sizes[] = { 1, 5, 32, 33 };
+    for (size_t batch_size : batch_sizes) {
+        std::vector<ei_impulse_result_t> batch(batch_size);
+        memset(batch.data(), 0, batch_size * sizeof(ei_impulse_result_t));
+        CHECK(run_classifier_batch(signals.data(), batch.data(), batch_size) == EI_IMPULSE_OK);
+        for (size_t w = 0; w < batch_size; w++) {
+            if (!same_result(&single[w], &batch[w])) {
+                fprintf(stderr, "batch of %zu, window %zu differs\n", batch_size, w);
+                failures++;
+            }
+        }
+    }
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
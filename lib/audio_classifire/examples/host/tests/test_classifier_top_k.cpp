@@ -0,0 +1,135 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of top-k on int8 results: the ranking follows the quantized scores, and once
+ * a postprocessing block rewrote the float scores (smoothing with replace_scores) it
+ * follows the rewritten scores instead.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_top_k.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const uint32_t labels = EI_CLASSIFIER_LABEL_COUNT;
+
+// an int8 result as process_classification_i8 leaves it with lazy dequantization
+static void fill_quantized(ei_impulse_result_t *result, const int8_t *q)
+{
+    memset(result, 0, sizeof(*result));
+    result->quantized.zero_point = -128;
+    result->quantized.scale = 1.0f / 256.0f;
+    result->quantized.count = labels;
+    result->quantized.dequantized = false;
+    for (uint32_t ix = 0; ix < labels; ix++) {
+        result->quantized.value[ix] = q[ix];
+        result->classification[ix].label = ei_classifier_inferencing_categories[ix];
+    }
+}
+
+static uint32_t float_argmax(const ei_impulse_result_t *result)
+{
+    uint32_t best = 0;
+    for (uint32_t ix = 1; ix < labels; ix++) {
+        if (result->classification[ix].value > result->classification[best].value) {
+            best = ix;
+        }
+    }
+    return best;
+}
+
+int main()
+{
+    int8_t q_first[labels];
+    int8_t q_second[labels];
+    memset(q_first, -128, sizeof(q_first));
+    memset(q_second, -128, sizeof(q_second));
+    q_first[0] = 127;   // ~1.0
+    q_second[0] = -50;  // ~0.3
+    q_second[1] = 0;    // 0.5
+
+    ei_impulse_result_t result;
+    ei_classifier_top_t top[2];
+
+    // ranked on the quantized scores
+    fill_quantized(&result, q_second);
+    CHECK(ei_classifier_top_k(&result, top, 2, 0.0f) == 2);
+    CHECK(top[0].index == 1);
+    CHECK(top[1].index == 0);
+    CHECK(fabsf(ei_classifier_score(&result, 1) - 0.5f) < 1e-6f);
+
+    // smoothing over a window of 2 with replace_scores: label 0 wins after smoothing,
+    // label 1 on the raw scores of the second result
+    const ei_smoothing_config_t config = {
+        .mode = EI_SMOOTHING_WINDOW,
+        .alpha = 0.5f,
+        .window_size = 2,
+        .onset_threshold = 0.7f,
+        .release_threshold = 0.5f,
+        .suppression_ms = 0,
+        .label_suppression_ms = NULL,
+        .ignore_flags = 0,
+        .replace_scores = true
+    };
+    void *state = NULL;
+    CHECK(init_smoothing(&ei_default_impulse, &state, (void*)&config) == EI_IMPULSE_OK);
+
+    fill_quantized(&result, q_first);
+    CHECK(process_smoothing(&ei_default_impulse, 0, 0, &result, (void*)&config, state) == EI_IMPULSE_OK);
+    fill_quantized(&result, q_second);
+    CHECK(process_smoothing(&ei_default_impulse, 0, 0, &result, (void*)&config, state) == EI_IMPULSE_OK);
+
+    CHECK(result.quantized.count == 0);
+    CHECK(float_argmax(&result) == 0);
+    CHECK(ei_classifier_top_k(&result, top, 2, 0.0f) == 2);
+    CHECK(top[0].index == float_argmax(&result));
+    for (uint32_t ix = 0; ix < labels; ix++) {
+        CHECK(ei_classifier_score(&result, ix) == result.classification[ix].value);
+    }
+
+    // the threshold applies to the rewritten scores as well
+    const float top_score = result.classification[top[0].index].value;
+    CHECK(ei_classifier_top_k(&result, top, 2, top_score + 0.01f) == 0);
+    CHECK(ei_classifier_top_k(&result, top, 2, top_score) == 1);
+
+    deinit_smoothing(state, (void*)&config);
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,176 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of cmvnw(): the running sums match a naive reference that pads every
+ * column with numpy::pad_1d_symmetric and averages each window of win_size rows.
+ * Covers odd and even window sizes, windows longer than the matrix (so the padding
+ * reflects more than once), variance normalization and scaling.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "edge-impulse-sdk/dsp/speechpy/speechpy.hpp"
+
+using namespace ei;
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+// window ix covers padded rows ix up to ix + win_size - 1, the padding puts
+// (win_size - 1) / 2 rows before the matrix and the rest after it
+static void window_stats(const matrix_t *padded, size_t row, size_t col, uint16_t win_size,
+                         double *mean, double *std)
+{
+    double sum = 0.0;
+    for (size_t ix = 0; ix < win_size; ix++) {
+        sum += padded->buffer[(row + ix) * padded->cols + col];
+    }
+    *mean = sum / win_size;
+
+    double sum_sq = 0.0;
+    for (size_t ix = 0; ix < win_size; ix++) {
+        double d = padded->buffer[(row + ix) * padded->cols + col] - *mean;
+        sum_sq += d * d;
+    }
+    *std = sqrt(sum_sq / win_size);
+}
+
+static void pad(const matrix_t *input, matrix_t *padded, uint16_t win_size)
+{
+    uint16_t pad_before = (win_size - 1) / 2;
+    uint16_t pad_after = win_size - 1 - pad_before;
+    CHECK(numpy::pad_1d_symmetric((matrix_t *)input, padded, pad_before, pad_after) == EIDSP_OK);
+}
+
+static void reference_cmvnw(matrix_t *features, uint16_t win_size, bool variance_normalization, bool scale)
+{
+    matrix_t padded(features->rows + win_size - 1, features->cols);
+    double mean, std;
+
+    pad(features, &padded, win_size);
+    for (size_t row = 0; row < features->rows; row++) {
+        for (size_t col = 0; col < features->cols; col++) {
+            window_stats(&padded, row, col, win_size, &mean, &std);
+            features->buffer[row * features->cols + col] -= (float)mean;
+        }
+    }
+
+    if (variance_normalization) {
+        pad(features, &padded, win_size);
+        for (size_t row = 0; row < features->rows; row++) {
+            for (size_t col = 0; col < features->cols; col++) {
+                window_stats(&padded, row, col, win_size, &mean, &std);
+                features->buffer[row * features->cols + col] /= (float)std + 1e-10f;
+            }
+        }
+    }
+
+    if (scale) {
+        CHECK(numpy::normalize(features) == EIDSP_OK);
+    }
+}
+
+static float max_difference(const matrix_t *a, const matrix_t *b)
+{
+    float diff = 0.0f;
+    for (size_t ix = 0; ix < a->rows * a->cols; ix++) {
+        float scale = fmaxf(1.0f, fabsf(b->buffer[ix]));
+        diff = fmaxf(diff, fabsf(a->buffer[ix] - b->buffer[ix]) / scale);
+    }
+    return diff;
+}
+
+static void check_shape(uint16_t rows, uint16_t cols, uint16_t win_size)
+{
+    matrix_t input(rows, cols);
+    for (size_t ix = 0; ix < input.rows * input.cols; ix++) {
+        // MFE/MFCC like values: an offset per column and noise
+        input.buffer[ix] = (float)(ix % cols) * 0.5f - 3.0f + (float)(rand() % 2000) / 1000.0f;
+    }
+
+    for (int variance = 0; variance < 2; variance++) {
+        for (int scale = 0; scale < 2; scale++) {
+            matrix_t expected(rows, cols);
+            matrix_t actual(rows, cols);
+            memcpy(expected.buffer, input.buffer, rows * cols * sizeof(float));
+            memcpy(actual.buffer, input.buffer, rows * cols * sizeof(float));
+
+            reference_cmvnw(&expected, win_size, variance, scale);
+            CHECK(speechpy::processing::cmvnw(&actual, win_size, variance, scale) == EIDSP_OK);
+
+            float diff = max_difference(&actual, &expected);
+            if (diff > 1e-4f) {
+                fprintf(stderr, "%ux%u win_size %u variance %d scale %d: difference %g\n",
+                        rows, cols, win_size, variance, scale, diff);
+            }
+            CHECK(diff <= 1e-4f);
+        }
+    }
+}
+
+int main()
+{
+    srand(1);
+
+    // the sizes of the impulse and the default window
+    check_shape(99, 40, 301);
+    check_shape(99, 40, 3);
+    // even windows, the padding after the matrix is one row longer than before it
+    check_shape(99, 40, 4);
+    check_shape(50, 8, 100);
+    // windows longer than the matrix, reflected more than once
+    check_shape(5, 13, 12);
+    check_shape(5, 13, 301);
+    check_shape(1, 4, 6);
+    // a window of a single row
+    check_shape(10, 3, 1);
+
+    // an empty matrix is rejected, a window of 0 leaves the features as they are
+    matrix_t empty(0, 4);
+    CHECK(speechpy::processing::cmvnw(&empty, 3, false, false) != EIDSP_OK);
+    matrix_t features(2, 2);
+    features.buffer[0] = 1.0f;
+    features.buffer[3] = 4.0f;
+    CHECK(speechpy::processing::cmvnw(&features, 0, true, false) == EIDSP_OK);
+    CHECK(features.buffer[0] == 1.0f && features.buffer[3] == 4.0f);
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,295 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the runtime slice rate of continuous classification: a stream that
+ * goes from 4 to 8 to 2 slices per model window keeps the same rolled feature matrix
+ * and scores as a fresh stream fed the same slices, and the same frames as a fresh
+ * stream at the compiled rate away from the slice starts. The rate policy steps the
+ * rate as documented, and invalid rates are rejected without touching the stream.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const size_t window = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+
+// chirp in int16 units, so every window classifies differently
+static std::vector<float> make_audio(size_t samples)
+{
+    std::vector<float> audio(samples);
+    float phase = 0.0f;
+    for (size_t ix = 0; ix < samples; ix++) {
+        float freq = 200.0f + 3000.0f * ix / samples;
+        phase += 2.0f * (float)M_PI * freq / EI_CLASSIFIER_FREQUENCY;
+        audio[ix] = roundf(6000.0f * sinf(phase));
+    }
+    return audio;
+}
+
+static EI_IMPULSE_ERROR run_slice(ei_continuous_ctx_t *ctx, const float *samples, size_t len,
+                                  ei_impulse_result_t *result)
+{
+    signal_t signal;
+    CHECK(numpy::signal_from_buffer(samples, len, &signal) == 0);
+    return run_classifier_continuous(ctx, &signal, result);
+}
+
+static bool same_stream(const ei_continuous_ctx_t *a, const ei_impulse_result_t *result_a,
+                        const ei_continuous_ctx_t *b, const ei_impulse_result_t *result_b)
+{
+    if (a->features_written != b->features_written ||
+            memcmp(a->features_matrix->buffer, b->features_matrix->buffer,
+                   a->features_matrix->cols * sizeof(float)) != 0) {
+        return false;
+    }
+    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        if (result_a->classification[ix].value != result_b->classification[ix].value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool has_boundary(const std::vector<size_t> &boundaries, size_t from, size_t to)
+{
+    for (size_t boundary : boundaries) {
+        if (boundary >= from && boundary < to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * The preemphasis of a slice takes its first sample against the last one of the same
+ * slice, so the frames over a slice start may differ a little between streams that
+ * slice the audio differently. Every other frame of the rolled matrix must match.
+ */
+static bool same_features_off_boundaries(const ei_continuous_ctx_t *a, const std::vector<size_t> &a_starts,
+                                         const ei_continuous_ctx_t *b, const std::vector<size_t> &b_starts)
+{
+    const ei_dsp_config_mfe_t *config = (const ei_dsp_config_mfe_t *)ei_default_impulse.impulse->dsp_blocks[0].config;
+    const size_t cols = config->num_filters;
+    const size_t frame_length = (size_t)(EI_CLASSIFIER_FREQUENCY * config->frame_length);
+    const size_t frame_stride = (size_t)(EI_CLASSIFIER_FREQUENCY * config->frame_stride);
+    const size_t rows = a->features_matrix->cols / cols;
+    const size_t frames = a->features_written / cols;
+
+    if (a->features_written != b->features_written) {
+        return false;
+    }
+
+    for (size_t row = 0; row < rows; row++) {
+        // the matrix rolls with every slice, its last row is the last frame
+        if (frames + row < rows) {
+            continue;
+        }
+        size_t start = (frames + row - rows) * frame_stride;
+        bool boundary = has_boundary(a_starts, start, start + frame_length) ||
+            has_boundary(b_starts, start, start + frame_length);
+        for (size_t col = 0; col < cols; col++) {
+            float diff = fabsf(a->features_matrix->buffer[row * cols + col] -
+                               b->features_matrix->buffer[row * cols + col]);
+            if (boundary ? diff > 0.05f : diff != 0.0f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// the rate changes between slices, the window collected so far carries over
+static void check_rate_changes()
+{
+    // 3 slices at 4, 4 at 8 and 2 at 2: 2.25 windows, whole slices of the compiled rate
+    // after every step
+    const struct {
+        uint32_t rate;
+        int slices;
+    } steps[] = { { 4, 3 }, { 8, 4 }, { 2, 2 } };
+
+    std::vector<float> audio = make_audio(window * 9 / 4);
+
+    // the stream changing its rate, a fresh stream fed the same slices without changing
+    // the rate, and a fresh stream at the compiled rate
+    ei_continuous_ctx_t changing = {};
+    ei_continuous_ctx_t same_slices = {};
+    ei_continuous_ctx_t compiled = {};
+    CHECK(run_classifier_init(&changing, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(run_classifier_init(&same_slices, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(run_classifier_init(&compiled, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(run_classifier_get_slice_size(&compiled) == EI_CLASSIFIER_SLICE_SIZE);
+
+    ei_impulse_result_t result, same_result, compiled_result;
+    std::vector<size_t> changing_starts, compiled_starts;
+    size_t offset = 0;
+    size_t compiled_offset = 0;
+    for (const auto &step : steps) {
+        CHECK(run_classifier_set_slices_per_model_window(&changing, step.rate) == EI_IMPULSE_OK);
+        const size_t slice = run_classifier_get_slice_size(&changing);
+        CHECK(slice == window / step.rate);
+
+        for (int ix = 0; ix < step.slices; ix++) {
+            CHECK(run_slice(&changing, audio.data() + offset, slice, &result) == EI_IMPULSE_OK);
+            CHECK(result.continuous.slices_per_model_window == step.rate);
+            CHECK(result.continuous.next_slices_per_model_window == step.rate);
+            CHECK(run_slice(&same_slices, audio.data() + offset, slice, &same_result) == EI_IMPULSE_OK);
+            CHECK(same_stream(&changing, &result, &same_slices, &same_result));
+            changing_starts.push_back(offset);
+            offset += slice;
+        }
+
+        while (compiled_offset < offset) {
+            CHECK(run_slice(&compiled, audio.data() + compiled_offset, EI_CLASSIFIER_SLICE_SIZE,
+                            &compiled_result) == EI_IMPULSE_OK);
+            compiled_starts.push_back(compiled_offset);
+            compiled_offset += EI_CLASSIFIER_SLICE_SIZE;
+        }
+        CHECK(compiled_offset == offset);
+        CHECK(same_features_off_boundaries(&changing, changing_starts, &compiled, compiled_starts));
+    }
+    CHECK(offset == audio.size());
+    // the last steps ran on a full window, so the scores came from the model
+    CHECK(changing.features_written >= EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+
+    // 0 goes back to the compiled rate
+    CHECK(run_classifier_set_slices_per_model_window(&changing, 0) == EI_IMPULSE_OK);
+    CHECK(run_classifier_get_slice_size(&changing) == EI_CLASSIFIER_SLICE_SIZE);
+
+    run_classifier_deinit(&changing);
+    run_classifier_deinit(&same_slices);
+    run_classifier_deinit(&compiled);
+}
+
+// an active slice jumps to max_slices, hold_slices quiet slices halve the rate down to
+// min_slices, slices between the thresholds hold it
+static void check_rate_policy()
+{
+    const ei_continuous_rate_policy_t policy = { 2, 8, 1000.0f, 100.0f, 2 };
+    const struct {
+        float level;
+        uint32_t next;
+    } steps[] = {
+        { 5000.0f, 8 },     // active
+        { 10.0f, 8 },       // quiet, 1 of 2
+        { 10.0f, 4 },       // quiet, 2 of 2: halved
+        { 10.0f, 4 },
+        { 500.0f, 4 },      // between the thresholds, the quiet run starts over
+        { 10.0f, 4 },
+        { 10.0f, 2 },
+        { 10.0f, 2 },       // at min_slices
+        { 10.0f, 2 },
+        { 3000.0f, 8 },     // active again: straight to max_slices
+    };
+
+    ei_continuous_ctx_t ctx = {};
+    CHECK(run_classifier_init(&ctx, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(run_classifier_set_slices_per_model_window(&ctx, 16) == EI_IMPULSE_OK);
+    // the current rate is clamped into the policy
+    CHECK(run_classifier_set_rate_policy(&ctx, &policy) == EI_IMPULSE_OK);
+    CHECK(run_classifier_get_slice_size(&ctx) == window / 8);
+
+    uint32_t rate = 8;
+    for (const auto &step : steps) {
+        // a square wave has an RMS of its level
+        std::vector<float> slice(run_classifier_get_slice_size(&ctx));
+        for (size_t ix = 0; ix < slice.size(); ix++) {
+            slice[ix] = (ix / 8) % 2 ? step.level : -step.level;
+        }
+        ei_impulse_result_t result;
+        CHECK(run_slice(&ctx, slice.data(), slice.size(), &result) == EI_IMPULSE_OK);
+        CHECK(result.continuous.slices_per_model_window == rate);
+        CHECK(result.continuous.next_slices_per_model_window == step.next);
+        CHECK(fabsf(result.continuous.activity - step.level) < 1e-3f * step.level);
+        CHECK(run_classifier_get_slice_size(&ctx) == window / step.next);
+        rate = step.next;
+    }
+
+    // without a policy the stream stays where it is
+    CHECK(run_classifier_set_rate_policy(&ctx, nullptr) == EI_IMPULSE_OK);
+    std::vector<float> quiet(run_classifier_get_slice_size(&ctx), 0.0f);
+    for (int ix = 0; ix < 4; ix++) {
+        ei_impulse_result_t result;
+        CHECK(run_slice(&ctx, quiet.data(), quiet.size(), &result) == EI_IMPULSE_OK);
+        CHECK(result.continuous.next_slices_per_model_window == 8);
+        CHECK(result.continuous.activity == 0.0f);
+    }
+
+    run_classifier_deinit(&ctx);
+}
+
+// rates that do not divide the window or give slices shorter than a frame are rejected,
+// and the stream keeps its rate and policy
+static void check_invalid_rates()
+{
+    ei_continuous_ctx_t ctx = {};
+    CHECK(run_classifier_init(&ctx, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(run_classifier_set_slices_per_model_window(&ctx, 8) == EI_IMPULSE_OK);
+
+    // does not divide the window
+    CHECK(run_classifier_set_slices_per_model_window(&ctx, 7) == EI_IMPULSE_DSP_ERROR);
+    // divides it, but slices of 48 samples are shorter than a frame
+    CHECK(run_classifier_set_slices_per_model_window(&ctx, 1000) == EI_IMPULSE_DSP_ERROR);
+    CHECK(run_classifier_get_slice_size(&ctx) == window / 8);
+    CHECK(run_classifier_set_slices_per_model_window(nullptr, 4) == EI_IMPULSE_INFERENCE_ERROR);
+
+    const ei_continuous_rate_policy_t inverted = { 8, 2, 1000.0f, 100.0f, 2 };
+    const ei_continuous_rate_policy_t indivisible = { 2, 7, 1000.0f, 100.0f, 2 };
+    const ei_continuous_rate_policy_t too_fast = { 2, 1000, 1000.0f, 100.0f, 2 };
+    CHECK(run_classifier_set_rate_policy(&ctx, &inverted) == EI_IMPULSE_DSP_ERROR);
+    CHECK(run_classifier_set_rate_policy(&ctx, &indivisible) == EI_IMPULSE_DSP_ERROR);
+    CHECK(run_classifier_set_rate_policy(&ctx, &too_fast) == EI_IMPULSE_DSP_ERROR);
+    CHECK(ctx.rate_policy == nullptr);
+    CHECK(run_classifier_get_slice_size(&ctx) == window / 8);
+
+    run_classifier_deinit(&ctx);
+}
+
+int main()
+{
+    check_rate_changes();
+    check_rate_policy();
+    check_invalid_rates();
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
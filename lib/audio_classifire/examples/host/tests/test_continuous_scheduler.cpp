@@ -0,0 +1,217 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the continuous scheduler (classifier/ei_continuous_scheduler.h): every
+ * overload policy against its counters, buffer overrun, and a producer that keeps
+ * pushing faster than the DSP runs while ei_scheduler_run() works through a backlog.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/classifier/ei_continuous_scheduler.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const uint32_t slice = EI_CLASSIFIER_SLICE_SIZE;
+// five slices, one sample of the buffer always stays unused
+static const uint32_t capacity = 5 * EI_CLASSIFIER_SLICE_SIZE + 1;
+
+struct Stream {
+    ei_continuous_ctx_t ctx;
+    std::vector<int16_t> buffer;
+    ei_continuous_scheduler_t sched;
+
+    explicit Stream(ei_scheduler_overload_policy_t policy) : ctx(), buffer(capacity, 0) {
+        CHECK(run_classifier_init(&ctx, &ei_default_impulse) == EI_IMPULSE_OK);
+        CHECK(ei_scheduler_init(&sched, &ctx, buffer.data(), capacity, policy) == EI_IMPULSE_OK);
+    }
+    ~Stream() {
+        run_classifier_deinit(&ctx);
+    }
+};
+
+static void push_slices(ei_continuous_scheduler_t *sched, uint32_t slices)
+{
+    std::vector<int16_t> samples(slices * slice);
+    for (size_t ix = 0; ix < samples.size(); ix++) {
+        samples[ix] = (int16_t)((ix * 37) % 2000 - 1000);
+    }
+    ei_scheduler_push(sched, samples.data(), samples.size());
+}
+
+static void run(ei_continuous_scheduler_t *sched, bool *classified)
+{
+    ei_impulse_result_t result;
+    memset(&result, 0, sizeof(result));
+    CHECK(ei_scheduler_run(sched, &result, classified) == EI_IMPULSE_OK);
+}
+
+static void test_skip_inference()
+{
+    Stream s(EI_SCHEDULER_SKIP_INFERENCE);
+    ei_scheduler_stats_t stats;
+    bool classified;
+
+    // less than a slice does nothing
+    std::vector<int16_t> few(slice / 2);
+    ei_scheduler_push(&s.sched, few.data(), few.size());
+    run(&s.sched, &classified);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(!classified);
+    CHECK(stats.runs == 0);
+    s.sched.read_ix.store(s.sched.write_ix.load());
+
+    // three slices: two only through the DSP, the window is not full yet
+    push_slices(&s.sched, 3);
+    run(&s.sched, &classified);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(!classified);
+    CHECK(stats.runs == 1);
+    CHECK(stats.slices == 3);
+    CHECK(stats.skipped_inferences == 2);
+    CHECK(stats.inferences == 0);
+    CHECK(stats.max_backlog_samples == 3 * slice);
+    CHECK(ei_scheduler_pending(&s.sched) == 0);
+
+    // the fourth slice fills the window
+    push_slices(&s.sched, 1);
+    run(&s.sched, &classified);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(classified);
+    CHECK(stats.runs == 2);
+    CHECK(stats.slices == 4);
+    CHECK(stats.inferences == 1);
+    CHECK(stats.dropped_samples == 0);
+    CHECK(stats.coalesced_slices == 0);
+}
+
+static void test_coalesce()
+{
+    Stream s(EI_SCHEDULER_COALESCE);
+    ei_scheduler_stats_t stats;
+    bool classified;
+
+    // at most slices per window - 1 slices go through the DSP together
+    push_slices(&s.sched, 4);
+    run(&s.sched, &classified);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    const uint32_t max_slices = EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW - 1;
+    CHECK(stats.runs == 1);
+    CHECK(stats.coalesced_slices == max_slices);
+    CHECK(stats.slices == max_slices);
+    CHECK(stats.skipped_inferences == 0);
+    CHECK(ei_scheduler_pending(&s.sched) == (4 - max_slices) * slice);
+
+    run(&s.sched, &classified);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(classified);
+    CHECK(stats.inferences == 1);
+    CHECK(ei_scheduler_pending(&s.sched) == 0);
+}
+
+static void test_drop()
+{
+    Stream s(EI_SCHEDULER_DROP);
+    ei_scheduler_stats_t stats;
+    bool classified;
+
+    push_slices(&s.sched, 4);
+    run(&s.sched, &classified);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(stats.runs == 1);
+    CHECK(stats.slices == 1);
+    CHECK(stats.dropped_samples == 3 * slice);
+    CHECK(stats.skipped_inferences == 0);
+    CHECK(ei_scheduler_pending(&s.sched) == 0);
+}
+
+static void test_overrun()
+{
+    Stream s(EI_SCHEDULER_SKIP_INFERENCE);
+    ei_scheduler_stats_t stats;
+
+    push_slices(&s.sched, 6);
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(ei_scheduler_pending(&s.sched) == capacity - 1);
+    CHECK(stats.overrun_samples == 6 * slice - (capacity - 1));
+}
+
+// Called by the SDK after the DSP of every slice. While set, a new slice "arrives" during
+// every DSP pass, i.e. the DSP alone is slower than real time.
+static ei_continuous_scheduler_t *refill_sched = nullptr;
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled()
+{
+    if (refill_sched) {
+        push_slices(refill_sched, 1);
+    }
+    return EI_IMPULSE_OK;
+}
+
+static void test_sustained_overload()
+{
+    Stream s(EI_SCHEDULER_SKIP_INFERENCE);
+    ei_scheduler_stats_t stats;
+    bool classified;
+
+    push_slices(&s.sched, 3);
+
+    refill_sched = &s.sched;
+    run(&s.sched, &classified);
+    refill_sched = nullptr;
+
+    // it returned after the three slices waiting on entry, the last one classified
+    ei_scheduler_get_stats(&s.sched, &stats);
+    CHECK(stats.runs == 1);
+    CHECK(stats.slices == 3);
+    CHECK(stats.skipped_inferences == 2);
+    CHECK(ei_scheduler_pending(&s.sched) == 3 * slice);
+}
+
+int main()
+{
+    test_skip_inference();
+    test_coalesce();
+    test_drop();
+    test_overrun();
+    test_sustained_overload();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the real FFT in dsp_engines/ei_esp_dsp.h: for every power of two from
+ * MIN_FFT_SIZE to MAX_FFT_SIZE the spectrum is the one kiss_fftr gives, bit for bit.
+ * Built without FFT info the plans are the ones built at runtime. Built with
+ * EI_CLASSIFIER_HAS_FFT_INFO the plans are the constexpr tables of the sizes with
+ * EI_CLASSIFIER_LOAD_FFT_<n>, and the other sizes return EIDSP_FFT_TABLE_NOT_LOADED.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/dsp/dsp_engines/ei_esp_dsp.h"
+#include "edge-impulse-sdk/dsp/kissfft/kiss_fftr.h"
+
+using namespace ei;
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+#if EI_CLASSIFIER_HAS_FFT_INFO == 1 && !defined(EI_CLASSIFIER_LOAD_ALL_FFTS)
+static bool table_loaded(size_t n_fft)
+{
+    switch (n_fft) {
+#if EI_CLASSIFIER_LOAD_FFT_32 == 1
+        case 32: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_64 == 1
+        case 64: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_128 == 1
+        case 128: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_256 == 1
+        case 256: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_512 == 1
+        case 512: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_1024 == 1
+        case 1024: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_2048 == 1
+        case 2048: return true;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_4096 == 1
+        case 4096: return true;
+#endif
+        default: return false;
+    }
+}
+#else
+static bool table_loaded(size_t n_fft)
+{
+    (void)n_fft;
+    return true;
+}
+#endif
+
+// the bins that differ between hw_r2c_fft and kiss_fftr, -1 if kiss_fftr failed
+static int compare_with_kissfft(const float *input, size_t n_fft)
+{
+    std::vector<fft_complex_t> expected(n_fft / 2 + 1);
+    std::vector<fft_complex_t> actual(n_fft / 2 + 1);
+
+    kiss_fftr_cfg cfg = kiss_fftr_alloc((int)n_fft, 0, NULL, NULL);
+    if (!cfg) {
+        return -1;
+    }
+    kiss_fftr(cfg, input, (kiss_fft_cpx *)expected.data());
+    ei_free(cfg);
+
+    if (fft::hw_r2c_fft(input, actual.data(), n_fft) != EIDSP_OK) {
+        return -1;
+    }
+
+    int differ = 0;
+    for (size_t ix = 0; ix < expected.size(); ix++) {
+        if (memcmp(&expected[ix], &actual[ix], sizeof(fft_complex_t)) != 0) {
+            differ++;
+        }
+    }
+    return differ;
+}
+
+int main()
+{
+    // a tone, a second tone, a DC offset and some deterministic noise
+    std::vector<float> input(fft::MAX_FFT_SIZE);
+    uint32_t seed = 12345;
+    for (size_t ix = 0; ix < input.size(); ix++) {
+        seed = seed * 1103515245u + 12345u;
+        input[ix] = 0.6f * sinf(0.05f * ix) + 0.25f * cosf(1.3f * ix) + 0.1f +
+            ((float)(seed >> 8) / (float)(1u << 24) - 0.5f) * 0.2f;
+    }
+
+    std::vector<fft_complex_t> out(fft::MAX_FFT_SIZE + 1);
+    size_t loaded = 0;
+
+    for (size_t n_fft = fft::MIN_FFT_SIZE; n_fft <= (size_t)fft::MAX_FFT_SIZE; n_fft *= 2) {
+        if (!table_loaded(n_fft)) {
+            CHECK(fft::hw_r2c_fft(input.data(), out.data(), n_fft) == EIDSP_FFT_TABLE_NOT_LOADED);
+            continue;
+        }
+        loaded++;
+        int differ = compare_with_kissfft(input.data(), n_fft);
+        if (differ != 0) {
+            fprintf(stderr, "n_fft %u: %d bins differ from kiss_fftr\n", (unsigned)n_fft, differ);
+        }
+        CHECK(differ == 0);
+    }
+
+    CHECK(loaded > 0);
+
+    // sizes the engine does not do
+    CHECK(fft::hw_r2c_fft(input.data(), out.data(), 16) == EIDSP_FFT_SIZE_NOT_SUPPORTED);
+    CHECK(fft::hw_r2c_fft(input.data(), out.data(), 384) == EIDSP_FFT_SIZE_NOT_SUPPORTED);
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
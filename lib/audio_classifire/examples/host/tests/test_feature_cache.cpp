@@ -0,0 +1,225 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the feature cache: a block hits over the same window and misses on
+ * the next one, a third block evicts the oldest entry, changed settings give a new
+ * key, a key that collides with another block still misses, and equal settings of
+ * another impulse are shared. Built with EI_CLASSIFIER_TFLITE_REENTRANT, so the
+ * cache is also hammered from several threads.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_feature_cache.h"
+
+using namespace ei;
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const size_t rows = 4;
+static const size_t cols = 10;
+
+static EI_CLASSIFIER_DSP_AXES_INDEX_TYPE axes[] = { 0 };
+
+static ei_dsp_config_mfe_t mfe_config(int num_filters)
+{
+    ei_dsp_config_mfe_t config = { };
+    config.implementation_version = 4;
+    config.axes = 1;
+    config.frame_length = 0.02f;
+    config.frame_stride = 0.01f;
+    config.num_filters = num_filters;
+    config.fft_length = 256;
+    config.low_frequency = 0;
+    config.high_frequency = 0;
+    config.win_size = 101;
+    config.noise_floor_db = -52;
+    return config;
+}
+
+static ei_model_dsp_t mfe_block(ei_dsp_config_mfe_t *config)
+{
+    ei_model_dsp_t block = { };
+    block.n_output_features = rows * cols;
+    block.extract_fn = &extract_mfe_features;
+    block.config = config;
+    block.axes = axes;
+    block.axes_size = 1;
+    return block;
+}
+
+static void fill(matrix_t *matrix, float value)
+{
+    for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
+        matrix->buffer[ix] = value + ix;
+    }
+}
+
+static bool holds(const matrix_t *matrix, float value)
+{
+    for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
+        if (matrix->buffer[ix] != value + ix) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    ei_impulse_t impulse = { };
+    impulse.frequency = 16000;
+    impulse.raw_samples_per_frame = 1;
+
+    ei_dsp_config_mfe_t config_a = mfe_config(40);
+    ei_dsp_config_mfe_t config_b = mfe_config(32);
+    ei_dsp_config_mfe_t config_c = mfe_config(20);
+    ei_dsp_config_mfe_t config_a_copy = mfe_config(40);
+    ei_model_dsp_t block_a = mfe_block(&config_a);
+    ei_model_dsp_t block_b = mfe_block(&config_b);
+    ei_model_dsp_t block_c = mfe_block(&config_c);
+    ei_model_dsp_t block_a_copy = mfe_block(&config_a_copy);
+
+    uint64_t key_a = ei_feature_cache_key(&impulse, &block_a);
+    uint64_t key_b = ei_feature_cache_key(&impulse, &block_b);
+    uint64_t key_c = ei_feature_cache_key(&impulse, &block_c);
+    CHECK(key_a != 0 && key_b != 0 && key_c != 0);
+    CHECK(key_a != key_b && key_a != key_c && key_b != key_c);
+    CHECK(ei_feature_cache_key(&impulse, &block_a_copy) == key_a);
+
+    ei_feature_cache_t cache;
+    ei_feature_cache_init(&cache);
+    matrix_t out(rows, cols);
+    matrix_t features(rows, cols);
+
+    // no window set, nothing is cached
+    fill(&features, 1);
+    ei_feature_cache_store(&cache, key_a, &impulse, &block_a, &features);
+    CHECK(!ei_feature_cache_find(&cache, key_a, &impulse, &block_a, &out));
+
+    // hit over the same window
+    ei_feature_cache_set_window(&cache, 1);
+    CHECK(!ei_feature_cache_find(&cache, key_a, &impulse, &block_a, &out));
+    ei_feature_cache_store(&cache, key_a, &impulse, &block_a, &features);
+    CHECK(ei_feature_cache_find(&cache, key_a, &impulse, &block_a, &out));
+    CHECK(holds(&out, 1));
+
+    // the same settings in another impulse share the features
+    fill(&out, 0);
+    CHECK(ei_feature_cache_find(&cache, key_a, &impulse, &block_a_copy, &out));
+    CHECK(holds(&out, 1));
+
+    // other settings miss
+    CHECK(!ei_feature_cache_find(&cache, key_b, &impulse, &block_b, &out));
+
+    // a colliding key with other settings, or another sampling frequency, misses
+    CHECK(!ei_feature_cache_find(&cache, key_a, &impulse, &block_b, &out));
+    ei_impulse_t other_impulse = impulse;
+    other_impulse.frequency = 8000;
+    CHECK(!ei_feature_cache_find(&cache, key_a, &other_impulse, &block_a, &out));
+
+    // the next window misses
+    ei_feature_cache_set_window(&cache, 2);
+    CHECK(!ei_feature_cache_find(&cache, key_a, &impulse, &block_a, &out));
+
+    // two entries: the third block evicts the oldest one
+    fill(&features, 100);
+    ei_feature_cache_store(&cache, key_a, &impulse, &block_a, &features);
+    fill(&features, 200);
+    ei_feature_cache_store(&cache, key_b, &impulse, &block_b, &features);
+    CHECK(ei_feature_cache_find(&cache, key_a, &impulse, &block_a, &out));
+    CHECK(holds(&out, 100));
+    CHECK(ei_feature_cache_find(&cache, key_b, &impulse, &block_b, &out));
+    CHECK(holds(&out, 200));
+    fill(&features, 300);
+    ei_feature_cache_store(&cache, key_c, &impulse, &block_c, &features);
+    CHECK(ei_feature_cache_find(&cache, key_c, &impulse, &block_c, &out));
+    CHECK(holds(&out, 300));
+#if EI_CLASSIFIER_FEATURE_CACHE_ENTRIES == 2
+    CHECK(!ei_feature_cache_find(&cache, key_a, &impulse, &block_a, &out));
+    CHECK(ei_feature_cache_find(&cache, key_b, &impulse, &block_b, &out));
+#endif
+
+    // changed settings give a new key and miss
+    config_c.noise_floor_db = -72;
+    uint64_t key_c_changed = ei_feature_cache_key(&impulse, &block_c);
+    CHECK(key_c_changed != key_c);
+    CHECK(!ei_feature_cache_find(&cache, key_c_changed, &impulse, &block_c, &out));
+    config_c.noise_floor_db = -52;
+
+    // handles on several threads, every hit has to be a whole matrix of its block
+    const int threads_count = 4;
+    int bad_hits[threads_count] = { };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; t++) {
+        threads.emplace_back([&, t]() {
+            matrix_t own(rows, cols);
+            matrix_t read(rows, cols);
+            ei_model_dsp_t *block = (t % 2) ? &block_b : &block_a;
+            uint64_t key = (t % 2) ? key_b : key_a;
+            float value = (t % 2) ? 2000 : 1000;
+            fill(&own, value);
+            for (int ix = 0; ix < 2000; ix++) {
+                if (t == 0 && ix % 100 == 0) {
+                    ei_feature_cache_set_window(&cache, 10 + ix);
+                }
+                if (ei_feature_cache_find(&cache, key, &impulse, block, &read)) {
+                    if (!holds(&read, value)) {
+                        bad_hits[t]++;
+                    }
+                }
+                else {
+                    ei_feature_cache_store(&cache, key, &impulse, block, &own);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < threads_count; t++) {
+        CHECK(bad_hits[t] == 0);
+    }
+    CHECK(cache.hits > 0);
+
+    ei_feature_cache_free(&cache);
+
+    if (failures) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
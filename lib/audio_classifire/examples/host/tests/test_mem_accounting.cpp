@@ -0,0 +1,144 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the memory accounting: stage peaks and counts, nested stages, and two
+ * threads measuring stages at the same time without seeing each other's allocations.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <thread>
+
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+// what ei_malloc / ei_free do with accounting on
+static void *tracked_malloc(size_t size)
+{
+    return ei_mem_accounting_track(malloc(size + EI_MEM_ACCOUNTING_HEADER_BYTES), size);
+}
+
+static void tracked_free(void *ptr)
+{
+    free(ei_mem_accounting_untrack(ptr));
+}
+
+static void test_nested_stages(void)
+{
+    ei_mem_stage_stats_t outer_stats = { 0 };
+    ei_mem_stage_stats_t inner_stats = { 0 };
+
+    void *before = tracked_malloc(100);
+    {
+        EI_MEM_STAGE(&outer_stats);
+        void *a = tracked_malloc(1000);
+        {
+            EI_MEM_STAGE(&inner_stats);
+            void *b = tracked_malloc(500);
+            tracked_free(b);
+        }
+        tracked_free(a);
+    }
+    tracked_free(before);
+
+    CHECK(inner_stats.stage_peak_bytes == 500);
+    CHECK(inner_stats.peak_bytes == 1600);
+    CHECK(inner_stats.alloc_count == 1);
+    CHECK(outer_stats.stage_peak_bytes == 1500);
+    CHECK(outer_stats.peak_bytes == 1600);
+    CHECK(outer_stats.alloc_count == 2);
+
+    ei_mem_accounting_stats_t totals;
+    ei_mem_accounting_get_stats(&totals);
+    CHECK(totals.in_use_bytes == 0);
+    CHECK(totals.alloc_count == totals.free_count);
+}
+
+static void test_parallel_stages(void)
+{
+    std::atomic<int> allocated(0);
+    ei_mem_stage_stats_t stats[2] = { { 0 }, { 0 } };
+    void *handed_over = NULL;
+
+    auto worker = [&](int ix, size_t size) {
+        {
+            EI_MEM_STAGE(&stats[ix]);
+            void *p = tracked_malloc(size);
+            // both blocks are live at the same time
+            allocated++;
+            while (allocated.load() < 2) {
+                std::this_thread::yield();
+            }
+            if (ix == 0) {
+                handed_over = tracked_malloc(64);
+            }
+            tracked_free(p);
+        }
+    };
+
+    std::thread t0(worker, 0, 3000);
+    std::thread t1(worker, 1, 5000);
+    t0.join();
+    t1.join();
+
+    CHECK(stats[0].stage_peak_bytes == 3064);
+    CHECK(stats[0].alloc_count == 2);
+    CHECK(stats[1].stage_peak_bytes == 5000);
+    CHECK(stats[1].alloc_count == 1);
+    // the heap peak is shared, whichever thread allocated last saw both blocks
+    CHECK(stats[0].peak_bytes >= 8000 || stats[1].peak_bytes >= 8000);
+
+    // freed by another thread than the one that allocated it
+    ei_mem_stage_stats_t main_stats = { 0 };
+    {
+        EI_MEM_STAGE(&main_stats);
+        tracked_free(handed_over);
+        void *p = tracked_malloc(10);
+        tracked_free(p);
+    }
+    CHECK(main_stats.stage_peak_bytes == 10);
+}
+
+int main()
+{
+    test_nested_stages();
+    test_parallel_stages();
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,180 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the pool allocator behind ei_malloc: size classes, arena rewind, reuse
+ * of holes, the stats and a custom region. Built twice, with the built-in region and
+ * with EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "edge-impulse-sdk/porting/ei_mem_pool.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+// the pool only needs ei_printf from the porting layer
+void ei_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+static uint8_t custom_region[EI_CLASSIFIER_ALLOCATOR_POOL_SIZE + 8] __attribute__((aligned(16)));
+
+static ei_mem_pool_stats_t stats(void)
+{
+    ei_mem_pool_stats_t s;
+    ei_mem_pool_get_stats(&s);
+    return s;
+}
+
+static void test_size_classes(void)
+{
+    void *a = ei_mem_pool_malloc(10);
+    void *b = ei_mem_pool_malloc(300);
+    CHECK(a != NULL && b != NULL);
+    CHECK(((uintptr_t)a % 16) == 0 && ((uintptr_t)b % 16) == 0);
+    CHECK(stats().class_in_use[0] == 1);
+    CHECK(stats().class_in_use[5] == 1);
+    CHECK(stats().live_bytes == 16 + 512);
+    CHECK(stats().arena_used_bytes == 0);
+
+    CHECK(ei_mem_pool_free(a));
+    CHECK(stats().class_in_use[0] == 0);
+    CHECK(stats().class_peak[0] == 1);
+    CHECK(ei_mem_pool_malloc(16) == a);     // straight from the free list
+
+    CHECK(ei_mem_pool_free(a));
+    CHECK(ei_mem_pool_free(b));
+    CHECK(stats().live_bytes == 0);
+}
+
+static void test_arena(void)
+{
+    const size_t header = 16;
+
+    // rewind
+    void *a = ei_mem_pool_malloc(1000);
+    void *b = ei_mem_pool_malloc(1000);
+    void *c = ei_mem_pool_malloc(1000);
+    CHECK(a && b && c);
+    CHECK(stats().arena_used_bytes == 3 * (header + 1008));
+    CHECK(ei_mem_pool_free(c));
+    CHECK(stats().arena_used_bytes == 2 * (header + 1008));
+    c = ei_mem_pool_malloc(1000);
+
+    // a hole is reused first fit, the rest of it stays a hole
+    CHECK(ei_mem_pool_free(b));
+    CHECK(stats().arena_hole_bytes == 1008);
+    void *d = ei_mem_pool_malloc(700);
+    CHECK(d == b);
+    CHECK(stats().arena_used_bytes == 3 * (header + 1008));
+    CHECK(stats().arena_hole_bytes == 1008 - 704 - header);
+
+    // freed neighbours merge into one hole
+    CHECK(ei_mem_pool_free(d));
+    CHECK(stats().arena_hole_bytes == 1008);
+    CHECK(ei_mem_pool_free(a));
+    CHECK(stats().arena_hole_bytes == 2 * 1008 + header);
+
+    // with the top of the arena full, the hole is the largest free block
+    void *fill = ei_mem_pool_malloc(stats().largest_free_block);
+    CHECK(fill != NULL);
+    CHECK(stats().arena_used_bytes == stats().arena_bytes);
+    CHECK(stats().largest_free_block == 2 * 1008 + header);
+    CHECK(ei_mem_pool_malloc(2 * 1008 + header + 1) == NULL);
+    void *e = ei_mem_pool_malloc(2 * 1008 + header);
+    CHECK(e == a);
+    CHECK(stats().arena_hole_bytes == 0);
+
+    // freeing top down leaves the arena empty
+    CHECK(ei_mem_pool_free(fill));
+    CHECK(ei_mem_pool_free(c));
+    CHECK(ei_mem_pool_free(e));
+    CHECK(stats().arena_used_bytes == 0);
+    CHECK(stats().arena_hole_bytes == 0);
+    CHECK(stats().live_bytes == 0);
+    CHECK(stats().largest_free_block == stats().arena_bytes - header);
+
+    // the peaks stay until reset
+    CHECK(stats().arena_peak_bytes == stats().arena_bytes);
+    ei_mem_pool_reset_peaks();
+    CHECK(stats().arena_peak_bytes == 0);
+    CHECK(stats().peak_live_bytes == 0);
+}
+
+static void test_foreign_pointers(void)
+{
+    int on_stack;
+    CHECK(!ei_mem_pool_free(&on_stack));
+    CHECK(!ei_mem_pool_free(NULL));
+}
+
+int main()
+{
+#if EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL
+    // no region until the application passes one
+    CHECK(ei_mem_pool_malloc(16) == NULL);
+    CHECK(stats().region_bytes == 0);
+    test_foreign_pointers();
+    CHECK(ei_mem_pool_init(custom_region, sizeof(custom_region)) == EI_IMPULSE_OK);
+    CHECK(stats().region_bytes == EI_CLASSIFIER_ALLOCATOR_POOL_SIZE);
+#else
+    CHECK(stats().region_bytes == EI_CLASSIFIER_ALLOCATOR_POOL_SIZE);
+#endif
+
+    test_size_classes();
+    test_arena();
+    test_foreign_pointers();
+
+    // switching regions is refused while anything is allocated
+    void *live = ei_mem_pool_malloc(64);
+    CHECK(ei_mem_pool_init(custom_region + 8, EI_CLASSIFIER_ALLOCATOR_POOL_SIZE) == EI_IMPULSE_ALLOC_FAILED);
+    CHECK(ei_mem_pool_free(live));
+    CHECK(ei_mem_pool_init(custom_region + 8, EI_CLASSIFIER_ALLOCATOR_POOL_SIZE) == EI_IMPULSE_OK);
+    void *p = ei_mem_pool_malloc(4000);
+    CHECK((uint8_t *)p > custom_region && (uint8_t *)p < custom_region + sizeof(custom_region));
+    CHECK(ei_mem_pool_free(p));
+
+    test_size_classes();
+    test_arena();
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
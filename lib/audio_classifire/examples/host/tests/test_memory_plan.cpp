@@ -0,0 +1,101 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the unified memory plan: the arena layout exported with the model is
+ * the one the compiled model uses at runtime, and the plan peak is the region size.
+ * Prints the plan, so the peak shows up in the test log.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static uint8_t *arena = NULL;
+
+static void *record_alloc(size_t align, size_t size)
+{
+    arena = (uint8_t *)ei_aligned_calloc(align, size);
+    return arena;
+}
+
+static size_t arena_offset(const TfLiteTensor &tensor)
+{
+    return (size_t)((uint8_t *)tensor.data.raw - arena);
+}
+
+int main()
+{
+    const ei_memory_plan_layout_t &layout = ei_memory_plan_layout;
+    const size_t separate = layout.features_bytes + layout.arena_bytes;
+    const size_t region = ei_memory_plan_region_size(layout);
+
+    printf("features %u + arena %u bytes (tensors %u, input at %u) -> region %u bytes, saves %u\n",
+        (unsigned)layout.features_bytes, (unsigned)layout.arena_bytes, (unsigned)layout.arena_tensor_bytes,
+        (unsigned)layout.input_offset, (unsigned)region, (unsigned)(separate - region));
+
+    // the exported tensor table is a valid layout, and the one the model runs with
+    static_assert(ei_arena_plan_is_valid(tflite_learn_40_arena_tensors, tflite_learn_40_arena_tensor_count),
+        "tensors that are live together overlap");
+    CHECK(tflite_learn_40_init(&record_alloc) == kTfLiteOk);
+    TfLiteTensor input, output;
+    CHECK(tflite_learn_40_input(0, &input) == kTfLiteOk);
+    CHECK(tflite_learn_40_output(0, &output) == kTfLiteOk);
+    CHECK(arena_offset(input) == tflite_learn_40_input_offset);
+    CHECK(input.bytes == tflite_learn_40_input_bytes);
+    CHECK(arena_offset(output) == tflite_learn_40_tensor_offset(25));
+    CHECK(tflite_learn_40_reset(&ei_aligned_free) == kTfLiteOk);
+
+    // the greedy planner agrees on the peak
+    std::vector<float> audio(EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+    for (size_t ix = 0; ix < audio.size(); ix++) {
+        audio[ix] = roundf(8000.0f * sinf(2.0f * (float)M_PI * 440.0f * ix / EI_CLASSIFIER_FREQUENCY));
+    }
+    signal_t signal;
+    CHECK(numpy::signal_from_buffer(audio.data(), audio.size(), &signal) == 0);
+    ei_impulse_result_t result;
+    memset(&result, 0, sizeof(result));
+    CHECK(run_classifier(&signal, &result) == EI_IMPULSE_OK);
+    CHECK(ei_memory_plan_peak_bytes() == region);
+    CHECK(region < separate);
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the DCT in mfcc(): repeated calls, several filterbank shapes and
+ * shapes past the cache size all match a basis built per call, bit for bit. All of
+ * them stay within a relative tolerance of the full numpy::dct2() of every frame,
+ * truncated to the kept coefficients, which is what mfcc() computed before.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "edge-impulse-sdk/dsp/speechpy/speechpy.hpp"
+
+using namespace ei;
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const uint32_t frequency = 16000;
+static const float frame_length = 0.02f;
+static const float frame_stride = 0.01f;
+static const uint16_t fft_length = 256;
+static const uint16_t version = 4;
+
+// log of the MFE, the input of the DCT in mfcc()
+static int log_mfe(matrix_t *features, signal_t *signal, uint16_t num_filters)
+{
+    matrix_t energies(features->rows, 1);
+    int ret = speechpy::feature::mfe(features, &energies, signal, frequency, frame_length,
+        frame_stride, num_filters, fft_length, 0, 0, version);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+    return numpy::log(features);
+}
+
+// mfcc() without the cache: log of the MFE, times a basis built for this call
+static int reference_mfcc(matrix_t *out, signal_t *signal, uint8_t num_cepstral, uint16_t num_filters)
+{
+    matrix_size_t size = speechpy::feature::calculate_mfe_buffer_size(
+        signal->total_length, frequency, frame_length, frame_stride, num_filters, version);
+    matrix_t features(size.rows, size.cols);
+    int ret = log_mfe(&features, signal, num_filters);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+    matrix_t basis(num_filters, num_cepstral);
+    ret = numpy::dct2_basis(&basis, DCT_NORMALIZATION_ORTHO);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+    return numpy::dot(&features, &basis, out);
+}
+
+// mfcc() before the basis matrix: numpy::dct2() of every frame, first num_cepstral columns kept
+static int dct2_mfcc(matrix_t *out, signal_t *signal, uint8_t num_cepstral, uint16_t num_filters)
+{
+    matrix_size_t size = speechpy::feature::calculate_mfe_buffer_size(
+        signal->total_length, frequency, frame_length, frame_stride, num_filters, version);
+    matrix_t features(size.rows, size.cols);
+    int ret = log_mfe(&features, signal, num_filters);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+    ret = numpy::dct2(&features, DCT_NORMALIZATION_ORTHO);
+    if (ret != EIDSP_OK) {
+        return ret;
+    }
+    for (size_t row = 0; row < features.rows; row++) {
+        memcpy(out->buffer + row * num_cepstral, features.buffer + row * features.cols, num_cepstral * sizeof(float));
+    }
+    return EIDSP_OK;
+}
+
+// largest difference relative to the largest magnitude in expected
+static float relative_diff(const matrix_t &actual, const matrix_t &expected)
+{
+    float max_diff = 0.0f, max_value = 0.0f;
+    for (size_t ix = 0; ix < expected.rows * expected.cols; ix++) {
+        max_diff = fmaxf(max_diff, fabsf(actual.buffer[ix] - expected.buffer[ix]));
+        max_value = fmaxf(max_value, fabsf(expected.buffer[ix]));
+    }
+    return max_value > 0.0f ? max_diff / max_value : max_diff;
+}
+
+static void check_shape(signal_t *signal, uint8_t num_cepstral, uint16_t num_filters)
+{
+    matrix_size_t size = speechpy::feature::calculate_mfcc_buffer_size(
+        signal->total_length, frequency, frame_length, frame_stride, num_cepstral, version);
+    matrix_t expected(size.rows, size.cols);
+    CHECK(reference_mfcc(&expected, signal, num_cepstral, num_filters) == EIDSP_OK);
+
+    for (int call = 0; call < 2; call++) {
+        matrix_t out(size.rows, size.cols);
+        CHECK(speechpy::feature::mfcc(&out, signal, frequency, frame_length, frame_stride,
+            num_cepstral, num_filters, fft_length, 0, 0, false, version) == EIDSP_OK);
+        CHECK(memcmp(out.buffer, expected.buffer, size.rows * size.cols * sizeof(float)) == 0);
+    }
+
+    matrix_t old_path(size.rows, size.cols);
+    CHECK(dct2_mfcc(&old_path, signal, num_cepstral, num_filters) == EIDSP_OK);
+    float diff = relative_diff(expected, old_path);
+    printf("%u filters, %u coefficients: relative difference to dct2 %.2g\n",
+        (unsigned)num_filters, (unsigned)num_cepstral, diff);
+    CHECK(diff < 1e-6f);
+}
+
+int main()
+{
+    std::vector<float> audio(frequency / 2);
+    for (size_t ix = 0; ix < audio.size(); ix++) {
+        audio[ix] = (float)(8000.0 * sin(ix * 0.05) + 3000.0 * sin(ix * 0.71) + (ix % 17) * 40.0);
+    }
+
+    signal_t signal;
+    CHECK(numpy::signal_from_buffer(audio.data(), audio.size(), &signal) == 0);
+
+    // more shapes than cache entries, then the first shape again
+    check_shape(&signal, 13, 32);
+    check_shape(&signal, 13, 40);
+    check_shape(&signal, 10, 40);
+    check_shape(&signal, 20, 64);
+    check_shape(&signal, 13, 32);
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of per-stream postprocessing state: two continuous streams on one handle
+ * keep separate smoothing state, and setting up or releasing one of them does not touch
+ * the other or the handle.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const size_t slice = EI_CLASSIFIER_SLICE_SIZE;
+static const int slices = 3 * EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
+
+// a tone per stream, so the two streams classify differently
+static std::vector<float> make_audio(float freq)
+{
+    std::vector<float> audio(slices * slice);
+    for (size_t ix = 0; ix < audio.size(); ix++) {
+        audio[ix] = roundf(8000.0f * sinf(2.0f * (float)M_PI * freq * ix / EI_CLASSIFIER_FREQUENCY));
+    }
+    return audio;
+}
+
+static EI_IMPULSE_ERROR run_slice(ei_continuous_ctx_t *ctx, std::vector<float> &audio, int ix,
+                                  ei_impulse_result_t *result)
+{
+    signal_t signal;
+    CHECK(numpy::signal_from_buffer(audio.data() + ix * slice, slice, &signal) == 0);
+    memset(result, 0, sizeof(*result));
+    return run_classifier_continuous(ctx, &signal, result);
+}
+
+int main()
+{
+    std::vector<float> audio_a = make_audio(440.0f);
+    std::vector<float> audio_b = make_audio(3000.0f);
+
+    // stream A alone
+    std::vector<ei_smoothing_output_t> alone;
+    {
+        ei_continuous_ctx_t a = {};
+        CHECK(run_classifier_init(&a, &ei_default_impulse) == EI_IMPULSE_OK);
+        CHECK(a.post_processing_state != nullptr);
+        CHECK(ei_default_impulse.post_processing_state == nullptr);
+        for (int ix = 0; ix < slices; ix++) {
+            ei_impulse_result_t result;
+            CHECK(run_slice(&a, audio_a, ix, &result) == EI_IMPULSE_OK);
+            alone.push_back(result.postprocessed_output.smoothing_output);
+        }
+        run_classifier_deinit(&a);
+        CHECK(a.post_processing_state == nullptr);
+    }
+
+    // stream A interleaved with stream B on the same handle
+    ei_continuous_ctx_t a = {};
+    ei_continuous_ctx_t b = {};
+    CHECK(run_classifier_init(&a, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(run_classifier_init(&b, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(a.post_processing_state != b.post_processing_state);
+
+    // setting a stream up again reuses nothing of the old state and leaves the others alone
+    void **a_state = a.post_processing_state;
+    CHECK(run_classifier_init(&b, &ei_default_impulse) == EI_IMPULSE_OK);
+    CHECK(a.post_processing_state == a_state);
+    CHECK(ei_default_impulse.post_processing_state == nullptr);
+
+    for (int ix = 0; ix < slices; ix++) {
+        ei_impulse_result_t result;
+        if (ix <= slices / 2) {
+            CHECK(run_slice(&b, audio_b, ix, &result) == EI_IMPULSE_OK);
+        }
+        CHECK(run_slice(&a, audio_a, ix, &result) == EI_IMPULSE_OK);
+        CHECK(memcmp(&result.postprocessed_output.smoothing_output, &alone[ix], sizeof(ei_smoothing_output_t)) == 0);
+
+        // releasing B halfway leaves A running on its own state
+        if (ix == slices / 2) {
+            run_classifier_deinit(&b);
+            CHECK(a.post_processing_state == a_state);
+        }
+    }
+
+    CHECK(ei_smoothing_reset(&a) == EI_IMPULSE_OK);
+    CHECK(ei_smoothing_reset(&b) == EI_IMPULSE_INFERENCE_ERROR);
+    run_classifier_deinit(&a);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+/* Edge Impulse host examples
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Host test of the EON model instances: two instances created next to the default one
+ * give the outputs of the default one for the same input, also with their invokes
+ * interleaved, and setup and teardown report success. Built with
+ * EI_CLASSIFIER_TFLITE_REENTRANT, so run_classifier() from several threads at once
+ * has to give the results of running the windows one after the other.
+ */
+
+/* Includes ---------------------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static const int inputs_count = 3;
+static const size_t window = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+
+// a different pattern per input, so the outputs differ
+static void fill_input(TfLiteTensor *input, int ix)
+{
+    uint32_t seed = 1 + ix;
+    for (size_t i = 0; i < input->bytes; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        input->data.int8[i] = (int8_t)((seed >> 24) % (40 + 40 * ix)) - 128;
+    }
+}
+
+static std::vector<int8_t> read_output(const TfLiteTensor *output)
+{
+    return std::vector<int8_t>(output->data.int8, output->data.int8 + output->bytes);
+}
+
+static void test_instances(void)
+{
+    TfLiteTensor input;
+    TfLiteTensor output;
+
+    // the default instance
+    std::vector<int8_t> expected[inputs_count];
+    CHECK(tflite_learn_40_init(ei_aligned_calloc) == kTfLiteOk);
+    CHECK(tflite_learn_40_input(0, &input) == kTfLiteOk);
+    CHECK(tflite_learn_40_output(0, &output) == kTfLiteOk);
+    for (int ix = 0; ix < inputs_count; ix++) {
+        fill_input(&input, ix);
+        CHECK(tflite_learn_40_invoke() == kTfLiteOk);
+        expected[ix] = read_output(&output);
+    }
+    CHECK(expected[0] != expected[1] || expected[0] != expected[2]);
+
+    // two more, while the default one is still set up
+    void *a = tflite_learn_40_create(ei_aligned_calloc, ei_aligned_free);
+    void *b = tflite_learn_40_create(ei_aligned_calloc, ei_aligned_free);
+    CHECK(a != nullptr && b != nullptr && a != b);
+    if (a && b) {
+        TfLiteTensor input_a, input_b, output_a, output_b;
+        CHECK(tflite_learn_40_instance_input(a, 0, &input_a) == kTfLiteOk);
+        CHECK(tflite_learn_40_instance_input(b, 0, &input_b) == kTfLiteOk);
+        CHECK(tflite_learn_40_instance_output(a, 0, &output_a) == kTfLiteOk);
+        CHECK(tflite_learn_40_instance_output(b, 0, &output_b) == kTfLiteOk);
+        CHECK(input_a.data.int8 != input_b.data.int8 && input_a.data.int8 != input.data.int8);
+
+        for (int ix = 0; ix < inputs_count; ix++) {
+            // each instance keeps its own input and activations across the other's invoke
+            int other = (ix + 1) % inputs_count;
+            fill_input(&input_a, ix);
+            fill_input(&input_b, other);
+            CHECK(tflite_learn_40_instance_invoke(a) == kTfLiteOk);
+            CHECK(tflite_learn_40_instance_invoke(b) == kTfLiteOk);
+            CHECK(read_output(&output_a) == expected[ix]);
+            CHECK(read_output(&output_b) == expected[other]);
+        }
+
+        // and the default one is untouched by them
+        fill_input(&input, 2);
+        CHECK(tflite_learn_40_invoke() == kTfLiteOk);
+        CHECK(read_output(&output) == expected[2]);
+    }
+
+    CHECK(tflite_learn_40_destroy(a, ei_aligned_free) == kTfLiteOk);
+    CHECK(tflite_learn_40_destroy(b, ei_aligned_free) == kTfLiteOk);
+    CHECK(tflite_learn_40_reset(ei_aligned_free) == kTfLiteOk);
+}
+
+static void test_parallel_classifier(void)
+{
+    const int threads_count = 4;
+    const int runs = 3;
+
+    std::vector<float> audio(threads_count * window);
+    for (int t = 0; t < threads_count; t++) {
+        for (size_t ix = 0; ix < window; ix++) {
+            float freq = 300.0f + 700.0f * t;
+            audio[t * window + ix] = roundf(2000.0f * sinf(2.0f * (float)M_PI * freq * ix / EI_CLASSIFIER_FREQUENCY));
+        }
+    }
+
+    // one after the other
+    ei_impulse_result_t expected[threads_count];
+    for (int t = 0; t < threads_count; t++) {
+        signal_t signal;
+        CHECK(numpy::signal_from_buffer(audio.data() + t * window, window, &signal) == 0);
+        memset(&expected[t], 0, sizeof(expected[t]));
+        CHECK(run_classifier(&signal, &expected[t]) == EI_IMPULSE_OK);
+    }
+
+    bool differ = false;
+    for (int t = 1; t < threads_count; t++) {
+        differ |= memcmp(expected[0].quantized.value, expected[t].quantized.value,
+                         sizeof(expected[0].quantized.value[0]) * EI_CLASSIFIER_LABEL_COUNT) != 0;
+    }
+    CHECK(differ);
+
+    // all at once, each thread on its own window
+    int mismatches[threads_count] = { };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; t++) {
+        threads.emplace_back([&, t]() {
+            for (int run = 0; run < runs; run++) {
+                signal_t signal;
+                numpy::signal_from_buffer(audio.data() + t * window, window, &signal);
+                ei_impulse_result_t result;
+                memset(&result, 0, sizeof(result));
+                if (run_classifier(&signal, &result) != EI_IMPULSE_OK ||
+                        memcmp(result.quantized.value, expected[t].quantized.value,
+                               sizeof(result.quantized.value[0]) * EI_CLASSIFIER_LABEL_COUNT) != 0) {
+                    mismatches[t]++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < threads_count; t++) {
+        CHECK(mismatches[t] == 0);
+    }
+}
+
+int main()
+{
+    test_instances();
+    test_parallel_classifier();
+
+    if (failures > 0) {
+        printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,104 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_ARENA_PLAN_H_
+#define _EI_CLASSIFIER_ARENA_PLAN_H_
+
+/**
+ * Layout of the non-persistent tensors of a compiled model.
+ *
+ * The model exporter plans the tensors with tflite::GreedyMemoryPlanner and emits
+ * the offsets in a table next to the model, together with the size and live range
+ * of every tensor. The helpers below only look things up in that table, in linear
+ * time, so the offsets and the size of the tensor area are compile time constants
+ * that can be used in static buffer sizes. ei_arena_plan_is_valid() checks that
+ * tensors that are live at the same time do not overlap.
+ *
+ * Written as single-return recursion (C++11), every function recurses once per
+ * table entry.
+ */
+
+#include <stddef.h>
+
+typedef struct {
+    int index;          // tensor index in the model
+    size_t offset;      // offset in the arena
+    size_t bytes;
+    int first_node;     // first node that uses the tensor (0 for model inputs)
+    int last_node;      // last node that uses the tensor
+} ei_arena_plan_tensor_t;
+
+constexpr bool ei_arena_plan_live_together(const ei_arena_plan_tensor_t &a, const ei_arena_plan_tensor_t &b) {
+    return a.first_node <= b.last_node && b.first_node <= a.last_node;
+}
+
+constexpr bool ei_arena_plan_overlap(const ei_arena_plan_tensor_t &a, const ei_arena_plan_tensor_t &b) {
+    return a.offset < b.offset + b.bytes && b.offset < a.offset + a.bytes;
+}
+
+/**
+ * Slot of the tensor with the given model index, count if it is not in the table
+ */
+constexpr size_t ei_arena_plan_slot(const ei_arena_plan_tensor_t *tensors, size_t count, int index, size_t slot = 0) {
+    return slot == count || tensors[slot].index == index ? slot : ei_arena_plan_slot(tensors, count, index, slot + 1);
+}
+
+constexpr size_t ei_arena_plan_max(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+/**
+ * Bytes taken by all tensors, i.e. the end of the tensor that ends last
+ */
+constexpr size_t ei_arena_plan_size(const ei_arena_plan_tensor_t *tensors, size_t count, size_t slot = 0) {
+    return slot == count ? 0 :
+        ei_arena_plan_max(tensors[slot].offset + tensors[slot].bytes, ei_arena_plan_size(tensors, count, slot + 1));
+}
+
+// whether tensor `slot` is 16 byte aligned and clear of the tensors from `other` on
+constexpr bool ei_arena_plan_slot_is_valid(const ei_arena_plan_tensor_t *tensors, size_t count, size_t slot, size_t other) {
+    return other == count ? (tensors[slot].offset & 15) == 0 :
+        !(ei_arena_plan_live_together(tensors[slot], tensors[other]) && ei_arena_plan_overlap(tensors[slot], tensors[other])) &&
+        ei_arena_plan_slot_is_valid(tensors, count, slot, other + 1);
+}
+
+/**
+ * Whether all tensors are aligned and no two tensors that are live at the same time overlap
+ */
+constexpr bool ei_arena_plan_is_valid(const ei_arena_plan_tensor_t *tensors, size_t count, size_t slot = 0) {
+    return slot == count ||
+        (ei_arena_plan_slot_is_valid(tensors, count, slot, slot + 1) && ei_arena_plan_is_valid(tensors, count, slot + 1));
+}
+
+#endif // _EI_CLASSIFIER_ARENA_PLAN_H_
@@ -0,0 +1,304 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_CASCADE_H_
+#define _EI_CLASSIFIER_CASCADE_H_
+
+/**
+ * Two stage (cascade) execution of a learning block.
+ *
+ * A cheap first stage scores every window from the DSP features. If its top score
+ * lies in the band [accept_confidence, accept_confidence_max] and that label is one
+ * the first stage may answer alone (accept_labels, typically only the background
+ * label), the full model is skipped and the first stage scores go through the
+ * regular postprocessing chain in its place. Everything else, i.e. windows outside
+ * the band or with a label the first stage is not trusted with, runs the full model.
+ *
+ * The upper edge is for first stages that saturate on inputs they were not trained
+ * on: a linear probe over pooled energies gives its most extreme scores on clipped
+ * or very loud audio, which is exactly where the background label should not be
+ * trusted. Set it to 1 to accept everything above the lower edge.
+ *
+ * The first stage is any ei_cascade_gate_fn; ei_cascade_linear_probe is a linear
+ * classifier over the per-coefficient mean of the features (e.g. the 40 MFE
+ * filterbank energies averaged over time), trained offline on the same labels.
+ *
+ * Set up with ei_cascade_init() and attach with handle->cascade = &cascade. Per
+ * window timing is in result.timing.cascade_*, totals and the skip rate in the
+ * ei_cascade_t.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+
+#if EI_CLASSIFIER_CASCADE
+
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+/**
+ * First stage, writes impulse->label_count scores in [0, 1] for the features
+ */
+typedef EI_IMPULSE_ERROR (*ei_cascade_gate_fn)(const ei_impulse_t *impulse,
+                                               const ei::matrix_t *features,
+                                               const void *config,
+                                               float *scores);
+
+typedef struct ei_cascade {
+    ei_cascade_gate_fn gate_fn;
+    const void *gate_config;
+    uint32_t block_id;          // learning block the first stage stands in for
+    float accept_confidence;    // lower edge of the band the first stage answers alone
+    float accept_confidence_max; // upper edge of the band, 1 for no upper edge
+    uint32_t accept_labels;     // bit per label the first stage may answer, e.g. 1 << background
+
+    // totals since the last ei_cascade_reset_stats()
+    uint32_t windows;
+    uint32_t skipped;
+    uint64_t gate_us;
+    uint64_t full_us;
+} ei_cascade_t;
+
+/**
+ * Linear probe over the per-coefficient mean of the features. The features are
+ * read as rows of `coefficients` values (frames x filters for MFE / MFCC).
+ */
+typedef struct {
+    uint16_t coefficients;
+    const float *weights;       // [label_count][coefficients]
+    const float *bias;          // [label_count]
+} ei_cascade_linear_probe_t;
+
+__attribute__((unused)) static void ei_cascade_reset_stats(ei_cascade_t *cascade) {
+    cascade->windows = 0;
+    cascade->skipped = 0;
+    cascade->gate_us = 0;
+    cascade->full_us = 0;
+}
+
+/**
+ * Set up a cascade for the learning block `block_id`, with the band the first
+ * stage answers alone in and the labels it may answer
+ */
+__attribute__((unused)) static void ei_cascade_init(ei_cascade_t *cascade,
+                                                    ei_cascade_gate_fn gate_fn,
+                                                    const void *gate_config,
+                                                    uint32_t block_id,
+                                                    float accept_confidence,
+                                                    float accept_confidence_max,
+                                                    uint32_t accept_labels) {
+    cascade->gate_fn = gate_fn;
+    cascade->gate_config = gate_config;
+    cascade->block_id = block_id;
+    cascade->accept_confidence = accept_confidence;
+    cascade->accept_confidence_max = accept_confidence_max;
+    cascade->accept_labels = accept_labels;
+    ei_cascade_reset_stats(cascade);
+}
+
+__attribute__((unused)) static float ei_cascade_skip_rate(const ei_cascade_t *cascade) {
+    return cascade->windows ? (float)cascade->skipped / (float)cascade->windows : 0.0f;
+}
+
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_cascade_linear_probe(const ei_impulse_t *impulse,
+                                                                       const ei::matrix_t *features,
+                                                                       const void *config_ptr,
+                                                                       float *scores) {
+    const ei_cascade_linear_probe_t *config = (const ei_cascade_linear_probe_t *)config_ptr;
+    size_t count = features->rows * features->cols;
+    if (config->coefficients == 0 || count % config->coefficients != 0) {
+        ei_printf("ERR: %u features can not be pooled into %u coefficients\n",
+            (unsigned int)count, (unsigned int)config->coefficients);
+        return EI_IMPULSE_DSP_ERROR;
+    }
+
+    float *pooled = (float *)ei_calloc(config->coefficients, sizeof(float));
+    if (!pooled) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    size_t frames = count / config->coefficients;
+    for (size_t f = 0; f < frames; f++) {
+        const float *row = features->buffer + f * config->coefficients;
+        for (size_t c = 0; c < config->coefficients; c++) {
+            pooled[c] += row[c];
+        }
+    }
+    for (size_t c = 0; c < config->coefficients; c++) {
+        pooled[c] /= (float)frames;
+    }
+
+    // logits, then softmax
+    float max_logit = -INFINITY;
+    for (size_t ix = 0; ix < impulse->label_count; ix++) {
+        const float *w = config->weights + ix * config->coefficients;
+        float logit = config->bias ? config->bias[ix] : 0.0f;
+        for (size_t c = 0; c < config->coefficients; c++) {
+            logit += w[c] * pooled[c];
+        }
+        scores[ix] = logit;
+        max_logit = logit > max_logit ? logit : max_logit;
+    }
+    float sum = 0.0f;
+    for (size_t ix = 0; ix < impulse->label_count; ix++) {
+        scores[ix] = expf(scores[ix] - max_logit);
+        sum += scores[ix];
+    }
+    for (size_t ix = 0; ix < impulse->label_count; ix++) {
+        scores[ix] /= sum;
+    }
+
+    ei_free(pooled);
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Put the first stage scores into the raw outputs of the learning block, in the
+ * format its postprocessing block reads
+ *
+ * @return EI_IMPULSE_OK, or an error if the output format is not known (the full
+ *         model runs in that case)
+ */
+static EI_IMPULSE_ERROR ei_cascade_fill_raw_output(const ei_impulse_t *impulse,
+                                                   uint32_t learn_block_index,
+                                                   const float *scores,
+                                                   ei_impulse_result_t *result) {
+    uint32_t block_id = impulse->learning_blocks[learn_block_index].blockId;
+    ei_feature_t *raw = &result->_raw_outputs[learn_block_index];
+
+    for (size_t ix = 0; ix < impulse->postprocessing_blocks_size; ix++) {
+        const ei_postprocessing_block_t *block = &impulse->postprocessing_blocks[ix];
+        if (block->input_block_id != block_id) {
+            continue;
+        }
+
+        if (block->postprocess_fn == process_classification_i8 || block->postprocess_fn == process_classification_u8) {
+            const ei_fill_result_classification_i8_config_t *config =
+                (const ei_fill_result_classification_i8_config_t *)block->config;
+            bool is_signed = block->postprocess_fn == process_classification_i8;
+            int32_t q_min = is_signed ? -128 : 0;
+            int32_t q_max = is_signed ? 127 : 255;
+            if (is_signed) {
+                raw->matrix_i8 = new ei::matrix_i8_t(1, impulse->label_count);
+            }
+            else {
+                raw->matrix_u8 = new ei::matrix_u8_t(1, impulse->label_count);
+            }
+            for (size_t label = 0; label < impulse->label_count; label++) {
+                int32_t q = (int32_t)roundf(scores[label] / config->scale + config->zero_point);
+                q = q < q_min ? q_min : (q > q_max ? q_max : q);
+                if (is_signed) {
+                    raw->matrix_i8->buffer[label] = (int8_t)q;
+                }
+                else {
+                    raw->matrix_u8->buffer[label] = (uint8_t)q;
+                }
+            }
+        }
+        else if (block->postprocess_fn == process_classification_f32) {
+            raw->matrix = new ei::matrix_t(1, impulse->label_count);
+            memcpy(raw->matrix->buffer, scores, impulse->label_count * sizeof(float));
+        }
+        else {
+            return EI_IMPULSE_POSTPROCESSING_ERROR;
+        }
+
+        raw->blockId = block_id;
+        return EI_IMPULSE_OK;
+    }
+
+    return EI_IMPULSE_POSTPROCESSING_ERROR;
+}
+
+/**
+ * Run the first stage for a learning block
+ *
+ * @return true if the first stage answered and the full model can be skipped
+ */
+__attribute__((unused)) static bool ei_cascade_try_skip(ei_cascade_t *cascade,
+                                                        const ei_impulse_t *impulse,
+                                                        ei_feature_t *fmatrix,
+                                                        uint32_t learn_block_index,
+                                                        ei_impulse_result_t *result) {
+    const ei_learning_block_t *block = &impulse->learning_blocks[learn_block_index];
+    if (!cascade->gate_fn || block->blockId != cascade->block_id || block->input_block_ids_size == 0) {
+        return false;
+    }
+
+    const ei::matrix_t *features = nullptr;
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        if (fmatrix[ix].blockId == block->input_block_ids[0]) {
+            features = fmatrix[ix].matrix;
+            break;
+        }
+    }
+    if (!features) {
+        return false;
+    }
+
+    uint64_t gate_start_us = ei_read_timer_us();
+    cascade->windows++;
+
+    float *scores = (float *)ei_calloc(impulse->label_count, sizeof(float));
+    bool skip = false;
+    if (scores && cascade->gate_fn(impulse, features, cascade->gate_config, scores) == EI_IMPULSE_OK) {
+        size_t top = 0;
+        for (size_t ix = 1; ix < impulse->label_count; ix++) {
+            if (scores[ix] > scores[top]) {
+                top = ix;
+            }
+        }
+        result->timing.cascade_score = scores[top];
+        skip = scores[top] >= cascade->accept_confidence && scores[top] <= cascade->accept_confidence_max &&
+            top < 32 && (cascade->accept_labels & (1u << top)) &&
+            ei_cascade_fill_raw_output(impulse, learn_block_index, scores, result) == EI_IMPULSE_OK;
+    }
+    ei_free(scores);
+
+    result->timing.cascade_gate_us = ei_read_timer_us() - gate_start_us;
+    cascade->gate_us += result->timing.cascade_gate_us;
+    if (skip) {
+        cascade->skipped++;
+        result->timing.cascade_skipped = true;
+    }
+    return skip;
+}
+
+#endif // EI_CLASSIFIER_CASCADE
+
+#endif // _EI_CLASSIFIER_CASCADE_H_
@@ -95,6 +95,98 @@
     #define ESP_NN                                  1
 #endif
 
+// Benchmark the ESP-NN kernel variants on the model's layer shapes at first init
+// and cache the fastest in NVS (porting/espressif/ei_esp_nn_dispatch.h)
+#ifndef EI_CLASSIFIER_ESP_NN_AUTOTUNE
+#define EI_CLASSIFIER_ESP_NN_AUTOTUNE                 0
+#endif
+
+// Use the shape-specialized int8 conv / fully connected kernels
+// (tensorflow/lite/micro/kernels/specialized_kernels.h) in EON compiled models
+#ifndef EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS
+#define EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS      0
+#endif
+
+// Extra threads the conv / fully connected kernels split their output across
+// (porting/ei_parallel.h). On ESP32 this is capped at one task on the other core.
+#ifndef EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS
+#define EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS         0
+#endif
+
+// Time every node of EON compiled models, track its arena usage and forward
+// op-tagged events to a tflite::MicroProfilerInterface (see <model>_layer_stats)
+#ifndef EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+#define EI_CLASSIFIER_TFLITE_LAYER_PROFILING          0
+#endif
+
+// Serve ei_malloc / ei_calloc from a region of this many bytes reserved at link
+// time instead of the system heap (porting/ei_mem_pool.h). 0 uses the system heap.
+#ifndef EI_CLASSIFIER_ALLOCATOR_POOL_SIZE
+#define EI_CLASSIFIER_ALLOCATOR_POOL_SIZE             0
+#endif
+
+// Part of the region above used for the 16 .. 512 byte size-class pools
+#ifndef EI_CLASSIFIER_ALLOCATOR_SMALL_POOL_SIZE
+#define EI_CLASSIFIER_ALLOCATOR_SMALL_POOL_SIZE       4096
+#endif
+
+// Don't reserve the pool region at link time, the application passes its own to
+// ei_mem_pool_init() (e.g. in external RAM). Until then the system heap is used.
+#ifndef EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL
+#define EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL         0
+#endif
+
+// Lay the DSP feature matrix and the EON tensor arena out in one static region,
+// quantizing the features in place into the input tensor (classifier/ei_memory_plan.h)
+#ifndef EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+#define EI_CLASSIFIER_UNIFIED_MEMORY_PLAN             0
+#endif
+
+// Count SDK heap usage per pipeline stage into result.memory, together with the
+// tensor arena usage (porting/ei_mem_accounting.h). Counters only, no printing.
+#ifndef EI_CLASSIFIER_MEMORY_ACCOUNTING
+#define EI_CLASSIFIER_MEMORY_ACCOUNTING               0
+#endif
+
+// Give every inference on an EON compiled model its own instance (arena and context,
+// the weights are shared), so run_classifier() can be called from several threads at once
+#ifndef EI_CLASSIFIER_TFLITE_REENTRANT
+#define EI_CLASSIFIER_TFLITE_REENTRANT                0
+#endif
+
+// Let impulse handles share the features of identical DSP blocks over the same
+// window through an ei_feature_cache_t (classifier/ei_feature_cache.h)
+#ifndef EI_CLASSIFIER_FEATURE_CACHE
+#define EI_CLASSIFIER_FEATURE_CACHE                   0
+#endif
+
+// Feature matrices the cache holds, one per distinct DSP block
+#ifndef EI_CLASSIFIER_FEATURE_CACHE_ENTRIES
+#define EI_CLASSIFIER_FEATURE_CACHE_ENTRIES           2
+#endif
+
+// Let a cheap first stage answer for a learning block when it is confident enough,
+// skipping the full model (classifier/ei_cascade.h, handle->cascade)
+#ifndef EI_CLASSIFIER_CASCADE
+#define EI_CLASSIFIER_CASCADE                         0
+#endif
+
+// Let EON compiled models exit through a small head on the last conv activations,
+// skipping the fully connected layers when it is confident (see <model>_set_early_exit)
+#ifndef EI_CLASSIFIER_TFLITE_EARLY_EXIT
+#define EI_CLASSIFIER_TFLITE_EARLY_EXIT               0
+#endif
+
+// Leave result.classification[].value empty for int8 outputs until ei_classifier_dequantize()
+// is called, only the quantized scores in result.quantized are filled in
+#ifndef EI_CLASSIFIER_LAZY_DEQUANTIZE
+#define EI_CLASSIFIER_LAZY_DEQUANTIZE                 0
+#endif
+
+#if EI_CLASSIFIER_TFLITE_REENTRANT && EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+#error "EI_CLASSIFIER_TFLITE_REENTRANT needs an arena per inference, it cannot be combined with EI_CLASSIFIER_UNIFIED_MEMORY_PLAN"
+#endif
+
 // no include checks in the compiler? then just include metadata and then ops_define (optional if on EON model)
 #ifndef __has_include
     #include "model-parameters/model_metadata.h"
@@ -47,6 +47,7 @@ typedef struct ei_classifier_smooth {
     float anomaly_confidence;
     uint8_t count[EI_CLASSIFIER_LABEL_COUNT + 2] = { 0 };
     size_t count_size = EI_CLASSIFIER_LABEL_COUNT + 2;
+    size_t last_readings_ix = 0; // oldest reading, overwritten by the next one
 } ei_classifier_smooth_t;
 
 /**
@@ -72,6 +73,19 @@ void ei_classifier_smooth_init(ei_classifier_smooth_t *smooth, size_t n_readings
     smooth->classifier_confidence = classifier_confidence;
     smooth->anomaly_confidence = anomaly_confidence;
     smooth->count_size = EI_CLASSIFIER_LABEL_COUNT + 2;
+    smooth->last_readings_ix = 0;
+    memset(smooth->count, 0, smooth->count_size);
+    smooth->count[EI_CLASSIFIER_LABEL_COUNT] = (uint8_t)n_readings;
+}
+
+/**
+ * Slot in the count array for a reading (label index, -1 uncertain or -2 anomaly)
+ */
+static inline size_t ei_classifier_smooth_count_ix(int reading) {
+    if (reading >= 0) {
+        return (size_t)reading;
+    }
+    return reading == -1 ? EI_CLASSIFIER_LABEL_COUNT : EI_CLASSIFIER_LABEL_COUNT + 1;
 }
 
 /**
@@ -81,12 +95,6 @@ void ei_classifier_smooth_init(ei_classifier_smooth_t *smooth, size_t n_readings
  * @returns Label, either 'uncertain', 'anomaly', or a label from the result struct
  */
 const char* ei_classifier_smooth_update(ei_classifier_smooth_t *smooth, ei_impulse_result_t *result) {
-    // clear out the count array
-    memset(smooth->count, 0, EI_CLASSIFIER_LABEL_COUNT + 2);
-
-    // roll through the last_readings buffer
-    numpy::roll(smooth->last_readings, smooth->last_readings_size, -1);
-
     int reading = -1; // uncertain
 
     // print the predictions
@@ -102,19 +110,13 @@ const char* ei_classifier_smooth_update(ei_classifier_smooth_t *smooth, ei_impul
     }
 #endif
 
-    smooth->last_readings[smooth->last_readings_size - 1] = reading;
-
-    // now count last 10 readings and see what we actually see...
-    for (size_t ix = 0; ix < smooth->last_readings_size; ix++) {
-        if (smooth->last_readings[ix] >= 0) {
-            smooth->count[smooth->last_readings[ix]]++;
-        }
-        else if (smooth->last_readings[ix] == -1) { // uncertain
-            smooth->count[EI_CLASSIFIER_LABEL_COUNT]++;
-        }
-        else if (smooth->last_readings[ix] == -2) { // anomaly
-            smooth->count[EI_CLASSIFIER_LABEL_COUNT + 1]++;
-        }
+    // the new reading replaces the oldest one, in the buffer and in the counts
+    int *oldest = &smooth->last_readings[smooth->last_readings_ix];
+    smooth->count[ei_classifier_smooth_count_ix(*oldest)]--;
+    smooth->count[ei_classifier_smooth_count_ix(reading)]++;
+    *oldest = reading;
+    if (++smooth->last_readings_ix == smooth->last_readings_size) {
+        smooth->last_readings_ix = 0;
     }
 
     // then loop over the count and see which is highest
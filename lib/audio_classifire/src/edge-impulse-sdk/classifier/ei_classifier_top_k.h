@@ -0,0 +1,165 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_TOP_K_H_
+#define _EI_CLASSIFIER_TOP_K_H_
+
+/**
+ * Top-k labels of a classification result.
+ *
+ * For int8 outputs the scores are ranked and compared against the threshold as the
+ * quantized values in result.quantized: the threshold is converted once, then it is
+ * integer compares only. A float is only produced when asked for one with
+ * ei_classifier_score(). Results of float outputs, and results whose scores were
+ * rewritten by a postprocessing block (see ei_classifier_drop_quantized()), fall back
+ * to the float scores. Nothing is allocated.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+
+typedef struct {
+    uint32_t index;         // label index into result.classification
+    int32_t rank_value;     // quantized score for int8 outputs, 0 otherwise
+} ei_classifier_top_t;
+
+/**
+ * Score of a label, dequantized if the result holds quantized scores
+ */
+__attribute__((unused)) static float ei_classifier_score(const ei_impulse_result_t *result, uint32_t index)
+{
+    if (result->quantized.count > 0) {
+        return ((float)result->quantized.value[index] - result->quantized.zero_point) * result->quantized.scale;
+    }
+    return result->classification[index].value;
+}
+
+/**
+ * Fill in result.classification[].value from the quantized scores, if that did not
+ * happen yet (EI_CLASSIFIER_LAZY_DEQUANTIZE)
+ */
+__attribute__((unused)) static void ei_classifier_dequantize(ei_impulse_result_t *result)
+{
+    if ((result->quantized.count == 0) || result->quantized.dequantized) {
+        return;
+    }
+    for (uint32_t ix = 0; ix < result->quantized.count; ix++) {
+        result->classification[ix].value = ei_classifier_score(result, ix);
+    }
+    result->quantized.dequantized = true;
+}
+
+/**
+ * For postprocessing blocks that rewrite result.classification[].value: drops the
+ * quantized scores, so top-k and ei_classifier_score() go by the rewritten float scores.
+ * Call ei_classifier_dequantize() before reading or rewriting the float scores.
+ */
+__attribute__((unused)) static void ei_classifier_drop_quantized(ei_impulse_result_t *result)
+{
+    result->quantized.count = 0;
+}
+
+/**
+ * Lowest quantized score that dequantizes to at least threshold, 128 if none does
+ */
+__attribute__((unused)) static int32_t ei_classifier_quantized_threshold(const ei_impulse_result_quantized_t *quantized, float threshold)
+{
+    int32_t q = (int32_t)ceilf(threshold / quantized->scale + quantized->zero_point);
+    q = q < -128 ? -128 : (q > 128 ? 128 : q);
+
+    // settle rounding of the division, so the compare matches the one on floats
+    while ((q > -128) && (((float)(q - 1) - quantized->zero_point) * quantized->scale >= threshold)) {
+        q--;
+    }
+    while ((q < 128) && (((float)q - quantized->zero_point) * quantized->scale < threshold)) {
+        q++;
+    }
+    return q;
+}
+
+/**
+ * Find the (at most) k labels with the highest scores of at least threshold.
+ *
+ * @param result    classification result
+ * @param top       k entries, sorted by descending score (ties keep the lower index first)
+ * @param k         number of entries in top
+ * @param threshold lowest score to return, EI_CLASSIFIER_THRESHOLD by default
+ *
+ * @return number of entries filled in
+ */
+__attribute__((unused)) static size_t ei_classifier_top_k(const ei_impulse_result_t *result,
+                                                           ei_classifier_top_t *top,
+                                                           size_t k,
+                                                           float threshold = EI_CLASSIFIER_THRESHOLD)
+{
+    size_t found = 0;
+
+    if (result->quantized.count > 0) {
+        const int32_t min_q = ei_classifier_quantized_threshold(&result->quantized, threshold);
+
+        for (uint32_t ix = 0; ix < result->quantized.count; ix++) {
+            const int32_t q = result->quantized.value[ix];
+            if ((q < min_q) || ((found == k) && (k == 0 || q <= top[k - 1].rank_value))) {
+                continue;
+            }
+            size_t pos = found < k ? found++ : k - 1;
+            while ((pos > 0) && (top[pos - 1].rank_value < q)) {
+                top[pos] = top[pos - 1];
+                pos--;
+            }
+            top[pos].index = ix;
+            top[pos].rank_value = q;
+        }
+        return found;
+    }
+
+    for (uint32_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+        const float value = result->classification[ix].value;
+        if ((value < threshold) || ((found == k) && (k == 0 || value <= result->classification[top[k - 1].index].value))) {
+            continue;
+        }
+        size_t pos = found < k ? found++ : k - 1;
+        while ((pos > 0) && (result->classification[top[pos - 1].index].value < value)) {
+            top[pos] = top[pos - 1];
+            pos--;
+        }
+        top[pos].index = ix;
+        top[pos].rank_value = 0;
+    }
+    return found;
+}
+
+#endif // _EI_CLASSIFIER_TOP_K_H_
@@ -39,6 +39,10 @@
 // needed for standalone C example
 #include "model-parameters/model_metadata.h"
 #include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
+#endif
 
 #ifndef EI_CLASSIFIER_MAX_OBJECT_DETECTION_COUNT
 #define EI_CLASSIFIER_MAX_OBJECT_DETECTION_COUNT 10
@@ -217,8 +221,125 @@ typedef struct {
      * `EI_CLASSIFIER_HAS_ANOMALY == 1`.
      */
     int64_t anomaly_us;
+
+#if EI_CLASSIFIER_FEATURE_CACHE || __DOXYGEN__
+    /**
+     * Number of DSP blocks whose features came from the handle's feature cache
+     * instead of being computed. Only if `EI_CLASSIFIER_FEATURE_CACHE` is enabled.
+     */
+    int dsp_cache_hits;
+#endif
+
+#if EI_CLASSIFIER_CASCADE || __DOXYGEN__
+    /**
+     * Amount of time (in microseconds) it took to run the first stage of the cascade.
+     * Only if `EI_CLASSIFIER_CASCADE` is enabled and the handle has a cascade.
+     */
+    int64_t cascade_gate_us;
+
+    /**
+     * Top score of the first stage
+     */
+    float cascade_score;
+
+    /**
+     * Whether the first stage answered and the full model was skipped
+     */
+    bool cascade_skipped;
+#endif
 } ei_impulse_result_timing_t;
 
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING || __DOXYGEN__
+/**
+ * @brief Holds memory usage of a single `run_classifier()` call.
+ *
+ * Heap figures cover everything allocated through `ei_malloc()` / `ei_calloc()`.
+ * Only filled in if `EI_CLASSIFIER_MEMORY_ACCOUNTING` is enabled.
+ */
+typedef struct {
+    /**
+     * Heap usage while the DSP blocks ran (over all blocks)
+     */
+    ei_mem_stage_stats_t dsp;
+
+    /**
+     * Heap usage while the learning blocks ran (over all blocks), including the tensor arena
+     */
+    ei_mem_stage_stats_t learning;
+
+    /**
+     * Heap usage while the post-processing blocks ran
+     */
+    ei_mem_stage_stats_t postprocessing;
+
+    /**
+     * Bytes of the tensor arena used by tensors, persistent and scratch buffers.
+     * Only filled in for EON compiled models.
+     */
+    size_t arena_used_bytes;
+
+    /**
+     * Size of the tensor arena (`kTensorArenaSize` for EON compiled models)
+     */
+    size_t arena_size_bytes;
+
+    /**
+     * Persistent buffers that did not fit in the tensor arena and were allocated on the heap
+     */
+    size_t arena_overflow_bytes;
+} ei_impulse_result_memory_t;
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
+
+/**
+ * @brief Holds the classification scores as the model output them, if the output is int8.
+ *
+ * Read them with `ei_classifier_top_k()` and `ei_classifier_score()` (classifier/ei_classifier_top_k.h).
+ */
+typedef struct {
+    /**
+     * Quantized score per label, value = (q - zero_point) * scale
+     */
+    int8_t value[EI_CLASSIFIER_LABEL_COUNT > 0 ? EI_CLASSIFIER_LABEL_COUNT : 1];
+
+    float zero_point;
+    float scale;
+
+    /**
+     * Number of labels in `value`, 0 if the scores did not come from an int8 output
+     */
+    uint16_t count;
+
+    /**
+     * Whether `classification[].value` holds the dequantized scores. Only false if
+     * `EI_CLASSIFIER_LAZY_DEQUANTIZE` is enabled and `ei_classifier_dequantize()` was not called.
+     */
+    bool dequantized;
+} ei_impulse_result_quantized_t;
+
+/**
+ * @brief Holds the slice rate of a `run_classifier_continuous()` call.
+ *
+ * All zero for `run_classifier()`.
+ */
+typedef struct {
+    /**
+     * Slices per model window the slice was classified at
+     */
+    uint32_t slices_per_model_window;
+
+    /**
+     * Slices per model window to capture the next slice at. Differs from
+     * `slices_per_model_window` when the adaptive rate policy of the stream changed it,
+     * the next slice then holds `raw sample count / next_slices_per_model_window` samples.
+     */
+    uint32_t next_slices_per_model_window;
+
+    /**
+     * RMS of the slice, only measured when the stream has an adaptive rate policy
+     */
+    float activity;
+} ei_impulse_result_continuous_t;
+
 /**
  * @brief Holds intermediate results of hr / hrv block
  *
@@ -288,6 +409,22 @@ typedef struct {
      * Timing information for the processing (DSP) and inference blocks.
      */
     ei_impulse_result_timing_t timing;
+
+    /**
+     * Classification scores in the quantized domain of an int8 output.
+     */
+    ei_impulse_result_quantized_t quantized;
+
+    /**
+     * Slice rate of continuous classification.
+     */
+    ei_impulse_result_continuous_t continuous;
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING || __DOXYGEN__
+    /**
+     * Heap usage per stage and tensor arena usage, if `EI_CLASSIFIER_MEMORY_ACCOUNTING` is enabled.
+     */
+    ei_impulse_result_memory_t memory;
+#endif
 #ifdef __cplusplus
     /**
      * Raw outputs from the neural network. The number of elements in this array is
@@ -0,0 +1,344 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_CONTINUOUS_SCHEDULER_H_
+#define _EI_CLASSIFIER_CONTINUOUS_SCHEDULER_H_
+
+/**
+ * Deadline-aware scheduling of continuous classification.
+ *
+ * The capture side (I2S task, DMA callback) pushes samples into the scheduler's
+ * buffer with ei_scheduler_push(), or converts straight into it with
+ * ei_scheduler_reserve() / ei_scheduler_commit(). The classification loop calls
+ * ei_scheduler_run() whenever it is free. Every slice has one slice period (slice size / sampling
+ * frequency) to go through DSP and inference; a run that takes longer than the audio
+ * it processed is a deadline miss. Slices that piled up meanwhile are handled by the
+ * overload policy instead of letting the buffer overrun:
+ *
+ * - EI_SCHEDULER_SKIP_INFERENCE runs the DSP on every pending slice, so the rolling
+ *   features and the audio frame stay exactly as without overload, and the model
+ *   only on the newest one.
+ * - EI_SCHEDULER_COALESCE runs the DSP once over the pending slices together (at most
+ *   one slice short of a window) and the model once.
+ * - EI_SCHEDULER_DROP throws the older pending slices away and classifies the newest,
+ *   the features then jump over the dropped audio.
+ *
+ * When the buffer is full anyway, ei_scheduler_push() refuses the new samples. Both
+ * kinds of lost audio are counted in ei_scheduler_stats_t.
+ *
+ * One producer and one consumer may use a scheduler at the same time.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+#if EIDSP_SIGNAL_C_FN_POINTER == 0
+
+typedef enum {
+    EI_SCHEDULER_SKIP_INFERENCE = 0,
+    EI_SCHEDULER_COALESCE = 1,
+    EI_SCHEDULER_DROP = 2
+} ei_scheduler_overload_policy_t;
+
+typedef struct {
+    uint32_t runs;                  // ei_scheduler_run() calls that processed audio
+    uint32_t slices;                // slices that went through the DSP
+    uint32_t inferences;            // runs that classified a full window
+    uint32_t deadline_misses;       // runs that took longer than the audio they processed
+    uint32_t skipped_inferences;    // slices that only went through the DSP (SKIP_INFERENCE)
+    uint32_t coalesced_slices;      // slices processed together with others (COALESCE)
+    uint32_t dropped_samples;       // samples thrown away unprocessed (DROP)
+    uint32_t overrun_samples;       // samples ei_scheduler_push() refused on a full buffer
+    uint32_t max_backlog_samples;   // most samples waiting at the start of a run
+    uint64_t last_busy_us;          // DSP + inference time of the last run
+    uint64_t max_busy_us;
+    uint64_t avg_slice_busy_us;     // per slice, moving average over ~8 runs
+} ei_scheduler_stats_t;
+
+typedef struct {
+    ei_continuous_ctx_t *ctx;
+    int16_t *buffer;
+    uint32_t capacity;
+    std::atomic<uint32_t> write_ix;
+    std::atomic<uint32_t> read_ix;
+    std::atomic<uint32_t> overrun_samples;
+    ei_scheduler_overload_policy_t policy;
+    ei_scheduler_stats_t stats;
+} ei_continuous_scheduler_t;
+
+/**
+ * Set up a scheduler for a stream set up with run_classifier_init(ctx, handle).
+ * buffer holds capacity samples and is owned by the caller; one sample of it stays
+ * unused, so size it at least a slice above the longest run expected.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_scheduler_init(ei_continuous_scheduler_t *sched,
+                                                                  ei_continuous_ctx_t *ctx,
+                                                                  int16_t *buffer,
+                                                                  uint32_t capacity,
+                                                                  ei_scheduler_overload_policy_t policy)
+{
+    if ((sched == nullptr) || (ctx == nullptr) || (ctx->handle == nullptr) || (buffer == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    const ei_impulse_t *impulse = ctx->handle->impulse;
+    const uint32_t slice_values = run_classifier_get_slice_size(ctx) * impulse->raw_samples_per_frame;
+    if (capacity <= slice_values) {
+        ei_printf("ERR: Scheduler buffer of %u samples does not hold a slice of %u samples\n",
+            (unsigned)capacity, (unsigned)slice_values);
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    sched->ctx = ctx;
+    sched->buffer = buffer;
+    sched->capacity = capacity;
+    sched->write_ix.store(0);
+    sched->read_ix.store(0);
+    sched->overrun_samples.store(0);
+    sched->policy = policy;
+    memset(&sched->stats, 0, sizeof(sched->stats));
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Samples waiting in the buffer
+ */
+__attribute__((unused)) static uint32_t ei_scheduler_pending(ei_continuous_scheduler_t *sched)
+{
+    uint32_t w = sched->write_ix.load(std::memory_order_acquire);
+    uint32_t r = sched->read_ix.load(std::memory_order_acquire);
+    return (w + sched->capacity - r) % sched->capacity;
+}
+
+/**
+ * Add captured samples (producer side). Returns how many were taken, the rest did not
+ * fit and is counted as overrun.
+ */
+__attribute__((unused)) static size_t ei_scheduler_push(ei_continuous_scheduler_t *sched,
+                                                        const int16_t *samples,
+                                                        size_t count)
+{
+    const uint32_t w = sched->write_ix.load(std::memory_order_relaxed);
+    const uint32_t r = sched->read_ix.load(std::memory_order_acquire);
+    const uint32_t space = sched->capacity - 1 - (w + sched->capacity - r) % sched->capacity;
+
+    const uint32_t n = count < space ? (uint32_t)count : space;
+    if (n < count) {
+        sched->overrun_samples.fetch_add((uint32_t)(count - n), std::memory_order_relaxed);
+    }
+
+    const uint32_t first = std::min(n, sched->capacity - w);
+    memcpy(sched->buffer + w, samples, first * sizeof(int16_t));
+    memcpy(sched->buffer, samples + first, (n - first) * sizeof(int16_t));
+
+    sched->write_ix.store((w + n) % sched->capacity, std::memory_order_release);
+    return n;
+}
+
+/**
+ * Zero-copy variant of ei_scheduler_push() (producer side). Sets *dest to the write
+ * position and returns how many free samples follow it without wrapping around. Write
+ * into them, then hand them over with ei_scheduler_commit(); reserve again for the
+ * part after the wrap.
+ */
+__attribute__((unused)) static uint32_t ei_scheduler_reserve(ei_continuous_scheduler_t *sched, int16_t **dest)
+{
+    const uint32_t w = sched->write_ix.load(std::memory_order_relaxed);
+    const uint32_t r = sched->read_ix.load(std::memory_order_acquire);
+    const uint32_t space = sched->capacity - 1 - (w + sched->capacity - r) % sched->capacity;
+
+    *dest = sched->buffer + w;
+    return std::min(space, sched->capacity - w);
+}
+
+/**
+ * Hand over written samples reserved with ei_scheduler_reserve(). refused counts
+ * captured samples that did not fit as overrun, like ei_scheduler_push() does.
+ */
+__attribute__((unused)) static void ei_scheduler_commit(ei_continuous_scheduler_t *sched, uint32_t written, uint32_t refused = 0)
+{
+    if (refused > 0) {
+        sched->overrun_samples.fetch_add(refused, std::memory_order_relaxed);
+    }
+    const uint32_t w = sched->write_ix.load(std::memory_order_relaxed);
+    sched->write_ix.store((w + written) % sched->capacity, std::memory_order_release);
+}
+
+/**
+ * Time one slice may take, in microseconds
+ */
+__attribute__((unused)) static uint64_t ei_scheduler_slice_deadline_us(ei_continuous_scheduler_t *sched)
+{
+    const ei_impulse_t *impulse = sched->ctx->handle->impulse;
+    return (uint64_t)(run_classifier_get_slice_size(sched->ctx) * 1000000.0 / impulse->frequency);
+}
+
+/**
+ * Counters so far
+ */
+__attribute__((unused)) static void ei_scheduler_get_stats(ei_continuous_scheduler_t *sched, ei_scheduler_stats_t *stats)
+{
+    *stats = sched->stats;
+    stats->overrun_samples = sched->overrun_samples.load(std::memory_order_relaxed);
+}
+
+/**
+ * Run the next length values of the buffer through the stream
+ */
+static EI_IMPULSE_ERROR ei_scheduler_process(ei_continuous_scheduler_t *sched,
+                                             uint32_t length,
+                                             ei_impulse_result_t *result,
+                                             bool infer,
+                                             bool debug)
+{
+    const uint32_t start = sched->read_ix.load(std::memory_order_relaxed);
+    const int16_t *buffer = sched->buffer;
+    const uint32_t capacity = sched->capacity;
+
+    signal_t signal;
+    signal.total_length = length;
+    signal.get_data = [buffer, capacity, start](size_t offset, size_t len, float *out_ptr) {
+        size_t ix = (start + offset) % capacity;
+        for (size_t i = 0; i < len; i++) {
+            out_ptr[i] = (float)buffer[ix];
+            if (++ix == capacity) {
+                ix = 0;
+            }
+        }
+        return 0;
+    };
+
+    EI_IMPULSE_ERROR res = process_impulse_continuous(sched->ctx->handle, sched->ctx, &signal, result, debug, infer);
+
+    sched->read_ix.store((start + length) % capacity, std::memory_order_release);
+    return res;
+}
+
+/**
+ * Process what is in the buffer (consumer side). Does nothing when less than a slice
+ * is waiting. *classified tells whether result holds a classification of a full window.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_scheduler_run(ei_continuous_scheduler_t *sched,
+                                                                 ei_impulse_result_t *result,
+                                                                 bool *classified,
+                                                                 bool debug = false)
+{
+    if ((sched == nullptr) || (sched->ctx == nullptr) || (result == nullptr) || (classified == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    *classified = false;
+
+    ei_continuous_ctx_t *ctx = sched->ctx;
+    const ei_impulse_t *impulse = ctx->handle->impulse;
+    // the slice size can change after every slice when the stream has a rate policy
+    uint32_t slice_values = run_classifier_get_slice_size(ctx) * impulse->raw_samples_per_frame;
+    uint32_t pending = ei_scheduler_pending(sched);
+    if (pending < slice_values) {
+        return EI_IMPULSE_OK;
+    }
+    if (pending > sched->stats.max_backlog_samples) {
+        sched->stats.max_backlog_samples = pending;
+    }
+
+    const uint64_t start_us = ei_read_timer_us();
+    uint32_t processed = 0;
+    uint32_t slices = 0;
+    EI_IMPULSE_ERROR res = EI_IMPULSE_OK;
+
+    if (pending >= 2 * slice_values && sched->policy == EI_SCHEDULER_SKIP_INFERENCE) {
+        // everything but the newest slice only updates the window. Only the samples that
+        // were waiting on entry count, so a producer that outpaces the DSP cannot keep
+        // this loop (and the inference after it) from ever finishing.
+        while (pending >= 2 * slice_values) {
+            res = ei_scheduler_process(sched, slice_values, result, false, debug);
+            if (res != EI_IMPULSE_OK) {
+                return res;
+            }
+            processed += slice_values;
+            pending -= slice_values;
+            slices++;
+            sched->stats.skipped_inferences++;
+            slice_values = run_classifier_get_slice_size(ctx) * impulse->raw_samples_per_frame;
+        }
+    }
+    else if (pending >= 2 * slice_values && sched->policy == EI_SCHEDULER_COALESCE) {
+        // a longer slice rolls the window by more rows, it has to stay shorter than the window
+        uint32_t max_slices = continuous_slices_per_model_window(ctx, impulse) - 1;
+        uint32_t n = std::min(pending / slice_values, max_slices > 1 ? max_slices : 1);
+        slice_values *= n;
+        if (n > 1) {
+            slices += n - 1;
+            sched->stats.coalesced_slices += n;
+        }
+    }
+    else if (pending >= 2 * slice_values && sched->policy == EI_SCHEDULER_DROP) {
+        const uint32_t drop = (pending / slice_values - 1) * slice_values;
+        sched->read_ix.store((sched->read_ix.load(std::memory_order_relaxed) + drop) % sched->capacity,
+            std::memory_order_release);
+        sched->stats.dropped_samples += drop;
+    }
+
+    // a rate policy may have grown the slice past what is left, it waits for the next run then
+    if (pending >= slice_values) {
+        res = ei_scheduler_process(sched, slice_values, result, true, debug);
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+        processed += slice_values;
+        slices++;
+        *classified = ctx->features_written >= impulse->nn_input_frame_size;
+    }
+
+    const uint64_t busy_us = ei_read_timer_us() - start_us;
+    const uint64_t deadline_us = (uint64_t)((double)processed / impulse->raw_samples_per_frame * 1000000.0 / impulse->frequency);
+    const int64_t slice_busy_us = (int64_t)(busy_us / slices);
+
+    sched->stats.runs++;
+    sched->stats.slices += slices;
+    sched->stats.inferences += *classified ? 1 : 0;
+    sched->stats.deadline_misses += busy_us > deadline_us ? 1 : 0;
+    sched->stats.last_busy_us = busy_us;
+    sched->stats.max_busy_us = std::max(sched->stats.max_busy_us, busy_us);
+    sched->stats.avg_slice_busy_us = sched->stats.runs == 1 ? (uint64_t)slice_busy_us :
+        (uint64_t)((int64_t)sched->stats.avg_slice_busy_us + (slice_busy_us - (int64_t)sched->stats.avg_slice_busy_us) / 8);
+
+    return EI_IMPULSE_OK;
+}
+
+#endif // EIDSP_SIGNAL_C_FN_POINTER == 0
+
+#endif // _EI_CLASSIFIER_CONTINUOUS_SCHEDULER_H_
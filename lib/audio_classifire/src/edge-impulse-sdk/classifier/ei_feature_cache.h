@@ -0,0 +1,314 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_FEATURE_CACHE_H_
+#define _EI_CLASSIFIER_FEATURE_CACHE_H_
+
+/**
+ * Feature cache shared between impulse handles.
+ *
+ * Impulses that run the same DSP block (same extract function and settings, the
+ * block id and named axes do not count) over the same window compute the same
+ * features. Point the handles at one cache, and call ei_feature_cache_set_window()
+ * whenever a new window comes in; the first impulse computes the features, the
+ * others copy them. Hits are counted in result.timing.dsp_cache_hits.
+ *
+ * The caller owns window identity: features are only reused while the window id
+ * stays the same, so bump it for every new buffer (0 disables lookups). Blocks
+ * that keep state (factory) and unknown DSP blocks are never cached.
+ *
+ * The hash key only picks the entry. A hit also needs the same window id and a
+ * block with the same extract function, settings, axes and sampling frequency, so
+ * a hash collision can't hand out the features of another block. With
+ * EI_CLASSIFIER_TFLITE_REENTRANT the handles may run on several threads, and the
+ * cache is guarded by a mutex.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+
+#if EI_CLASSIFIER_FEATURE_CACHE
+
+#include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+#include <mutex>
+#define EI_FEATURE_CACHE_LOCK(cache) std::lock_guard<std::mutex> ei_feature_cache_guard((cache)->lock)
+#else
+#define EI_FEATURE_CACHE_LOCK(cache)
+#endif
+
+typedef struct {
+    uint64_t key;           // ei_feature_cache_key() of the block, 0 if unused
+    uint32_t window_id;     // window the features were computed for
+    size_t features_count;
+    float *features;        // ei_malloc'ed, kept across windows to avoid reallocating
+    size_t capacity;
+    // the block the features belong to, checked on a hit
+    extract_fn_t extract_fn;
+    const void *config;
+    const EI_CLASSIFIER_DSP_AXES_INDEX_TYPE *axes;
+    uint32_t axes_size;
+    float frequency;
+    uint32_t raw_samples_per_frame;
+} ei_feature_cache_entry_t;
+
+typedef struct ei_feature_cache {
+    ei_feature_cache_entry_t entries[EI_CLASSIFIER_FEATURE_CACHE_ENTRIES];
+    uint32_t window_id;     // current window, 0 = no caching
+    uint32_t next;          // entry replaced on the next miss
+    uint32_t hits;
+    uint32_t misses;
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+    std::mutex lock;
+#endif
+} ei_feature_cache_t;
+
+__attribute__((unused)) static void ei_feature_cache_init(ei_feature_cache_t *cache) {
+    EI_FEATURE_CACHE_LOCK(cache);
+    memset(cache->entries, 0, sizeof(cache->entries));
+    cache->window_id = 0;
+    cache->next = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+__attribute__((unused)) static void ei_feature_cache_free(ei_feature_cache_t *cache) {
+    EI_FEATURE_CACHE_LOCK(cache);
+    for (size_t ix = 0; ix < EI_CLASSIFIER_FEATURE_CACHE_ENTRIES; ix++) {
+        ei_free(cache->entries[ix].features);
+    }
+    memset(cache->entries, 0, sizeof(cache->entries));
+    cache->window_id = 0;
+    cache->next = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+/**
+ * Start a new window, features of other windows are no longer returned
+ */
+__attribute__((unused)) static void ei_feature_cache_set_window(ei_feature_cache_t *cache, uint32_t window_id) {
+    EI_FEATURE_CACHE_LOCK(cache);
+    cache->window_id = window_id;
+}
+
+static inline uint64_t ei_feature_cache_hash(uint64_t hash, const void *data, size_t size) {
+    // FNV-1a
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t ix = 0; ix < size; ix++) {
+        hash ^= bytes[ix];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// the settings of each block type that change its features
+#define EI_FEATURE_CACHE_MFE_FIELDS(X) \
+    X(implementation_version) X(frame_length) X(frame_stride) X(num_filters) X(fft_length) \
+    X(low_frequency) X(high_frequency) X(win_size) X(noise_floor_db)
+#define EI_FEATURE_CACHE_MFCC_FIELDS(X) \
+    X(implementation_version) X(num_cepstral) X(frame_length) X(frame_stride) X(num_filters) \
+    X(fft_length) X(win_size) X(low_frequency) X(high_frequency) X(pre_cof) X(pre_shift)
+#define EI_FEATURE_CACHE_SPECTROGRAM_FIELDS(X) \
+    X(implementation_version) X(frame_length) X(frame_stride) X(fft_length) X(noise_floor_db)
+
+#define EI_FEATURE_CACHE_HASH_FIELD(field) hash = ei_feature_cache_hash(hash, &config->field, sizeof(config->field));
+#define EI_FEATURE_CACHE_SAME_FIELD(field) && memcmp(&a->field, &b->field, sizeof(a->field)) == 0
+
+/**
+ * Key of a DSP block: extract function, the settings that change the features,
+ * the selected axes and the sampling frequency. Returns 0 if the block can't be cached.
+ */
+__attribute__((unused)) static uint64_t ei_feature_cache_key(const ei_impulse_t *impulse, const ei_model_dsp_t *block) {
+    if (block->factory || !block->config) {
+        return 0;
+    }
+
+    uint64_t hash = 14695981039346656037ULL;
+    void *extract_fn = (void *)block->extract_fn;
+    hash = ei_feature_cache_hash(hash, &extract_fn, sizeof(extract_fn));
+
+    if (block->extract_fn == extract_mfe_features) {
+        const ei_dsp_config_mfe_t *config = (const ei_dsp_config_mfe_t *)block->config;
+        EI_FEATURE_CACHE_MFE_FIELDS(EI_FEATURE_CACHE_HASH_FIELD)
+    }
+    else if (block->extract_fn == extract_mfcc_features) {
+        const ei_dsp_config_mfcc_t *config = (const ei_dsp_config_mfcc_t *)block->config;
+        EI_FEATURE_CACHE_MFCC_FIELDS(EI_FEATURE_CACHE_HASH_FIELD)
+    }
+    else if (block->extract_fn == extract_spectrogram_features) {
+        const ei_dsp_config_spectrogram_t *config = (const ei_dsp_config_spectrogram_t *)block->config;
+        EI_FEATURE_CACHE_SPECTROGRAM_FIELDS(EI_FEATURE_CACHE_HASH_FIELD)
+    }
+    else {
+        return 0;
+    }
+
+    hash = ei_feature_cache_hash(hash, block->axes, block->axes_size * sizeof(block->axes[0]));
+    hash = ei_feature_cache_hash(hash, &block->n_output_features, sizeof(block->n_output_features));
+    hash = ei_feature_cache_hash(hash, &impulse->raw_samples_per_frame, sizeof(impulse->raw_samples_per_frame));
+    hash = ei_feature_cache_hash(hash, &impulse->frequency, sizeof(impulse->frequency));
+
+    return hash ? hash : 1;
+}
+
+/**
+ * Whether the entry holds the features of this block, compares what the key hashes
+ */
+static bool ei_feature_cache_same_block(const ei_feature_cache_entry_t *entry, const ei_impulse_t *impulse,
+                                        const ei_model_dsp_t *block) {
+    if (entry->extract_fn != block->extract_fn || entry->axes_size != block->axes_size ||
+        entry->frequency != impulse->frequency || entry->raw_samples_per_frame != impulse->raw_samples_per_frame) {
+        return false;
+    }
+    if (entry->axes != block->axes &&
+        memcmp(entry->axes, block->axes, block->axes_size * sizeof(block->axes[0])) != 0) {
+        return false;
+    }
+    if (entry->config == block->config) {
+        return true;
+    }
+
+    // separately generated impulses have their own config with the same settings
+    if (block->extract_fn == extract_mfe_features) {
+        const ei_dsp_config_mfe_t *a = (const ei_dsp_config_mfe_t *)entry->config;
+        const ei_dsp_config_mfe_t *b = (const ei_dsp_config_mfe_t *)block->config;
+        return true EI_FEATURE_CACHE_MFE_FIELDS(EI_FEATURE_CACHE_SAME_FIELD);
+    }
+    if (block->extract_fn == extract_mfcc_features) {
+        const ei_dsp_config_mfcc_t *a = (const ei_dsp_config_mfcc_t *)entry->config;
+        const ei_dsp_config_mfcc_t *b = (const ei_dsp_config_mfcc_t *)block->config;
+        return true EI_FEATURE_CACHE_MFCC_FIELDS(EI_FEATURE_CACHE_SAME_FIELD);
+    }
+    if (block->extract_fn == extract_spectrogram_features) {
+        const ei_dsp_config_spectrogram_t *a = (const ei_dsp_config_spectrogram_t *)entry->config;
+        const ei_dsp_config_spectrogram_t *b = (const ei_dsp_config_spectrogram_t *)block->config;
+        return true EI_FEATURE_CACHE_SPECTROGRAM_FIELDS(EI_FEATURE_CACHE_SAME_FIELD);
+    }
+    return false;
+}
+
+/**
+ * Copy the cached features of the block for the current window into the matrix
+ *
+ * @return true on a hit
+ */
+__attribute__((unused)) static bool ei_feature_cache_find(ei_feature_cache_t *cache, uint64_t key,
+                                                          const ei_impulse_t *impulse, const ei_model_dsp_t *block,
+                                                          ei::matrix_t *matrix) {
+    if (key == 0) {
+        return false;
+    }
+
+    EI_FEATURE_CACHE_LOCK(cache);
+    if (cache->window_id == 0) {
+        return false;
+    }
+
+    size_t features_count = matrix->rows * matrix->cols;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_FEATURE_CACHE_ENTRIES; ix++) {
+        ei_feature_cache_entry_t *entry = &cache->entries[ix];
+        if (entry->key == key && entry->window_id == cache->window_id && entry->features_count == features_count &&
+            ei_feature_cache_same_block(entry, impulse, block)) {
+            memcpy(matrix->buffer, entry->features, features_count * sizeof(float));
+            cache->hits++;
+            return true;
+        }
+    }
+
+    cache->misses++;
+    return false;
+}
+
+/**
+ * Remember the features of a block for the current window
+ */
+__attribute__((unused)) static void ei_feature_cache_store(ei_feature_cache_t *cache, uint64_t key,
+                                                           const ei_impulse_t *impulse, const ei_model_dsp_t *block,
+                                                           const ei::matrix_t *matrix) {
+    if (key == 0) {
+        return;
+    }
+
+    EI_FEATURE_CACHE_LOCK(cache);
+    if (cache->window_id == 0) {
+        return;
+    }
+
+    // reuse the entry of this block if there is one, so a block never holds two
+    ei_feature_cache_entry_t *entry = nullptr;
+    for (size_t ix = 0; ix < EI_CLASSIFIER_FEATURE_CACHE_ENTRIES; ix++) {
+        if (cache->entries[ix].key == key) {
+            entry = &cache->entries[ix];
+            break;
+        }
+    }
+    if (!entry) {
+        entry = &cache->entries[cache->next];
+        cache->next = (cache->next + 1) % EI_CLASSIFIER_FEATURE_CACHE_ENTRIES;
+    }
+
+    size_t features_count = matrix->rows * matrix->cols;
+    if (entry->capacity < features_count) {
+        ei_free(entry->features);
+        entry->features = (float *)ei_malloc(features_count * sizeof(float));
+        entry->capacity = entry->features ? features_count : 0;
+        if (!entry->features) {
+            entry->key = 0;
+            return;
+        }
+    }
+
+    memcpy(entry->features, matrix->buffer, features_count * sizeof(float));
+    entry->key = key;
+    entry->window_id = cache->window_id;
+    entry->features_count = features_count;
+    entry->extract_fn = block->extract_fn;
+    entry->config = block->config;
+    entry->axes = block->axes;
+    entry->axes_size = block->axes_size;
+    entry->frequency = impulse->frequency;
+    entry->raw_samples_per_frame = impulse->raw_samples_per_frame;
+}
+
+#undef EI_FEATURE_CACHE_HASH_FIELD
+#undef EI_FEATURE_CACHE_SAME_FIELD
+
+#endif // EI_CLASSIFIER_FEATURE_CACHE
+
+#endif // _EI_CLASSIFIER_FEATURE_CACHE_H_
@@ -0,0 +1,245 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_CLASSIFIER_MEMORY_PLAN_H_
+#define _EI_CLASSIFIER_MEMORY_PLAN_H_
+
+/**
+ * Unified memory plan for impulses with a single EON compiled learning block.
+ *
+ * The DSP feature matrix and the tensor arena are placed in one statically sized
+ * region. Three stages are planned:
+ *
+ *   0 (DSP)       the DSP blocks write the float features
+ *   1 (handoff)   the model is initialized (persistent buffers only) and the
+ *                 features are quantized into the input tensor
+ *   2 (invoke)    the arena tensors are live, the features are dead
+ *
+ * The arena is placed so that its input tensor lies at or after the last quarter
+ * of the features (the last N bytes for int8 input), and the features are
+ * quantized back to front. Every byte written at the handoff was then already
+ * read. The arena tensors below the input overlap the features but are only
+ * touched at invoke, and the persistent buffers sit past the end of the features.
+ * The region size is a compile time constant (ei_memory_plan_region_size), and the
+ * greedy planner (tensorflow/lite/micro/memory_planner) double checks the
+ * lifetimes on first use. The arena offsets come from the tensor table the
+ * exporter emits next to the model (ei_arena_plan.h).
+ *
+ * The peak can't go below the float features, which are all live while they are
+ * quantized. Going further means quantizing every DSP frame into the input tensor
+ * as it is produced, so the float matrix never exists as a whole. The peak would
+ * then be about the arena plus one frame, but the DSP blocks would have to write
+ * quantized output.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+
+#include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/dsp/returntypes.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+
+typedef struct {
+    size_t features_bytes;      // float feature matrix handed to the learning block
+    size_t arena_bytes;         // tensor arena of the compiled model
+    size_t arena_tensor_bytes;  // end of the non-persistent tensors in the arena
+    size_t input_offset;        // input tensor, relative to the arena
+    size_t input_bytes;
+} ei_memory_plan_layout_t;
+
+typedef enum {
+    EI_MEMORY_PLAN_STAGE_DSP = 0,
+    EI_MEMORY_PLAN_STAGE_HANDOFF = 1,
+    EI_MEMORY_PLAN_STAGE_INVOKE = 2,
+} ei_memory_plan_stage_t;
+
+constexpr size_t ei_memory_plan_align(size_t bytes) {
+    return (bytes + 15) & ~(size_t)15;
+}
+
+/**
+ * Offset of the arena in the region, the features always start at 0.
+ */
+constexpr size_t ei_memory_plan_arena_offset(const ei_memory_plan_layout_t &layout) {
+    return layout.features_bytes - layout.input_bytes > layout.input_offset ?
+        ei_memory_plan_align(layout.features_bytes - layout.input_bytes - layout.input_offset) : 0;
+}
+
+/**
+ * Peak memory of the plan, this is the size of the region.
+ */
+constexpr size_t ei_memory_plan_region_size(const ei_memory_plan_layout_t &layout) {
+    return ei_memory_plan_arena_offset(layout) + layout.arena_bytes > layout.features_bytes ?
+        ei_memory_plan_arena_offset(layout) + layout.arena_bytes : ei_memory_plan_align(layout.features_bytes);
+}
+
+/**
+ * The in place handoff is only valid for int8 / uint8 input (4 feature bytes per
+ * input byte) or float input (1:1), and only if no persistent buffer can land on
+ * the features.
+ */
+constexpr bool ei_memory_plan_is_valid(const ei_memory_plan_layout_t &layout) {
+    return (layout.features_bytes == layout.input_bytes * 4 || layout.features_bytes == layout.input_bytes) &&
+        layout.input_offset + layout.input_bytes <= layout.arena_tensor_bytes &&
+        layout.arena_tensor_bytes <= layout.arena_bytes;
+}
+
+typedef struct {
+    uint8_t *region;
+    size_t region_bytes;
+    ei_memory_plan_layout_t layout;
+    size_t arena_offset;
+    size_t peak_bytes;
+    bool arena_in_use;
+    bool ready;
+} ei_memory_plan_t;
+
+__attribute__((unused)) static ei_memory_plan_t *ei_memory_plan_get() {
+    static ei_memory_plan_t plan;
+    return &plan;
+}
+
+/**
+ * Check the layout against its lifetimes and activate the plan. Safe to call on
+ * every inference, only the first call does any work.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_memory_plan_init(
+    const ei_memory_plan_layout_t *layout,
+    uint8_t *region,
+    size_t region_bytes)
+{
+    ei_memory_plan_t *plan = ei_memory_plan_get();
+    if (plan->ready) {
+        return EI_IMPULSE_OK;
+    }
+
+    size_t arena_offset = ei_memory_plan_arena_offset(*layout);
+    if (!ei_memory_plan_is_valid(*layout) || ((uintptr_t)region & 15) ||
+            region_bytes < ei_memory_plan_region_size(*layout)) {
+        ei_printf("ERR: Invalid unified memory plan\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    const int buffer_count = 3;
+    uint8_t planner_scratch[buffer_count * 64] __attribute__((aligned(8)));
+    if (tflite::GreedyMemoryPlanner::per_buffer_size() * buffer_count > sizeof(planner_scratch)) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    tflite::GreedyMemoryPlanner planner;
+    planner.Init(planner_scratch, sizeof(planner_scratch));
+    planner.AddBuffer((int)layout->features_bytes,
+        EI_MEMORY_PLAN_STAGE_DSP, EI_MEMORY_PLAN_STAGE_HANDOFF, 0);
+    planner.AddBuffer((int)layout->arena_tensor_bytes,
+        EI_MEMORY_PLAN_STAGE_INVOKE, EI_MEMORY_PLAN_STAGE_INVOKE, (int)arena_offset);
+    planner.AddBuffer((int)(layout->arena_bytes - layout->arena_tensor_bytes),
+        EI_MEMORY_PLAN_STAGE_HANDOFF, EI_MEMORY_PLAN_STAGE_INVOKE, (int)(arena_offset + layout->arena_tensor_bytes));
+
+    if (planner.DoAnyBuffersOverlap()) {
+        ei_printf("ERR: Unified memory plan has overlapping buffers\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    plan->region = region;
+    plan->region_bytes = region_bytes;
+    plan->layout = *layout;
+    plan->arena_offset = arena_offset;
+    plan->peak_bytes = planner.GetMaximumMemorySize();
+    plan->arena_in_use = false;
+    plan->ready = true;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Buffer for the features of all DSP blocks, or nullptr if they do not fit the
+ * plan (the caller then allocates them as usual).
+ */
+__attribute__((unused)) static float *ei_memory_plan_features(size_t features_count) {
+    ei_memory_plan_t *plan = ei_memory_plan_get();
+    if (!plan->ready || plan->arena_in_use || features_count * sizeof(float) != plan->layout.features_bytes) {
+        return nullptr;
+    }
+    return (float*)plan->region;
+}
+
+/**
+ * Allocator for model_init. Hands out the planned arena slot (not zeroed, the
+ * arena only zeroes its persistent buffers) and falls back to the heap for
+ * any other request.
+ */
+__attribute__((unused)) static void *ei_memory_plan_arena_alloc(size_t align, size_t size) {
+    ei_memory_plan_t *plan = ei_memory_plan_get();
+    if (!plan->ready || plan->arena_in_use || size != plan->layout.arena_bytes || align > 16) {
+        return ei_aligned_calloc(align, size);
+    }
+    plan->arena_in_use = true;
+    return plan->region + plan->arena_offset;
+}
+
+__attribute__((unused)) static void ei_memory_plan_arena_free(void *ptr) {
+    ei_memory_plan_t *plan = ei_memory_plan_get();
+    if (plan->ready && ptr == plan->region + plan->arena_offset) {
+        plan->arena_in_use = false;
+        return;
+    }
+    ei_aligned_free(ptr);
+}
+
+/**
+ * Whether the input tensor aliases the features at the planned offset, i.e. the
+ * features have to be quantized in place (back to front).
+ */
+__attribute__((unused)) static bool ei_memory_plan_is_handoff(const TfLiteTensor *input, const float *features) {
+    ei_memory_plan_t *plan = ei_memory_plan_get();
+    return plan->ready && plan->arena_in_use &&
+        features == (const float*)plan->region &&
+        input->data.raw == (char*)(plan->region + plan->arena_offset + plan->layout.input_offset) &&
+        input->bytes == plan->layout.input_bytes;
+}
+
+/**
+ * Peak bytes of the plan (the region size), 0 before the first inference.
+ */
+__attribute__((unused)) static size_t ei_memory_plan_peak_bytes() {
+    return ei_memory_plan_get()->peak_bytes;
+}
+
+#endif // EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+
+#endif // _EI_CLASSIFIER_MEMORY_PLAN_H_
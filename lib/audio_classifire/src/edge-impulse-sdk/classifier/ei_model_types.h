@@ -37,6 +37,7 @@
 
 #include <stdint.h>
 
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
 #include "edge-impulse-sdk/dsp/ei_dsp_handle.h"
 #include "edge-impulse-sdk/dsp/numpy.hpp"
@@ -124,6 +125,21 @@ typedef struct {
     uint32_t suppression_flags;
 } ei_performance_calibration_config_t;
 
+#define EI_SMOOTHING_EXPONENTIAL               0
+#define EI_SMOOTHING_WINDOW                    1
+
+typedef struct {
+    uint8_t mode;                           // EI_SMOOTHING_EXPONENTIAL or EI_SMOOTHING_WINDOW
+    float alpha;                            // weight of the newest result (exponential)
+    uint16_t window_size;                   // results averaged (window)
+    float onset_threshold;                  // smoothed score that raises an event
+    float release_threshold;                // score to fall below before the label can raise another
+    uint32_t suppression_ms;                // no new event of a label for this long after one
+    const uint32_t *label_suppression_ms;   // per label instead of suppression_ms, or NULL
+    uint32_t ignore_flags;                  // labels (bit per label) that never raise events
+    bool replace_scores;                    // write the smoothed scores into result->classification
+} ei_smoothing_config_t;
+
 typedef struct {
     uint16_t implementation_version;
     uint32_t keep_grace;
@@ -250,6 +266,45 @@ typedef struct {
     size_t arena_size;
 } ei_config_tflite_graph_t;
 
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+namespace tflite {
+class MicroProfilerInterface;
+}
+
+/** Per-node statistics collected by EON compiled models */
+typedef struct {
+    const char *tag;            // "<op>/<node>" or "<op>:<variant>/<node>", also the profiler event tag
+    const char *op;             // registered kernel, e.g. CONV_2D or FULLY_CONNECTED_1200_512
+    uint32_t invoke_count;
+    uint64_t total_us;
+    uint32_t last_us;
+    uint32_t max_us;
+    size_t output_bytes;        // activation bytes written by the node
+    size_t persistent_bytes;    // arena bytes requested by init / prepare
+    size_t scratch_bytes;       // arena bytes requested as scratch buffers
+    size_t overflow_bytes;      // persistent bytes that did not fit and went to the heap
+} ei_tflite_layer_stats_t;
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+/**
+ * Early exit head of an EON compiled model: the activations it reads are averaged
+ * over all rows of `channels` values, then a linear layer and softmax give one
+ * score per model output. The model exits if top score - second score >= margin.
+ */
+typedef struct {
+    uint16_t channels;
+    const float *weights;       // [outputs][channels]
+    const float *bias;          // [outputs], may be NULL
+    float margin;
+} ei_tflite_early_exit_head_t;
+
+typedef struct {
+    uint32_t invokes;           // invokes that ran the head
+    uint32_t exits;             // of which exited through it
+} ei_tflite_early_exit_stats_t;
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
 /** Configuration for the tflite_eon.h */
 typedef struct {
     uint16_t implementation_version;
@@ -258,6 +313,30 @@ typedef struct {
     TfLiteStatus (*model_reset)(void (*free)(void* ptr));
     TfLiteStatus (*model_input)(int, TfLiteTensor*);
     TfLiteStatus (*model_output)(int, TfLiteTensor*);
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+    size_t (*model_layer_count)();
+    TfLiteStatus (*model_layer_stats)(void*, size_t, ei_tflite_layer_stats_t*);
+    void (*model_reset_layer_stats)(void*);
+    void (*model_set_profiler)(tflite::MicroProfilerInterface*);
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    void (*model_arena_usage)(size_t *used_bytes, size_t *arena_bytes, size_t *overflow_bytes);
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+    void* (*model_create)(void*(*alloc_fnc)(size_t, size_t), void (*free)(void* ptr));
+    TfLiteStatus (*model_instance_invoke)(void*);
+    TfLiteStatus (*model_instance_input)(void*, int, TfLiteTensor*);
+    TfLiteStatus (*model_instance_output)(void*, int, TfLiteTensor*);
+    TfLiteStatus (*model_destroy)(void*, void (*free)(void* ptr));
+#endif // EI_CLASSIFIER_TFLITE_REENTRANT
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+    TfLiteStatus (*model_set_early_exit)(const ei_tflite_early_exit_head_t*);
+    void (*model_early_exit_stats)(ei_tflite_early_exit_stats_t*);
+    void (*model_reset_early_exit_stats)();
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+    // optional, runs several inputs with one pass over the fully connected weights
+    TfLiteStatus (*model_invoke_batch)(void*, size_t, TfLiteStatus (*)(void*, size_t),
+                                       TfLiteStatus (*)(void*, size_t), void*);
 } ei_config_tflite_eon_graph_t;
 
 typedef struct {
@@ -413,6 +492,13 @@ public:
     }
 };
 
+#if EI_CLASSIFIER_FEATURE_CACHE
+struct ei_feature_cache;
+#endif
+#if EI_CLASSIFIER_CASCADE
+struct ei_cascade;
+#endif
+
 class ei_impulse_handle_t {
 public:
     ei_impulse_handle_t(const ei_impulse_t *impulse)
@@ -420,6 +506,14 @@ public:
     ei_impulse_state_t state;
     const ei_impulse_t *impulse;
     void** post_processing_state;
+#if EI_CLASSIFIER_FEATURE_CACHE
+    // shared with other handles to reuse their features, see ei_feature_cache.h
+    struct ei_feature_cache *feature_cache = nullptr;
+#endif
+#if EI_CLASSIFIER_CASCADE
+    // first stage that may stand in for a learning block, see ei_cascade.h
+    struct ei_cascade *cascade = nullptr;
+#endif
 };
 
 typedef struct {
@@ -39,12 +39,17 @@
 #include "model-parameters/model_metadata.h"
 
 #include "ei_run_dsp.h"
+#include "ei_feature_cache.h"
+#include "ei_cascade.h"
 #include "ei_classifier_types.h"
+#include "ei_classifier_top_k.h"
 #include "ei_signal_with_axes.h"
 #include "postprocessing/ei_postprocessing.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
 #include <memory>
 
 #if EI_CLASSIFIER_HAS_ANOMALY
@@ -104,9 +109,55 @@ EI_IMPULSE_ERROR ei_scale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmat
 EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmatrix);
 #endif // EI_CLASSIFIER_LOAD_IMAGE_SCALING
 
+/* Public types ------------------------------------------------------------ */
+
+/**
+ * @brief Adaptive slice rate of a continuous classification stream.
+ *
+ * Every slice whose RMS reaches `activity_threshold` puts the stream at `max_slices` per
+ * model window. After `hold_slices` slices in a row below `silence_threshold` the rate is
+ * halved, down to `min_slices`. Both rates must divide the raw sample count of the impulse.
+ * Set it with `run_classifier_set_rate_policy(ctx, policy)`.
+ */
+typedef struct {
+    uint32_t min_slices;
+    uint32_t max_slices;
+    float activity_threshold;
+    float silence_threshold;
+    uint32_t hold_slices;
+} ei_continuous_rate_policy_t;
+
+/**
+ * @brief State of one continuous classification stream.
+ *
+ * Holds everything `run_classifier_continuous()` carries from one slice to the next:
+ * the audio frame of the per-slice DSP blocks and the rolling feature matrix. Give every
+ * stream its own context to classify several streams in one process, the impulse and its
+ * weights stay shared. Every context also keeps its own state of the postprocessing blocks
+ * (e.g. posterior smoothing), so streams on one handle do not mix their results.
+ *
+ * The number of slices per model window defaults to `slices_per_model_window` of the
+ * impulse and can be changed between slices with `run_classifier_set_slices_per_model_window()`
+ * or by a rate policy. The rolling feature matrix and the audio frame carry over as is.
+ *
+ * Zero-initialize, then set it up with `run_classifier_init(ctx, handle)` and release it
+ * with `run_classifier_deinit(ctx)`.
+ */
+typedef struct {
+    ei_impulse_handle_t *handle;
+    ei_dsp_cont_state_t *dsp_state;
+    uint64_t features_written;
+    ei::matrix_t *features_matrix;
+    uint32_t slices_per_model_window; // 0 for the impulse's
+    const ei_continuous_rate_policy_t *rate_policy;
+    uint32_t quiet_slices;
+    void **post_processing_state;     // set up by run_classifier_init(ctx, handle), else the handle's
+} ei_continuous_ctx_t;
+
 /* Private variables ------------------------------------------------------- */
 
-static uint64_t classifier_continuous_features_written = 0;
+// stream used by run_classifier_continuous() without a context
+static ei_continuous_ctx_t ei_default_continuous_ctx = { nullptr, &ei_dsp_cont_default_state, 0, nullptr, 0, nullptr, 0, nullptr };
 
 /* Private functions ------------------------------------------------------- */
 
@@ -120,6 +171,8 @@ therefore changes are allowed. */
  */
 __attribute__((unused)) void display_results(ei_impulse_handle_t *handle, ei_impulse_result_t* result)
 {
+    ei_classifier_dequantize(result);
+
     // print the predictions
     ei_printf("Predictions (DSP: ");
     result->timing.dsp_us ? ei_printf_float((float)result->timing.dsp_us/1000) : ei_printf("%d", result->timing.dsp);
@@ -200,11 +253,21 @@ extern "C" EI_IMPULSE_ERROR run_inference(
     ei_impulse_result_t *result,
     bool debug = false)
 {
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_INFERENCE);
+    EI_MEM_STAGE(&result->memory.learning);
+
     auto& impulse = handle->impulse;
     for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
 
         ei_learning_block_t block = impulse->learning_blocks[ix];
 
+#if EI_CLASSIFIER_CASCADE
+        if (handle->cascade && ei_cascade_try_skip(handle->cascade, impulse, fmatrix, ix, result)) {
+            continue;
+        }
+        uint64_t block_start_us = ei_read_timer_us();
+#endif
+
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
         // we do not plan to have multiple dsp blocks with image
         // so just apply scaling to the first one
@@ -219,6 +282,12 @@ extern "C" EI_IMPULSE_ERROR run_inference(
             return res;
         }
 
+#if EI_CLASSIFIER_CASCADE
+        if (handle->cascade && block.blockId == handle->cascade->block_id) {
+            handle->cascade->full_us += ei_read_timer_us() - block_start_us;
+        }
+#endif
+
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
         // undo scaling
         scale_res = ei_unscale_fmatrix(&block, fmatrix[0].matrix);
@@ -251,6 +320,8 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
                                             ei_impulse_result_t *result,
                                             bool debug = false)
 {
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_RUN_CLASSIFIER);
+
     if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
         return EI_IMPULSE_INFERENCE_ERROR;
     }
@@ -310,14 +381,37 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
         return EI_IMPULSE_ALLOC_FAILED;
     }
 
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+    // the features go into the unified region, the arena is laid out around them at the handoff
+    float *planned_features = nullptr;
+    if (handle->impulse->learning_blocks_size == 1 &&
+            ei_memory_plan_init(&ei_memory_plan_layout, ei_memory_plan_region,
+                                ei_memory_plan_region_size(ei_memory_plan_layout)) == EI_IMPULSE_OK) {
+        planned_features = ei_memory_plan_features(handle->impulse->nn_input_frame_size);
+    }
+#endif
+
     uint64_t dsp_start_us = ei_read_timer_us();
 
     size_t out_features_index = 0;
 
     for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_DSP);
+        EI_MEM_STAGE(&result->memory.dsp);
+
         ei_model_dsp_t block = handle->impulse->dsp_blocks[ix];
 
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+        if (planned_features && out_features_index + block.n_output_features <= handle->impulse->nn_input_frame_size) {
+            matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(
+                new ei::matrix_t(1, block.n_output_features, planned_features + out_features_index));
+        }
+        else {
+            matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+        }
+#else
         matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+#endif
         if (matrix_ptrs[ix] == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
             return EI_IMPULSE_ALLOC_FAILED;
@@ -348,6 +442,19 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
         auto internal_signal = swa.get_signal();
 #endif
 
+#if EI_CLASSIFIER_FEATURE_CACHE
+        // another impulse may have run the same block over this window already
+        uint64_t cache_key = 0;
+        if (handle->feature_cache) {
+            cache_key = ei_feature_cache_key(handle->impulse, &block);
+            if (ei_feature_cache_find(handle->feature_cache, cache_key, handle->impulse, &block, features[ix].matrix)) {
+                result->timing.dsp_cache_hits++;
+                out_features_index += block.n_output_features;
+                continue;
+            }
+        }
+#endif
+
         int ret;
         if (block.factory) { // ie, if we're using state
             // Msg user
@@ -379,6 +486,12 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
             return EI_IMPULSE_DSP_ERROR;
         }
 
+#if EI_CLASSIFIER_FEATURE_CACHE
+        if (cache_key) {
+            ei_feature_cache_store(handle->feature_cache, cache_key, handle->impulse, &block, features[ix].matrix);
+        }
+#endif
+
         if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
             return EI_IMPULSE_CANCELED;
         }
@@ -434,22 +547,132 @@ extern "C" EI_IMPULSE_ERROR init_impulse(ei_impulse_handle_t *handle) {
     return EI_IMPULSE_OK;
 }
 
+/**
+ * @brief      Slices per model window a continuous stream runs at
+ */
+static uint32_t continuous_slices_per_model_window(const ei_continuous_ctx_t *ctx, const ei_impulse_t *impulse)
+{
+    return ctx->slices_per_model_window ? ctx->slices_per_model_window : impulse->slices_per_model_window;
+}
+
+/**
+ * @brief      Check that the raw window splits in the given number of slices, each at
+ *             least one frame of every DSP block long
+ *
+ * @return     EI_IMPULSE_OK, or EI_IMPULSE_DSP_ERROR if the impulse cannot run at that rate
+ */
+static EI_IMPULSE_ERROR check_slices_per_model_window(const ei_impulse_t *impulse, uint32_t slices)
+{
+    if ((slices == 0) || (impulse->raw_sample_count % slices != 0)) {
+        ei_printf("ERR: %u slices per model window do not divide the window of %u samples\n",
+            (unsigned)slices, (unsigned)impulse->raw_sample_count);
+        return EI_IMPULSE_DSP_ERROR;
+    }
+
+    const uint32_t slice_size = impulse->raw_sample_count / slices;
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        ei_model_dsp_t block = impulse->dsp_blocks[ix];
+        float frame_length = 0.0f;
+
+        if (block.extract_fn == extract_mfcc_features) {
+            frame_length = ((ei_dsp_config_mfcc_t *)block.config)->frame_length;
+        }
+        else if (block.extract_fn == extract_spectrogram_features) {
+            frame_length = ((ei_dsp_config_spectrogram_t *)block.config)->frame_length;
+        }
+        else if (block.extract_fn == extract_mfe_features) {
+            frame_length = ((ei_dsp_config_mfe_t *)block.config)->frame_length;
+        }
+
+        if ((size_t)(impulse->frequency * frame_length) > slice_size) {
+            ei_printf("ERR: Slices of %u samples are shorter than a frame of DSP block %lu\n",
+                (unsigned)slice_size, (unsigned long)ix);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief      RMS of all values in the signal
+ */
+static float continuous_slice_rms(signal_t *signal)
+{
+    float chunk[64];
+    double sum_sq = 0.0;
+
+    for (size_t offset = 0; offset < signal->total_length; offset += 64) {
+        size_t len = std::min<size_t>(64, signal->total_length - offset);
+        if (signal->get_data(offset, len, chunk) != 0) {
+            return 0.0f;
+        }
+        for (size_t ix = 0; ix < len; ix++) {
+            sum_sq += (double)chunk[ix] * chunk[ix];
+        }
+    }
+
+    return signal->total_length ? (float)sqrt(sum_sq / signal->total_length) : 0.0f;
+}
+
+/**
+ * @brief      Apply the rate policy of the stream to the activity of the last slice
+ *
+ * Active slices go straight to the highest rate so an event is followed closely,
+ * the rate only steps down after a run of quiet slices.
+ */
+static void continuous_update_rate(ei_continuous_ctx_t *ctx, const ei_impulse_t *impulse, float activity)
+{
+    const ei_continuous_rate_policy_t *policy = ctx->rate_policy;
+    uint32_t slices = continuous_slices_per_model_window(ctx, impulse);
+
+    if (activity >= policy->activity_threshold) {
+        ctx->quiet_slices = 0;
+        ctx->slices_per_model_window = policy->max_slices;
+        return;
+    }
+
+    if (activity >= policy->silence_threshold) {
+        ctx->quiet_slices = 0;
+        return;
+    }
+
+    if (++ctx->quiet_slices < policy->hold_slices || slices <= policy->min_slices) {
+        return;
+    }
+
+    ctx->quiet_slices = 0;
+    uint32_t lower = slices / 2;
+    if ((lower < policy->min_slices) || (impulse->raw_sample_count % lower != 0)) {
+        lower = policy->min_slices;
+    }
+    ctx->slices_per_model_window = lower;
+}
+
 /**
  * @brief      Process a complete impulse for continuous inference
  *
  * @param      handle               struct with information about model and DSP
+ * @param      ctx                  State of the stream the signal belongs to
  * @param      signal               Sample data
  * @param      result               Output classifier results
  * @param[in]  debug                Debug output enable
+ * @param[in]  infer                Run inference once the window is full, false only
+ *                                  adds the features of the slice to the window
  *
  * @return     The ei impulse error.
  */
-extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
+__attribute__((unused)) EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
+                                            ei_continuous_ctx_t *ctx,
                                             signal_t *signal,
                                             ei_impulse_result_t *result,
-                                            bool debug = false)
+                                            bool debug = false,
+                                            bool infer = true)
 {
-    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr)) {
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_RUN_CLASSIFIER);
+
+    if ((handle == nullptr) || (handle->impulse  == nullptr) || (result  == nullptr) || (signal  == nullptr) ||
+            (ctx == nullptr) || (ctx->dsp_state == nullptr)) {
         return EI_IMPULSE_INFERENCE_ERROR;
     }
 
@@ -461,18 +684,38 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
     memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
 
     auto impulse = handle->impulse;
-    static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
-    if (!static_features_matrix.buffer) {
+    // the rolling feature matrix lives as long as the stream
+    if (ctx->features_matrix && ctx->features_matrix->cols != impulse->nn_input_frame_size) {
+        delete ctx->features_matrix;
+        ctx->features_matrix = nullptr;
+    }
+    if (!ctx->features_matrix) {
+        ctx->features_matrix = new ei::matrix_t(1, impulse->nn_input_frame_size);
+    }
+    if (!ctx->features_matrix->buffer) {
         return EI_IMPULSE_ALLOC_FAILED;
     }
+    ei::matrix_t &static_features_matrix = *ctx->features_matrix;
 
     EI_IMPULSE_ERROR ei_impulse_error = EI_IMPULSE_OK;
 
     uint64_t dsp_start_us = ei_read_timer_us();
 
+    // the per-slice DSP blocks take slices of any length, so the rate can change between
+    // slices: the audio frame carries over and the feature matrix rolls by what a slice adds
+    result->continuous.slices_per_model_window = continuous_slices_per_model_window(ctx, impulse);
+    if (ctx->rate_policy) {
+        result->continuous.activity = continuous_slice_rms(signal);
+        continuous_update_rate(ctx, impulse, result->continuous.activity);
+    }
+    result->continuous.next_slices_per_model_window = continuous_slices_per_model_window(ctx, impulse);
+
     size_t out_features_index = 0;
 
     for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_DSP);
+        EI_MEM_STAGE(&result->memory.dsp);
+
         ei_model_dsp_t block = impulse->dsp_blocks[ix];
 
         if (out_features_index + block.n_output_features > impulse->nn_input_frame_size) {
@@ -483,7 +726,8 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         ei::matrix_t fm(1, block.n_output_features,
                         static_features_matrix.buffer + out_features_index);
 
-        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size);
+        int (*extract_fn_slice)(ei::signal_t *signal, ei::matrix_t *output_matrix, void *config, const float frequency, matrix_size_t *out_matrix_size,
+            ei_dsp_cont_state_t *state);
 
         /* Switch to the slice version of the mfcc feature extract function */
         if (block.extract_fn == extract_mfcc_features) {
@@ -507,10 +751,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
             return EI_IMPULSE_DSP_ERROR;
         }
-        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written);
+        int ret = extract_fn_slice(signal, &fm, block.config, impulse->frequency, &features_written, ctx->dsp_state);
 #else
         SignalWithAxes swa(signal, block.axes, block.axes_size, impulse);
-        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written);
+        int ret = extract_fn_slice(swa.get_signal(), &fm, block.config, impulse->frequency, &features_written, ctx->dsp_state);
 #endif
 
         if (ret != EIDSP_OK) {
@@ -522,7 +766,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             return EI_IMPULSE_CANCELED;
         }
 
-        classifier_continuous_features_written += (features_written.rows * features_written.cols);
+        ctx->features_written += (features_written.rows * features_written.cols);
 
         out_features_index += block.n_output_features;
     }
@@ -535,7 +779,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         result->classification[i].label = impulse->categories[(uint32_t)i];
     }
 
-    if (classifier_continuous_features_written >= impulse->nn_input_frame_size) {
+    if (infer && ctx->features_written >= impulse->nn_input_frame_size) {
         dsp_start_us = ei_read_timer_us();
 
         uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
@@ -556,11 +800,32 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             return EI_IMPULSE_ALLOC_FAILED;
         }
 
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+        // the normalized copies go into the unified region
+        float *planned_features = nullptr;
+        if (impulse->learning_blocks_size == 1 &&
+                ei_memory_plan_init(&ei_memory_plan_layout, ei_memory_plan_region,
+                                    ei_memory_plan_region_size(ei_memory_plan_layout)) == EI_IMPULSE_OK) {
+            planned_features = ei_memory_plan_features(impulse->nn_input_frame_size);
+        }
+#endif
+
         out_features_index = 0;
         // iterate over every dsp block and run normalization
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+            EI_MEM_STAGE(&result->memory.dsp);
             ei_model_dsp_t block = impulse->dsp_blocks[ix];
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+            if (planned_features && out_features_index + block.n_output_features <= impulse->nn_input_frame_size) {
+                matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(
+                    new ei::matrix_t(1, block.n_output_features, planned_features + out_features_index));
+            }
+            else {
+                matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+            }
+#else
             matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+#endif
 
             if (matrix_ptrs[ix] == nullptr) {
                 ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
@@ -608,12 +873,31 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
         ei_impulse_error = run_inference(handle, features, result, debug);
         delete[] matrix_ptrs;
-        ei_impulse_error = run_postprocessing(handle, result);
+        ei_impulse_error = run_postprocessing_state(handle,
+            ctx->post_processing_state ? ctx->post_processing_state : handle->post_processing_state, result);
     }
 
     return ei_impulse_error;
 }
 
+/**
+ * @brief      Process a complete impulse for continuous inference
+ *
+ * @param      handle               struct with information about model and DSP
+ * @param      signal               Sample data
+ * @param      result               Output classifier results
+ * @param[in]  debug                Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *handle,
+                                            signal_t *signal,
+                                            ei_impulse_result_t *result,
+                                            bool debug = false)
+{
+    return process_impulse_continuous(handle, &ei_default_continuous_ctx, signal, result, debug);
+}
+
 /**
  * Check if the current impulse could be used by 'run_classifier_image_quantized'
  */
@@ -824,7 +1108,8 @@ will be documented by Doxygen. */
 extern "C" void run_classifier_init(void)
 {
 
-    classifier_continuous_features_written = 0;
+    ei_default_continuous_ctx.features_written = 0;
+    ei_default_continuous_ctx.quiet_slices = 0;
     ei_dsp_clear_continuous_audio_state();
     init_impulse(&ei_default_impulse);
     init_postprocessing(&ei_default_impulse);
@@ -846,12 +1131,62 @@ extern "C" void run_classifier_init(void)
  */
 __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 {
-    classifier_continuous_features_written = 0;
+    ei_default_continuous_ctx.features_written = 0;
+    ei_default_continuous_ctx.quiet_slices = 0;
     ei_dsp_clear_continuous_audio_state();
     init_impulse(handle);
     init_postprocessing(handle);
 }
 
+/**
+ * @brief Initialize a stream context for running preprocessing and inference
+ *  continuously.
+ *
+ * Like `run_classifier_init()`, but for the stream given by `ctx` only. Clears the state
+ * of the stream and binds it to `handle`, which is used by `run_classifier_continuous(ctx, ...)`.
+ * Call `run_classifier_deinit(ctx)` when done with the stream.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in]   ctx    zero-initialized (or deinitialized) stream context
+ * @param[in]   handle struct with information about model and DSP
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_init(ei_continuous_ctx_t *ctx, ei_impulse_handle_t *handle = &ei_default_impulse)
+{
+    if ((ctx == nullptr) || (handle == nullptr) || (handle->impulse == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    if (ctx->dsp_state == nullptr) {
+        ctx->dsp_state = (ei_dsp_cont_state_t *)ei_calloc(1, sizeof(ei_dsp_cont_state_t));
+        if (ctx->dsp_state == nullptr) {
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+    }
+    else {
+        ei_dsp_clear_continuous_audio_state(ctx->dsp_state);
+        memset(ctx->dsp_state, 0, sizeof(ei_dsp_cont_state_t));
+    }
+
+    // postprocessing state set up for another impulse goes with that impulse
+    if (ctx->post_processing_state && ctx->handle && (ctx->handle != handle)) {
+        deinit_postprocessing_state(ctx->handle, &ctx->post_processing_state);
+    }
+
+    ctx->handle = handle;
+    ctx->features_written = 0;
+    ctx->quiet_slices = 0;
+
+    EI_IMPULSE_ERROR res = init_impulse(handle);
+    if (res != EI_IMPULSE_OK) {
+        return res;
+    }
+    // the stream's own postprocessing state, the handle's is left to other streams
+    return init_postprocessing_state(handle, &ctx->post_processing_state);
+}
+
 /**
  * @brief Deletes static variables when running preprocessing and inference continuously.
  *
@@ -873,6 +1208,179 @@ __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
     deinit_postprocessing(handle);
 }
 
+/**
+ * @brief Releases a stream context set up by `run_classifier_init(ctx, handle)`.
+ *
+ * Frees the audio frame, the feature matrix and the postprocessing state of the stream.
+ * The handle and other streams on it are not touched. The context can be initialized
+ * again afterwards.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in]   ctx stream context
+ */
+__attribute__((unused)) void run_classifier_deinit(ei_continuous_ctx_t *ctx)
+{
+    if (ctx == nullptr) {
+        return;
+    }
+
+    if (ctx->handle) {
+        deinit_postprocessing_state(ctx->handle, &ctx->post_processing_state);
+    }
+    if (ctx->dsp_state) {
+        ei_dsp_clear_continuous_audio_state(ctx->dsp_state);
+        ei_free(ctx->dsp_state);
+    }
+    delete ctx->features_matrix;
+
+    ctx->handle = nullptr;
+    ctx->dsp_state = nullptr;
+    ctx->features_written = 0;
+    ctx->features_matrix = nullptr;
+    ctx->quiet_slices = 0;
+}
+
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+/**
+ * @brief Forgets the smoothed scores and events of a continuous stream.
+ *
+ * @param[in]   ctx stream context, set up with `run_classifier_init(ctx, handle)`
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_smoothing_reset(ei_continuous_ctx_t *ctx)
+{
+    if ((ctx == nullptr) || (ctx->handle == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    return ei_smoothing_reset_state(ctx->handle, ctx->post_processing_state);
+}
+#endif // EI_CLASSIFIER_SMOOTHING_ENABLED
+
+/**
+ * @brief Sets the number of slices per model window of a continuous stream.
+ *
+ * Takes effect with the next slice, which then holds raw sample count / `slices` samples
+ * (`run_classifier_get_slice_size(ctx)`). More slices classify more often for more CPU
+ * time, fewer slices save CPU at the cost of latency. The features of the window so far
+ * are kept, so the stream does not start over.
+ *
+ * **Blocking**: no
+ *
+ * @param[in]   ctx    stream context, set up with `run_classifier_init(ctx, handle)`
+ * @param[in]   slices slices per model window, must divide the raw sample count of the impulse
+ *  and leave slices at least one frame long (e.g. 2, 4, 8 or 16), 0 for the impulse's
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_set_slices_per_model_window(ei_continuous_ctx_t *ctx, uint32_t slices)
+{
+    if (ctx == nullptr) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    const ei_impulse_t *impulse = ctx->handle ? ctx->handle->impulse : ei_default_impulse.impulse;
+
+    if (slices != 0) {
+        EI_IMPULSE_ERROR res = check_slices_per_model_window(impulse, slices);
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+    }
+    ctx->slices_per_model_window = slices;
+    ctx->quiet_slices = 0;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief Sets the number of slices per model window of the stream classified by
+ *  `run_classifier_continuous()` without a context.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_set_slices_per_model_window(uint32_t slices)
+{
+    return run_classifier_set_slices_per_model_window(&ei_default_continuous_ctx, slices);
+}
+
+/**
+ * @brief Lets the slice rate of a continuous stream follow the activity of its slices.
+ *
+ * See `ei_continuous_rate_policy_t`. The result of every slice holds the rate it ran at and
+ * the rate of the next slice in `result.continuous`. The policy is not copied and must
+ * outlive its use by the stream, nullptr keeps the stream at its current rate.
+ *
+ * **Blocking**: no
+ *
+ * @param[in]   ctx    stream context, set up with `run_classifier_init(ctx, handle)`
+ * @param[in]   policy rate policy or nullptr
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_set_rate_policy(ei_continuous_ctx_t *ctx,
+    const ei_continuous_rate_policy_t *policy)
+{
+    if (ctx == nullptr) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    const ei_impulse_t *impulse = ctx->handle ? ctx->handle->impulse : ei_default_impulse.impulse;
+
+    if (policy) {
+        if (policy->min_slices > policy->max_slices) {
+            ei_printf("ERR: min_slices (%u) is above max_slices (%u)\n",
+                (unsigned)policy->min_slices, (unsigned)policy->max_slices);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+        EI_IMPULSE_ERROR res = check_slices_per_model_window(impulse, policy->min_slices);
+        if (res == EI_IMPULSE_OK) {
+            res = check_slices_per_model_window(impulse, policy->max_slices);
+        }
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+
+        uint32_t slices = continuous_slices_per_model_window(ctx, impulse);
+        if (slices < policy->min_slices) {
+            ctx->slices_per_model_window = policy->min_slices;
+        }
+        else if (slices > policy->max_slices) {
+            ctx->slices_per_model_window = policy->max_slices;
+        }
+    }
+    ctx->rate_policy = policy;
+    ctx->quiet_slices = 0;
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief Sets the rate policy of the stream classified by `run_classifier_continuous()`
+ *  without a context.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_set_rate_policy(const ei_continuous_rate_policy_t *policy)
+{
+    return run_classifier_set_rate_policy(&ei_default_continuous_ctx, policy);
+}
+
+/**
+ * @brief Returns the number of raw samples the next slice of a continuous stream
+ *  should hold, `EI_CLASSIFIER_SLICE_SIZE` unless the slice rate was changed.
+ *
+ * @param[in]   ctx    stream context
+ */
+__attribute__((unused)) uint32_t run_classifier_get_slice_size(const ei_continuous_ctx_t *ctx)
+{
+    const ei_impulse_t *impulse = ctx->handle ? ctx->handle->impulse : ei_default_impulse.impulse;
+
+    return impulse->raw_sample_count / continuous_slices_per_model_window(ctx, impulse);
+}
+
+/**
+ * @brief Returns the number of raw samples the next slice of the stream classified by
+ *  `run_classifier_continuous()` without a context should hold.
+ */
+__attribute__((unused)) uint32_t run_classifier_get_slice_size(void)
+{
+    return run_classifier_get_slice_size(&ei_default_continuous_ctx);
+}
+
 /**
  * @brief Run preprocessing (DSP) on new slice of raw features. Add output features
  *  to rolling matrix and run inference on full sample.
@@ -992,6 +1500,42 @@ __attribute__((unused)) EI_IMPULSE_ERROR run_classifier_continuous(
     return process_impulse_continuous(impulse, signal, result, debug);
 }
 
+/**
+ * @brief Run preprocessing (DSP) on a new slice of raw features of one stream. Add
+ *  output features to the rolling matrix of that stream and run inference on the full sample.
+ *
+ * Same as `run_classifier_continuous()`, but all state carried between slices lives in
+ * `ctx`, so slices of several streams can be interleaved. Streams only share the model.
+ *
+ * `run_classifier_init(ctx, handle)` must be called before making any calls to
+ * `run_classifier_continuous(ctx, ...)`.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] ctx     Stream context, set up with `run_classifier_init(ctx, handle)`.
+ * @param[in] signal  Pointer to a signal_t struct that contains the number of elements in the
+ *  slice of raw features (`run_classifier_get_slice_size(ctx)`) and a pointer to a callback that reads
+ *  in the slice of raw features.
+ * @param[out] result Pointer to an `ei_impulse_result_t` struct that contains the various output
+ *  results from inference after run_classifier() returns.
+ * @param[in] debug Print internal preprocessing and inference debugging information via
+ *  `ei_printf()`.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if inference
+ *  completed successfully.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_continuous(
+    ei_continuous_ctx_t *ctx,
+    signal_t *signal,
+    ei_impulse_result_t *result,
+    bool debug = false)
+{
+    if (ctx == nullptr) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    return process_impulse_continuous(ctx->handle, ctx, signal, result, debug);
+}
+
 /**
  * @brief Run the classifier over a raw features array.
  *
@@ -1052,6 +1596,259 @@ __attribute__((unused)) EI_IMPULSE_ERROR run_classifier(
     return process_impulse(impulse, signal, result, debug);
 }
 
+#if (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_UNIFIED_MEMORY_PLAN && !EI_CLASSIFIER_DSP_ONLY && !EI_CLASSIFIER_LOAD_IMAGE_SCALING
+typedef struct {
+    ei_impulse_handle_t *handle;
+    signal_t *signals;
+    ei_impulse_result_t *results;
+    ei_feature_t *features;
+    ei_feature_t *raw_outputs;
+    uint32_t num_raw_outputs;
+    bool debug;
+} ei_batch_ctx_t;
+
+/**
+ * Check if the impulse can go through run_nn_inference_batch: one EON compiled
+ * model that supports batching, behind DSP blocks that keep no state
+ */
+__attribute__((unused)) static bool can_run_classifier_batch(const ei_impulse_t *impulse) {
+    if (impulse->learning_blocks_size != 1 || impulse->learning_blocks[0].infer_fn != run_nn_inference) {
+        return false;
+    }
+    if (can_run_classifier_image_quantized(impulse, impulse->learning_blocks[0]) == EI_IMPULSE_OK) {
+        return false;
+    }
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        if (impulse->dsp_blocks[ix].factory) {
+            return false;
+        }
+    }
+
+    ei_learning_block_config_tflite_graph_t *block_config =
+        (ei_learning_block_config_tflite_graph_t*)impulse->learning_blocks[0].config;
+    return ((ei_config_tflite_eon_graph_t*)block_config->graph_config)->model_invoke_batch != nullptr;
+}
+
+static EI_IMPULSE_ERROR process_impulse_batch_features(void *user, size_t ix, ei_feature_t **fmatrix) {
+    ei_batch_ctx_t *ctx = (ei_batch_ctx_t*)user;
+    ei_impulse_handle_t *handle = ctx->handle;
+    ei_impulse_result_t *result = &ctx->results[ix];
+
+#ifndef EI_DSP_RESULT_OVERRIDE
+    memset(result, 0, sizeof(ei_impulse_result_t));
+#endif
+    result->_raw_outputs = ctx->raw_outputs;
+    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * ctx->num_raw_outputs);
+
+    uint64_t dsp_start_us = ei_read_timer_us();
+
+    for (size_t block_ix = 0; block_ix < handle->impulse->dsp_blocks_size; block_ix++) {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_DSP);
+
+        ei_model_dsp_t block = handle->impulse->dsp_blocks[block_ix];
+
+#if EIDSP_SIGNAL_C_FN_POINTER
+        if (block.axes_size != handle->impulse->raw_samples_per_frame) {
+            ei_printf("ERR: EIDSP_SIGNAL_C_FN_POINTER can only be used when all axes are selected for DSP blocks\n");
+            return EI_IMPULSE_DSP_ERROR;
+        }
+        auto internal_signal = &ctx->signals[ix];
+#else
+        SignalWithAxes swa(&ctx->signals[ix], block.axes, block.axes_size, handle->impulse);
+        auto internal_signal = swa.get_signal();
+#endif
+
+        int ret = block.extract_fn(internal_signal, ctx->features[block_ix].matrix, block.config, handle->impulse->frequency);
+        if (ret != EIDSP_OK) {
+            ei_printf("ERR: Failed to run DSP process (%d)\n", ret);
+            return EI_IMPULSE_DSP_ERROR;
+        }
+
+        if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
+            return EI_IMPULSE_CANCELED;
+        }
+    }
+
+    result->timing.dsp_us = ei_read_timer_us() - dsp_start_us;
+    result->timing.dsp = (int)(result->timing.dsp_us / 1000);
+
+    if (ctx->debug) {
+        ei_printf("Features (%d ms.): ", result->timing.dsp);
+        for (size_t block_ix = 0; block_ix < handle->impulse->dsp_blocks_size; block_ix++) {
+            for (size_t jx = 0; jx < ctx->features[block_ix].matrix->cols; jx++) {
+                ei_printf_float(ctx->features[block_ix].matrix->buffer[jx]);
+                ei_printf(" ");
+            }
+            ei_printf("\n");
+        }
+    }
+
+    *fmatrix = ctx->features;
+    return EI_IMPULSE_OK;
+}
+
+static EI_IMPULSE_ERROR process_impulse_batch_result(void *user, size_t ix) {
+    ei_batch_ctx_t *ctx = (ei_batch_ctx_t*)user;
+    ei_impulse_result_t *result = &ctx->results[ix];
+
+    // frees the raw outputs, which are reused by the next result
+    EI_IMPULSE_ERROR res = run_postprocessing(ctx->handle, result);
+    result->_raw_outputs = nullptr;
+
+    return res;
+}
+
+/**
+ * @brief      Process several windows with one DSP workspace and one model setup
+ *
+ * @return     The ei impulse error.
+ */
+static EI_IMPULSE_ERROR process_impulse_batch(ei_impulse_handle_t *handle,
+                                              signal_t *signals,
+                                              ei_impulse_result_t *results,
+                                              size_t count,
+                                              bool debug)
+{
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_RUN_CLASSIFIER);
+
+    uint32_t block_num = handle->impulse->dsp_blocks_size;
+#if (EI_CLASSIFIER_OBJECT_DETECTION_LAST_LAYER == EI_CLASSIFIER_LAST_LAYER_SSD)
+    uint32_t num_results = handle->impulse->learning_blocks_size + 3;
+#else
+    uint32_t num_results = handle->impulse->learning_blocks_size;
+#endif
+
+    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[num_results]);
+    std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
+    std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> matrix_ptrs(new std::unique_ptr<ei::matrix_t>[block_num]);
+    ei_feature_t *features = features_ptr.get();
+
+    memset(raw_results_ptr.get(), 0, sizeof(ei_feature_t) * num_results);
+    memset(features, 0, sizeof(ei_feature_t) * block_num);
+
+    // one feature buffer per DSP block, shared by all windows
+    size_t out_features_index = 0;
+    for (size_t ix = 0; ix < block_num; ix++) {
+        ei_model_dsp_t block = handle->impulse->dsp_blocks[ix];
+
+        if (out_features_index + block.n_output_features > handle->impulse->nn_input_frame_size) {
+            ei_printf("ERR: Would write outside feature buffer\n");
+            return EI_IMPULSE_DSP_ERROR;
+        }
+
+        matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
+        if (matrix_ptrs[ix] == nullptr || matrix_ptrs[ix]->buffer == nullptr) {
+            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
+            return EI_IMPULSE_ALLOC_FAILED;
+        }
+
+        features[ix].matrix = matrix_ptrs[ix].get();
+        features[ix].blockId = block.blockId;
+        out_features_index += block.n_output_features;
+    }
+
+    ei_batch_ctx_t ctx = { handle, signals, results, features, raw_results_ptr.get(), num_results, debug };
+
+    if (debug) {
+        ei_printf("Running impulse on %u windows...\n", (unsigned int)count);
+    }
+
+    EI_IMPULSE_ERROR res = run_nn_inference_batch(handle->impulse, 0, count, results,
+                                                  process_impulse_batch_features,
+                                                  process_impulse_batch_result, &ctx, debug);
+
+    // on errors the raw outputs of the result in flight are still set
+    for (size_t ix = 0; ix < handle->impulse->learning_blocks_size; ix++) {
+        delete raw_results_ptr[ix].matrix;
+    }
+    for (size_t ix = 0; ix < count; ix++) {
+        results[ix]._raw_outputs = nullptr;
+    }
+
+    return res;
+}
+#endif // EI_CLASSIFIER_COMPILED == 1 && !EI_CLASSIFIER_UNIFIED_MEMORY_PLAN ...
+
+/**
+ * @brief Run the classifier over several windows at once.
+ *
+ * Gives the same results as calling `run_classifier()` on every signal in turn. For EON
+ * compiled models behind stateless DSP blocks the feature buffers and the model are set
+ * up once for the whole batch, and the layers the model can batch (the fully connected
+ * ones) read their weights once per chunk of windows instead of once per window.
+ * Other impulses fall back to one `run_classifier()` per signal.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] impulse Pointer to an `ei_impulse_handle_t` struct that contains the model and
+ *  preprocessing information.
+ * @param[in] signals Array of `count` signals, one window each
+ * @param[out] results Array of `count` results, filled in the same order
+ * @param[in] count Number of windows
+ * @param[in] debug Print internal preprocessing and inference debugging information via `ei_printf()`.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if inference
+ *  completed successfully for all windows.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_batch(
+    ei_impulse_handle_t *impulse,
+    signal_t *signals,
+    ei_impulse_result_t *results,
+    size_t count,
+    bool debug = false)
+{
+    if ((impulse == nullptr) || (impulse->impulse == nullptr) || (results == nullptr) || (signals == nullptr)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+    if (count == 0) {
+        return EI_IMPULSE_OK;
+    }
+
+#if (EI_CLASSIFIER_COMPILED == 1) && !EI_CLASSIFIER_UNIFIED_MEMORY_PLAN && !EI_CLASSIFIER_DSP_ONLY && !EI_CLASSIFIER_LOAD_IMAGE_SCALING
+#if EI_CLASSIFIER_CASCADE
+    // the first stage needs the features of every window, before the model runs
+    bool batch_ok = can_run_classifier_batch(impulse->impulse) && !impulse->cascade;
+#else
+    bool batch_ok = can_run_classifier_batch(impulse->impulse);
+#endif
+    if (batch_ok) {
+        return process_impulse_batch(impulse, signals, results, count, debug);
+    }
+#endif
+
+    for (size_t ix = 0; ix < count; ix++) {
+        EI_IMPULSE_ERROR res = process_impulse(impulse, &signals[ix], &results[ix], debug);
+        if (res != EI_IMPULSE_OK) {
+            return res;
+        }
+    }
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief Run the classifier over several windows at once.
+ *
+ * Overloaded function [run_classifier_batch()](#run_classifier_batch-1) that defaults to the single impulse.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] signals Array of `count` signals, one window each
+ * @param[out] results Array of `count` results, filled in the same order
+ * @param[in] count Number of windows
+ * @param[in] debug Print internal preprocessing and inference debugging information via `ei_printf()`.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if inference
+ *  completed successfully for all windows.
+ */
+extern "C" EI_IMPULSE_ERROR run_classifier_batch(
+    signal_t *signals,
+    ei_impulse_result_t *results,
+    size_t count,
+    bool debug = false)
+{
+    return run_classifier_batch(&ei_default_impulse, signals, results, count, debug);
+}
+
 /** @} */ // end of ei_functions Doxygen group
 
 /* Deprecated functions ------------------------------------------------------- */
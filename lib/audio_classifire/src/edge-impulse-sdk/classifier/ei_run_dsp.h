@@ -72,10 +72,20 @@ using namespace ei;
 float ei_dsp_image_buffer[EI_DSP_IMAGE_BUFFER_STATIC_SIZE];
 #endif
 
-// this is the frame we work on... allocate it statically so we share between invocations
-static float *ei_dsp_cont_current_frame = nullptr;
-static size_t ei_dsp_cont_current_frame_size = 0;
-static int ei_dsp_cont_current_frame_ix = 0;
+// state that the per-slice (continuous) audio blocks carry from one slice to the next
+typedef struct {
+    // the frame we work on, with the samples left over from the previous slice
+    float *current_frame;
+    size_t current_frame_size;
+    int current_frame_ix;
+    // implementation version 1 skips the extra frame on the first slice
+    bool spectrogram_first_run;
+    bool mfe_first_run;
+} ei_dsp_cont_state_t;
+
+// used when no state is passed in (and by run_classifier_continuous() without a
+// stream context), shared between invocations
+static ei_dsp_cont_state_t ei_dsp_cont_default_state = { nullptr, 0, 0, false, false };
 
 __attribute__((unused)) int extract_hr_features(
     signal_t *signal,
@@ -194,6 +204,20 @@ static int preemphasized_audio_signal_get_data(size_t offset, size_t length, flo
     return preemphasis->get_data(offset, length, out_ptr);
 }
 
+// Reads `signal` through `pre`. std::function callbacks capture the filter, so streams
+// running concurrently don't share the pointer above (C function pointers still do).
+static void preemphasized_audio_signal_init(signal_t *out, signal_t *signal, class speechpy::processing::preemphasis *pre) {
+    out->total_length = signal->total_length;
+#if EIDSP_SIGNAL_C_FN_POINTER
+    preemphasis = pre;
+    out->get_data = &preemphasized_audio_signal_get_data;
+#else
+    out->get_data = [pre](size_t offset, size_t length, float *out_ptr) {
+        return pre->get_data(offset, length, out_ptr);
+    };
+#endif
+}
+
 __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
     ei_dsp_config_mfcc_t config = *((ei_dsp_config_mfcc_t*)config_ptr);
 
@@ -213,11 +237,9 @@ __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *ou
 
     // preemphasis class to preprocess the audio...
     class speechpy::processing::preemphasis pre(signal, config.pre_shift, config.pre_cof, false);
-    preemphasis = &pre;
 
     signal_t preemphasized_audio_signal;
-    preemphasized_audio_signal.total_length = signal->total_length;
-    preemphasized_audio_signal.get_data = &preemphasized_audio_signal_get_data;
+    preemphasized_audio_signal_init(&preemphasized_audio_signal, signal, &pre);
 
     // calculate the size of the MFCC matrix
     matrix_size_t out_matrix_size =
@@ -298,7 +320,8 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out,
+    ei_dsp_cont_state_t *state = &ei_dsp_cont_default_state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -322,11 +345,9 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 
     // preemphasis class to preprocess the audio...
     class speechpy::processing::preemphasis pre(signal, config.pre_shift, config.pre_cof, false);
-    preemphasis = &pre;
 
     signal_t preemphasized_audio_signal;
-    preemphasized_audio_signal.total_length = signal->total_length;
-    preemphasized_audio_signal.get_data = &preemphasized_audio_signal_get_data;
+    preemphasized_audio_signal_init(&preemphasized_audio_signal, signal, &pre);
 
     // Go from the time (e.g. 0.25 seconds to number of frames based on freq)
     const size_t frame_length_values = frequency * config.frame_length;
@@ -345,9 +366,9 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     int x;
 
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (state->current_frame && state->current_frame_size != frame_length_values) {
+        ei_free(state->current_frame);
+        state->current_frame = nullptr;
     }
 
     int implementation_version = config.implementation_version;
@@ -355,19 +376,19 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
+    if (!state->current_frame) {
+        state->current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!state->current_frame) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        state->current_frame_size = frame_length_values;
+        state->current_frame_ix = 0;
     }
 
 
-    if ((frame_length_values) > preemphasized_audio_signal.total_length  + ei_dsp_cont_current_frame_ix) {
+    if ((frame_length_values) > preemphasized_audio_signal.total_length  + state->current_frame_ix) {
         ei_printf("ERR: frame_length (%d) cannot be larger than signal's total length (%d) for continuous classification\n",
-            (int)frame_length_values, (int)preemphasized_audio_signal.total_length  + ei_dsp_cont_current_frame_ix);
+            (int)frame_length_values, (int)preemphasized_audio_signal.total_length  + state->current_frame_ix);
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
@@ -379,24 +400,24 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
         implementation_version = 2;
     }
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
+    if (state->current_frame_ix > (int)state->current_frame_size) {
         ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size (ix=%d size=%d)\n",
-            ei_dsp_cont_current_frame_ix, (int)ei_dsp_cont_current_frame_size);
+            state->current_frame_ix, (int)state->current_frame_size);
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->current_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->current_frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = preemphasized_audio_signal.get_data(0, frame_length_values - state->current_frame_ix, state->current_frame + state->current_frame_ix);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now state->current_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(state->current_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
@@ -408,15 +429,15 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(state->current_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->current_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->current_frame_ix < 0) {
+        offset_in_signal = -state->current_frame_ix;
+        state->current_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -449,19 +470,17 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the state->current_frame buffer
         x = preemphasized_audio_signal.get_data(
             (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->current_frame);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
-
-    preemphasis = nullptr;
+    state->current_frame_ix = bytes_left_end_of_frame;
 
     return EIDSP_OK;
 #endif
@@ -569,7 +588,8 @@ __attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signa
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out,
+    ei_dsp_cont_state_t *state = &ei_dsp_cont_default_state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -577,8 +597,6 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
-    static bool first_run = false;
-
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
@@ -594,11 +612,11 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     buffer */
     if(config.implementation_version < 2) {
 
-        if (first_run == true) {
+        if (state->spectrogram_first_run == true) {
             signal->total_length += (size_t)(config.frame_length * (float)frequency);
         }
 
-        first_run = true;
+        state->spectrogram_first_run = true;
     }
 
     // Go from the time (e.g. 0.25 seconds to number of frames based on freq)
@@ -624,18 +642,18 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     int x;
 
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (state->current_frame && state->current_frame_size != frame_length_values) {
+        ei_free(state->current_frame);
+        state->current_frame = nullptr;
     }
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
+    if (!state->current_frame) {
+        state->current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!state->current_frame) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        state->current_frame_size = frame_length_values;
+        state->current_frame_ix = 0;
     }
 
     matrix_size_out->rows = 0;
@@ -644,23 +662,23 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
+    if (state->current_frame_ix > (int)state->current_frame_size) {
         ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->current_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->current_frame_ix`
         // starting at offset 0
-        x = signal->get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = signal->get_data(0, frame_length_values - state->current_frame_ix, state->current_frame + state->current_frame_ix);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now state->current_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(state->current_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
@@ -672,15 +690,15 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(state->current_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->current_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->current_frame_ix < 0) {
+        offset_in_signal = -state->current_frame_ix;
+        state->current_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
@@ -713,20 +731,20 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the state->current_frame buffer
         x = signal->get_data(
             (signal->total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->current_frame);
         if (x != EIDSP_OK) {
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->current_frame_ix = bytes_left_end_of_frame;
 
     if (config.implementation_version < 2) {
-        if (first_run == true) {
+        if (state->spectrogram_first_run == true) {
             signal->total_length -= (size_t)(config.frame_length * (float)frequency);
         }
     }
@@ -754,21 +772,17 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
     const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
 
     signal_t preemphasized_audio_signal;
+    class speechpy::processing::preemphasis *pre = nullptr;
 
     // before version 3 we did not have preemphasis
     if (config.implementation_version < 3) {
-        preemphasis = nullptr;
-
         preemphasized_audio_signal.total_length = signal->total_length;
         preemphasized_audio_signal.get_data = signal->get_data;
     }
     else {
         // preemphasis class to preprocess the audio...
-        class speechpy::processing::preemphasis *pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true);
-        preemphasis = pre;
-
-        preemphasized_audio_signal.total_length = signal->total_length;
-        preemphasized_audio_signal.get_data = &preemphasized_audio_signal_get_data;
+        pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true);
+        preemphasized_audio_signal_init(&preemphasized_audio_signal, signal, pre);
     }
 
     // calculate the size of the MFE matrix
@@ -780,8 +794,8 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
     if (out_matrix_size.rows * out_matrix_size.cols > output_matrix->rows * output_matrix->cols) {
         ei_printf("out_matrix = %dx%d\n", (int)output_matrix->rows, (int)output_matrix->cols);
         ei_printf("calculated size = %dx%d\n", (int)out_matrix_size.rows, (int)out_matrix_size.cols);
-        if (preemphasis) {
-            delete preemphasis;
+        if (pre) {
+            delete pre;
         }
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
@@ -804,8 +818,8 @@ __attribute__((unused)) int extract_mfe_features(signal_t *signal, matrix_t *out
             config.low_frequency, config.high_frequency, config.implementation_version);
     }
 
-    if (preemphasis) {
-        delete preemphasis;
+    if (pre) {
+        delete pre;
     }
     if (ret != EIDSP_OK) {
         ei_printf("ERR: MFE failed (%d)\n", ret);
@@ -887,7 +901,8 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
     return EIDSP_OK;
 }
 
-__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out) {
+__attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency, matrix_size_t *matrix_size_out,
+    ei_dsp_cont_state_t *state = &ei_dsp_cont_default_state) {
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
     ei_printf("ERR: Continuous audio is not supported when EI_C_LINKAGE is defined\n");
     EIDSP_ERR(EIDSP_NOT_SUPPORTED);
@@ -898,8 +913,6 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // signal is already the right size,
     // output matrix is not the right size, but we can start writing at offset 0 and then it's OK too
 
-    static bool first_run = false;
-
     if (config.axes != 1) {
         EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
     }
@@ -918,28 +931,26 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // subtracted and there for never used. But skip the first slice to fit the feature_matrix
     // buffer
     if (config.implementation_version == 1) {
-        if (first_run == true) {
+        if (state->mfe_first_run == true) {
             signal->total_length += (size_t)(config.frame_length * (float)frequency);
         }
 
-        first_run = true;
+        state->mfe_first_run = true;
     }
 
     // ok all setup, let's construct the signal (with preemphasis for impl version >3)
     signal_t preemphasized_audio_signal;
+    class speechpy::processing::preemphasis *pre = nullptr;
 
    // before version 3 we did not have preemphasis
     if (config.implementation_version < 3) {
-        preemphasis = nullptr;
         preemphasized_audio_signal.total_length = signal->total_length;
         preemphasized_audio_signal.get_data = signal->get_data;
     }
     else {
         // preemphasis class to preprocess the audio...
-        class speechpy::processing::preemphasis *pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true);
-        preemphasis = pre;
-        preemphasized_audio_signal.total_length = signal->total_length;
-        preemphasized_audio_signal.get_data = &preemphasized_audio_signal_get_data;
+        pre = new class speechpy::processing::preemphasis(signal, 1, 0.98f, true);
+        preemphasized_audio_signal_init(&preemphasized_audio_signal, signal, pre);
     }
 
     // Go from the time (e.g. 0.25 seconds to number of frames based on freq)
@@ -954,8 +965,8 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             ei_printf_float(config.frame_stride);
             ei_printf(") for continuous classification\n");
 
-        if (preemphasis) {
-            delete preemphasis;
+        if (pre) {
+            delete pre;
         }
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
@@ -963,8 +974,8 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     if (frame_length_values > preemphasized_audio_signal.total_length) {
         ei_printf("ERR: frame_length (%d) cannot be larger than signal's total length (%d) for continuous classification\n",
             (int)frame_length_values, (int)preemphasized_audio_signal.total_length);
-        if (preemphasis) {
-            delete preemphasis;
+        if (pre) {
+            delete pre;
         }
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
@@ -972,21 +983,21 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     int x;
 
     // have current frame, but wrong size? then free
-    if (ei_dsp_cont_current_frame && ei_dsp_cont_current_frame_size != frame_length_values) {
-        ei_free(ei_dsp_cont_current_frame);
-        ei_dsp_cont_current_frame = nullptr;
+    if (state->current_frame && state->current_frame_size != frame_length_values) {
+        ei_free(state->current_frame);
+        state->current_frame = nullptr;
     }
 
-    if (!ei_dsp_cont_current_frame) {
-        ei_dsp_cont_current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
-        if (!ei_dsp_cont_current_frame) {
-            if (preemphasis) {
-                delete preemphasis;
+    if (!state->current_frame) {
+        state->current_frame = (float*)ei_calloc(frame_length_values * sizeof(float), 1);
+        if (!state->current_frame) {
+            if (pre) {
+                delete pre;
             }
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
-        ei_dsp_cont_current_frame_size = frame_length_values;
-        ei_dsp_cont_current_frame_ix = 0;
+        state->current_frame_size = frame_length_values;
+        state->current_frame_ix = 0;
     }
 
     matrix_size_out->rows = 0;
@@ -995,60 +1006,60 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // this is the offset in the signal from which we'll work
     size_t offset_in_signal = 0;
 
-    if (ei_dsp_cont_current_frame_ix > (int)ei_dsp_cont_current_frame_size) {
+    if (state->current_frame_ix > (int)state->current_frame_size) {
         ei_printf("ERR: ei_dsp_cont_current_frame_ix is larger than frame size\n");
-        if (preemphasis) {
-            delete preemphasis;
+        if (pre) {
+            delete pre;
         }
         EIDSP_ERR(EIDSP_PARAMETER_INVALID);
     }
 
     // if we still have some code from previous run
-    while (ei_dsp_cont_current_frame_ix > 0) {
-        // then from the current frame we need to read `frame_length_values - ei_dsp_cont_current_frame_ix`
+    while (state->current_frame_ix > 0) {
+        // then from the current frame we need to read `frame_length_values - state->current_frame_ix`
         // starting at offset 0
-        x = preemphasized_audio_signal.get_data(0, frame_length_values - ei_dsp_cont_current_frame_ix, ei_dsp_cont_current_frame + ei_dsp_cont_current_frame_ix);
+        x = preemphasized_audio_signal.get_data(0, frame_length_values - state->current_frame_ix, state->current_frame + state->current_frame_ix);
         if (x != EIDSP_OK) {
-            if (preemphasis) {
-                delete preemphasis;
+            if (pre) {
+                delete pre;
             }
             EIDSP_ERR(x);
         }
 
-        // now ei_dsp_cont_current_frame is complete
+        // now state->current_frame is complete
         signal_t frame_signal;
-        x = numpy::signal_from_buffer(ei_dsp_cont_current_frame, frame_length_values, &frame_signal);
+        x = numpy::signal_from_buffer(state->current_frame, frame_length_values, &frame_signal);
         if (x != EIDSP_OK) {
-            if (preemphasis) {
-                delete preemphasis;
+            if (pre) {
+                delete pre;
             }
             EIDSP_ERR(x);
         }
 
         x = extract_mfe_run_slice(&frame_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
         if (x != EIDSP_OK) {
-            if (preemphasis) {
-                delete preemphasis;
+            if (pre) {
+                delete pre;
             }
             EIDSP_ERR(x);
         }
 
         // if there's overlap between frames we roll through
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::roll(state->current_frame, frame_length_values, -frame_stride_values);
         }
 
-        ei_dsp_cont_current_frame_ix -= frame_stride_values;
+        state->current_frame_ix -= frame_stride_values;
     }
 
-    if (ei_dsp_cont_current_frame_ix < 0) {
-        offset_in_signal = -ei_dsp_cont_current_frame_ix;
-        ei_dsp_cont_current_frame_ix = 0;
+    if (state->current_frame_ix < 0) {
+        offset_in_signal = -state->current_frame_ix;
+        state->current_frame_ix = 0;
     }
 
     if (offset_in_signal >= signal->total_length) {
-        if (preemphasis) {
-            delete preemphasis;
+        if (pre) {
+            delete pre;
         }
         offset_in_signal -= signal->total_length;
         return EIDSP_OK;
@@ -1063,8 +1074,8 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     // then we'll just go through normal processing of the signal:
     x = extract_mfe_run_slice(range_signal, output_matrix, &config, sampling_frequency, matrix_size_out);
     if (x != EIDSP_OK) {
-        if (preemphasis) {
-            delete preemphasis;
+        if (pre) {
+            delete pre;
         }
         EIDSP_ERR(x);
     }
@@ -1082,30 +1093,30 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
     bytes_left_end_of_frame += frame_overlap_values;
 
     if (bytes_left_end_of_frame > 0) {
-        // then read that into the ei_dsp_cont_current_frame buffer
+        // then read that into the state->current_frame buffer
         x = preemphasized_audio_signal.get_data(
             (preemphasized_audio_signal.total_length - bytes_left_end_of_frame),
             bytes_left_end_of_frame,
-            ei_dsp_cont_current_frame);
+            state->current_frame);
         if (x != EIDSP_OK) {
-            if (preemphasis) {
-                delete preemphasis;
+            if (pre) {
+                delete pre;
             }
             EIDSP_ERR(x);
         }
     }
 
-    ei_dsp_cont_current_frame_ix = bytes_left_end_of_frame;
+    state->current_frame_ix = bytes_left_end_of_frame;
 
 
     if (config.implementation_version == 1) {
-        if (first_run == true) {
+        if (state->mfe_first_run == true) {
             signal->total_length -= (size_t)(config.frame_length * (float)frequency);
         }
     }
 
-    if (preemphasis) {
-        delete preemphasis;
+    if (pre) {
+        delete pre;
     }
 
     return EIDSP_OK;
@@ -1374,14 +1385,14 @@ __attribute__((unused)) int extract_image_features_quantized(signal_t *signal, m
 /**
  * Clear all state regarding continuous audio. Invoke this function after continuous audio loop ends.
  */
-__attribute__((unused)) int ei_dsp_clear_continuous_audio_state() {
-    if (ei_dsp_cont_current_frame) {
-        ei_free(ei_dsp_cont_current_frame);
+__attribute__((unused)) int ei_dsp_clear_continuous_audio_state(ei_dsp_cont_state_t *state = &ei_dsp_cont_default_state) {
+    if (state->current_frame) {
+        ei_free(state->current_frame);
     }
 
-    ei_dsp_cont_current_frame = nullptr;
-    ei_dsp_cont_current_frame_size = 0;
-    ei_dsp_cont_current_frame_ix = 0;
+    state->current_frame = nullptr;
+    state->current_frame_size = 0;
+    state->current_frame_ix = 0;
 
     return EIDSP_OK;
 }
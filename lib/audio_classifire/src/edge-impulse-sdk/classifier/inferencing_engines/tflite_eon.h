@@ -43,6 +43,10 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 #include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+#include "edge-impulse-sdk/classifier/ei_memory_plan.h"
+#endif
 
 /**
  * Setup the TFLite runtime
@@ -51,6 +55,9 @@
  * @param      input              Pointer to input tensor
  * @param      output             Pointer to output tensor
  * @param      micro_tensor_arena Pointer to the arena that will be allocated
+ * @param      alloc_fnc          Allocator for the arena
+ * @param      instance           If set, receives a private instance of the model
+ *                                (EI_CLASSIFIER_TFLITE_REENTRANT), free with inference_tflite_teardown
  *
  * @return  EI_IMPULSE_OK if successful
  */
@@ -59,13 +66,38 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     uint64_t *ctx_start_us,
     TfLiteTensor* input,
     TfLiteTensor** outputs,
-    ei_unique_ptr_t& p_tensor_arena) {
+    ei_unique_ptr_t& p_tensor_arena,
+    void*(*alloc_fnc)(size_t, size_t) = ei_aligned_calloc,
+    void **instance = nullptr) {
 
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
     *ctx_start_us = ei_read_timer_us();
 
-    TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+    // models compiled without instance support (e.g. EON DSP blocks) use the shared one
+    if (instance && graph_config->model_create) {
+        *instance = graph_config->model_create(alloc_fnc, ei_aligned_free);
+        if (!*instance) {
+            ei_printf("Failed to initialize the model instance\n");
+            return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
+        }
+
+        if (graph_config->model_instance_input(*instance, 0, input) != kTfLiteOk) {
+            return EI_IMPULSE_TFLITE_ERROR;
+        }
+
+        for (uint8_t i = 0; i < block_config->output_tensors_size; i++) {
+            if (graph_config->model_instance_output(*instance, block_config->output_tensors_indices[i], outputs[i]) != kTfLiteOk) {
+                return EI_IMPULSE_TFLITE_ERROR;
+            }
+        }
+
+        return EI_IMPULSE_OK;
+    }
+#endif // EI_CLASSIFIER_TFLITE_REENTRANT
+
+    TfLiteStatus init_status = graph_config->model_init(alloc_fnc);
     if (init_status != kTfLiteOk) {
         ei_printf("Failed to initialize the model (error code %d)\n", init_status);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
@@ -88,6 +120,54 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     return EI_IMPULSE_OK;
 }
 
+/**
+ * Release the model set up by inference_tflite_setup
+ *
+ * @param   graph_config    Compiled graph
+ * @param   instance        Instance returned by inference_tflite_setup, or NULL
+ * @param   free_fnc        Counterpart of the arena allocator
+ *
+ * @return  Status of the model reset (or of destroying the instance)
+ */
+static TfLiteStatus inference_tflite_teardown(
+    ei_config_tflite_eon_graph_t *graph_config,
+    void *instance,
+    void (*free_fnc)(void*) = ei_aligned_free) {
+
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+    if (instance) {
+        return graph_config->model_destroy(instance, free_fnc);
+    }
+#else
+    (void)instance;
+#endif
+    return graph_config->model_reset(free_fnc);
+}
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+/**
+ * Print the per-node timing and arena usage of a compiled model
+ *
+ * @param   graph_config    Compiled graph to report on
+ * @param   instance        Instance that ran, or NULL for the shared one
+ */
+static void inference_tflite_print_layer_stats(ei_config_tflite_eon_graph_t *graph_config, void *instance) {
+    ei_printf("Profiling per layer (us total / last / max, invokes, output / persistent / scratch / heap bytes)\n");
+    for (size_t ix = 0; ix < graph_config->model_layer_count(); ix++) {
+        ei_tflite_layer_stats_t stats;
+        if (graph_config->model_layer_stats(instance, ix, &stats) != kTfLiteOk) {
+            continue;
+        }
+        ei_printf("%s,%s,%lu,%lu,%lu,%lu,%u,%u,%u,%u\n",
+            stats.tag, stats.op,
+            (unsigned long)stats.total_us, (unsigned long)stats.last_us, (unsigned long)stats.max_us,
+            (unsigned long)stats.invoke_count,
+            (unsigned int)stats.output_bytes, (unsigned int)stats.persistent_bytes,
+            (unsigned int)stats.scratch_bytes, (unsigned int)stats.overflow_bytes);
+    }
+}
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+
 /**
  * Run TFLite model
  *
@@ -97,6 +177,7 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
  * @param   tensor_arena    Allocated arena (will be freed)
  * @param   result          Struct for results
  * @param   debug           Whether to print debug info
+ * @param   instance        Model instance from inference_tflite_setup, or NULL
  *
  * @return  EI_IMPULSE_OK if successful
  */
@@ -107,11 +188,22 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     TfLiteTensor** outputs,
     uint8_t* tensor_arena,
     ei_impulse_result_t *result,
-    bool debug) {
+    bool debug,
+    void *instance = nullptr) {
 
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    if (graph_config->model_invoke() != kTfLiteOk) {
+    TfLiteStatus invoke_status;
+    {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_INVOKE);
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+        invoke_status = instance ? graph_config->model_instance_invoke(instance) : graph_config->model_invoke();
+#else
+        (void)instance;
+        invoke_status = graph_config->model_invoke();
+#endif
+    }
+    if (invoke_status != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
@@ -122,6 +214,12 @@ static EI_IMPULSE_ERROR inference_tflite_run(
 
     EI_LOGD("Predictions (time: %d ms.):\n", result->timing.classification);
 
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+    if (debug) {
+        inference_tflite_print_layer_stats(graph_config, instance);
+    }
+#endif
+
     if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
         return EI_IMPULSE_CANCELED;
     }
@@ -152,34 +250,46 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+    void *instance = nullptr;
 
     EI_IMPULSE_ERROR init_res = inference_tflite_setup(
         block_config,
         &ctx_start_us,
         &input,
         &outputs,
-        p_tensor_arena);
+        p_tensor_arena,
+        ei_aligned_calloc,
+        &instance);
 
     if (init_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(graph_config, instance);
         return init_res;
     }
 
     auto input_res = fill_input_tensor_from_signal(signal, &input);
     if (input_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(graph_config, instance);
         return input_res;
     }
 
     // invoke the model
-    if (graph_config->model_invoke() != kTfLiteOk) {
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+    TfLiteStatus invoke_status = instance ? graph_config->model_instance_invoke(instance) : graph_config->model_invoke();
+#else
+    TfLiteStatus invoke_status = graph_config->model_invoke();
+#endif
+    if (invoke_status != kTfLiteOk) {
+        inference_tflite_teardown(graph_config, instance);
         return EI_IMPULSE_TFLITE_ERROR;
     }
 
     auto output_res = fill_output_matrix_from_tensor(&outputs[0], output_matrix);
+    TfLiteStatus teardown_status = inference_tflite_teardown(graph_config, instance);
     if (output_res != EI_IMPULSE_OK) {
         return output_res;
     }
 
-    if (graph_config->model_reset(ei_aligned_free) != kTfLiteOk) {
+    if (teardown_status != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
     ei_free(outputs);
@@ -187,6 +297,57 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     return EI_IMPULSE_OK;
 }
 
+/**
+ * Copy the output tensors into the raw outputs of a result
+ *
+ * @param   outputs             Output tensors of the model
+ * @param   learn_block_index   Index of the first raw output to fill
+ * @param   result              Struct for results
+ *
+ * @return  EI_IMPULSE_OK if successful
+ */
+static EI_IMPULSE_ERROR inference_tflite_copy_outputs(
+    ei_learning_block_config_tflite_graph_t *block_config,
+    TfLiteTensor *outputs,
+    uint32_t learn_block_index,
+    ei_impulse_result_t *result) {
+
+    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
+        TfLiteTensor* output = &outputs[output_ix];
+        // calculate the size of the output by iterating through dims
+        size_t output_size = 1;
+        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
+            output_size *= output->dims->data[dim_num];
+        }
+
+        switch (output->type) {
+            case kTfLiteFloat32: {
+                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
+                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
+                break;
+            }
+            case kTfLiteInt8: {
+                result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
+                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
+                break;
+            }
+            case kTfLiteUInt8: {
+                result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
+                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
+                break;
+            }
+            default: {
+                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
+                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
+            }
+        }
+
+        result->_raw_outputs[learn_block_index].blockId = block_config->block_id;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
 /**
  * @brief      Do neural network inferencing over a feature matrix
  *
@@ -217,20 +378,60 @@ EI_IMPULSE_ERROR run_nn_inference(
 
     uint64_t ctx_start_us = ei_read_timer_us();
     ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+    void *instance = nullptr;
 
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+    // the arena goes into the planned slot, if the features were planned as well
     EI_IMPULSE_ERROR init_res = inference_tflite_setup(
         block_config,
         &ctx_start_us,
         &input,
         &outputs,
-        p_tensor_arena);
+        p_tensor_arena,
+        ei_memory_plan_arena_alloc);
+#else
+    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+        block_config,
+        &ctx_start_us,
+        &input,
+        &outputs,
+        p_tensor_arena,
+        ei_aligned_calloc,
+        &instance);
+#endif
 
     if (init_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(graph_config, instance);
         return init_res;
     }
 
     uint8_t* tensor_arena = static_cast<uint8_t*>(p_tensor_arena.get());
 
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    // usage is only tracked for the shared instance
+    if (graph_config->model_arena_usage && !instance) {
+        graph_config->model_arena_usage(&result->memory.arena_used_bytes,
+                                        &result->memory.arena_size_bytes,
+                                        &result->memory.arena_overflow_bytes);
+    }
+#endif
+
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+    EI_IMPULSE_ERROR input_res;
+    if (input_block_ids_size == impulse->dsp_blocks_size && fmatrix[0].matrix &&
+            ei_memory_plan_is_handoff(&input, fmatrix[0].matrix->buffer)) {
+        input_res = fill_input_tensor_in_place(fmatrix[0].matrix->buffer, impulse->nn_input_frame_size, &input);
+    }
+    else {
+        input_res = fill_input_tensor_from_matrix(fmatrix,
+                                                  result->_raw_outputs,
+                                                  &input,
+                                                  input_block_ids,
+                                                  input_block_ids_size,
+                                                  impulse->dsp_blocks_size,
+                                                  impulse->learning_blocks_size);
+    }
+#else
     auto input_res = fill_input_tensor_from_matrix(fmatrix,
                                                    result->_raw_outputs,
                                                    &input,
@@ -238,8 +439,10 @@ EI_IMPULSE_ERROR run_nn_inference(
                                                    input_block_ids_size,
                                                    impulse->dsp_blocks_size,
                                                    impulse->learning_blocks_size);
+#endif
 
     if (input_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(graph_config, instance);
         return input_res;
     }
 
@@ -248,51 +451,229 @@ EI_IMPULSE_ERROR run_nn_inference(
         block_config,
         ctx_start_us,
         &outputs,
-        tensor_arena, result, debug);
+        tensor_arena, result, debug, instance);
 
-    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
-        TfLiteTensor* output = &outputs[output_ix];
-        // calculate the size of the output by iterating through dims
-        size_t output_size = 1;
-        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
-            output_size *= output->dims->data[dim_num];
-        }
+    EI_IMPULSE_ERROR output_res = inference_tflite_copy_outputs(block_config, outputs, learn_block_index, result);
 
-        switch (output->type) {
-            case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
-                break;
-            }
-            case kTfLiteInt8: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
-                break;
-            }
-            case kTfLiteUInt8: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
-                break;
-            }
-            default: {
-                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
-                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
-            }
-        }
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+    TfLiteStatus teardown_status = inference_tflite_teardown(graph_config, instance, ei_memory_plan_arena_free);
+#else
+    TfLiteStatus teardown_status = inference_tflite_teardown(graph_config, instance);
+#endif
+    ei_free(outputs);
 
-        result->_raw_outputs[learn_block_index].blockId = block_config->block_id;
+    if (output_res != EI_IMPULSE_OK) {
+        return output_res;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
-
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
     }
 
+    if (teardown_status != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+typedef struct {
+    const ei_impulse_t *impulse;
+    ei_learning_block_config_tflite_graph_t *block_config;
+    TfLiteTensor *input;
+    TfLiteTensor *outputs;
+    uint32_t learn_block_index;
+    uint32_t *input_block_ids;
+    uint32_t input_block_ids_size;
+    ei_impulse_result_t *results;
+    EI_IMPULSE_ERROR (*features_fn)(void *user, size_t ix, ei_feature_t **fmatrix);
+    EI_IMPULSE_ERROR (*result_fn)(void *user, size_t ix);
+    void *user;
+    EI_IMPULSE_ERROR error;
+    uint64_t callbacks_us;
+} ei_tflite_batch_ctx_t;
+
+static TfLiteStatus inference_tflite_batch_input(void *user, size_t ix) {
+    ei_tflite_batch_ctx_t *ctx = (ei_tflite_batch_ctx_t*)user;
+    uint64_t start_us = ei_read_timer_us();
+
+    ei_feature_t *fmatrix = nullptr;
+    ctx->error = ctx->features_fn(ctx->user, ix, &fmatrix);
+    if (ctx->error == EI_IMPULSE_OK) {
+        ctx->error = fill_input_tensor_from_matrix(fmatrix,
+                                                   ctx->results[ix]._raw_outputs,
+                                                   ctx->input,
+                                                   ctx->input_block_ids,
+                                                   ctx->input_block_ids_size,
+                                                   ctx->impulse->dsp_blocks_size,
+                                                   ctx->impulse->learning_blocks_size);
+    }
+
+    ctx->callbacks_us += ei_read_timer_us() - start_us;
+    return ctx->error == EI_IMPULSE_OK ? kTfLiteOk : kTfLiteError;
+}
+
+static TfLiteStatus inference_tflite_batch_output(void *user, size_t ix) {
+    ei_tflite_batch_ctx_t *ctx = (ei_tflite_batch_ctx_t*)user;
+    uint64_t start_us = ei_read_timer_us();
+
+    ctx->error = inference_tflite_copy_outputs(ctx->block_config, ctx->outputs, ctx->learn_block_index, &ctx->results[ix]);
+    if (ctx->error == EI_IMPULSE_OK) {
+        ctx->error = ctx->result_fn(ctx->user, ix);
+    }
+
+    ctx->callbacks_us += ei_read_timer_us() - start_us;
+    return ctx->error == EI_IMPULSE_OK ? kTfLiteOk : kTfLiteError;
+}
+
+/**
+ * @brief      Do neural network inferencing over several inputs with one model setup,
+ *             reading the weights of the layers the model batches once per chunk of inputs
+ *
+ * @param      count        Number of results to produce
+ * @param      results      Output classifier results, _raw_outputs must be set
+ * @param      features_fn  Returns the features of result ix, they only have to stay
+ *                          valid until the next call
+ * @param      result_fn    Called once the raw outputs of result ix are filled
+ * @param[in]  debug        Debug output enable
+ *
+ * @return     The ei impulse error.
+ */
+EI_IMPULSE_ERROR run_nn_inference_batch(
+    const ei_impulse_t *impulse,
+    uint32_t learn_block_index,
+    size_t count,
+    ei_impulse_result_t *results,
+    EI_IMPULSE_ERROR (*features_fn)(void *user, size_t ix, ei_feature_t **fmatrix),
+    EI_IMPULSE_ERROR (*result_fn)(void *user, size_t ix),
+    void *user,
+    bool debug = false)
+{
+    ei_learning_block_t block = impulse->learning_blocks[learn_block_index];
+    ei_learning_block_config_tflite_graph_t *block_config = (ei_learning_block_config_tflite_graph_t*)block.config;
+    ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    if (!graph_config->model_invoke_batch) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+
+    TfLiteTensor input;
+    TfLiteTensor *outputs = (TfLiteTensor*)ei_malloc(block_config->output_tensors_size * sizeof(TfLiteTensor));
+    if (!outputs) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    uint64_t ctx_start_us;
+    ei_unique_ptr_t p_tensor_arena(nullptr, ei_aligned_free);
+    void *instance = nullptr;
+
+    EI_IMPULSE_ERROR init_res = inference_tflite_setup(
+        block_config,
+        &ctx_start_us,
+        &input,
+        &outputs,
+        p_tensor_arena,
+        ei_aligned_calloc,
+        &instance);
+
+    if (init_res != EI_IMPULSE_OK) {
+        inference_tflite_teardown(graph_config, instance);
+        ei_free(outputs);
+        return init_res;
+    }
+
+    ei_tflite_batch_ctx_t ctx = {
+        impulse, block_config, &input, outputs, learn_block_index,
+        (uint32_t*)block.input_block_ids, block.input_block_ids_size,
+        results, features_fn, result_fn, user, EI_IMPULSE_OK, 0
+    };
+
+    TfLiteStatus invoke_status;
+    {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_INVOKE);
+        invoke_status = graph_config->model_invoke_batch(instance, count,
+            inference_tflite_batch_input, inference_tflite_batch_output, &ctx);
+    }
+
+    // DSP and postprocessing ran inside the callbacks, the rest is shared out evenly
+    uint64_t model_us = ei_read_timer_us() - ctx_start_us - ctx.callbacks_us;
+    for (size_t ix = 0; ix < count; ix++) {
+        results[ix].timing.classification_us = model_us / count;
+        results[ix].timing.classification = (int)(results[ix].timing.classification_us / 1000);
+    }
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+    if (debug) {
+        inference_tflite_print_layer_stats(graph_config, instance);
+    }
+#else
+    (void)debug;
+#endif
+
+    TfLiteStatus teardown_status = inference_tflite_teardown(graph_config, instance);
+    ei_free(outputs);
+
+    if (ctx.error != EI_IMPULSE_OK) {
+        return ctx.error;
+    }
+    if (invoke_status != kTfLiteOk || teardown_status != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
     return EI_IMPULSE_OK;
 }
 
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+static ei_config_tflite_eon_graph_t *inference_tflite_eon_graph(const ei_impulse_t *impulse, uint32_t learn_block_index) {
+    if (learn_block_index >= impulse->learning_blocks_size ||
+            impulse->learning_blocks[learn_block_index].infer_fn != run_nn_inference) {
+        return nullptr;
+    }
+    ei_learning_block_config_tflite_graph_t *block_config =
+        (ei_learning_block_config_tflite_graph_t*)impulse->learning_blocks[learn_block_index].config;
+    return (ei_config_tflite_eon_graph_t*)block_config->graph_config;
+}
+
+/**
+ * Attach an early exit head to a learning block, nullptr detaches it
+ *
+ * @param   head    Must outlive its use, it is not copied
+ *
+ * @return  EI_IMPULSE_OK if successful
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR inference_tflite_set_early_exit(
+    const ei_impulse_t *impulse,
+    uint32_t learn_block_index,
+    const ei_tflite_early_exit_head_t *head) {
+
+    ei_config_tflite_eon_graph_t *graph_config = inference_tflite_eon_graph(impulse, learn_block_index);
+    if (!graph_config || !graph_config->model_set_early_exit) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+    return graph_config->model_set_early_exit(head) == kTfLiteOk ? EI_IMPULSE_OK : EI_IMPULSE_TFLITE_ERROR;
+}
+
+/**
+ * Read (and optionally clear) the early exit counters of a learning block
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR inference_tflite_early_exit_stats(
+    const ei_impulse_t *impulse,
+    uint32_t learn_block_index,
+    ei_tflite_early_exit_stats_t *stats,
+    bool reset = false) {
+
+    ei_config_tflite_eon_graph_t *graph_config = inference_tflite_eon_graph(impulse, learn_block_index);
+    if (!graph_config || !graph_config->model_early_exit_stats) {
+        return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+    }
+    graph_config->model_early_exit_stats(stats);
+    if (reset) {
+        graph_config->model_reset_early_exit_stats();
+    }
+    return EI_IMPULSE_OK;
+}
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
 #if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
 /**
  * Special function to run the classifier on images, only works on TFLite models (either interpreter or EON or for tensaiflow)
@@ -375,46 +756,23 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result,
         debug);
 
-    for (uint32_t output_ix = 0; output_ix < block_config->output_tensors_size; output_ix++) {
-        TfLiteTensor* output = &outputs[output_ix];
-        // calculate the size of the output by iterating through dims
-        size_t output_size = 1;
-        for (int dim_num = 0; dim_num < output->dims->size; dim_num++) {
-            output_size *= output->dims->data[dim_num];
-        }
+    EI_IMPULSE_ERROR output_res = inference_tflite_copy_outputs(block_config, outputs, learn_block_index, result);
 
-        switch (output->type) {
-            case kTfLiteFloat32: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix = new matrix_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix->buffer, output->data.f, output->bytes);
-                break;
-            }
-            case kTfLiteInt8: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix_i8 = new matrix_i8_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_i8->buffer, output->data.int8, output->bytes);
-                break;
-            }
-            case kTfLiteUInt8: {
-                result->_raw_outputs[learn_block_index + output_ix].matrix_u8 = new matrix_u8_t(1, output_size);
-                memcpy(result->_raw_outputs[learn_block_index + output_ix].matrix_u8->buffer, output->data.uint8, output->bytes);
-                break;
-            }
-            default: {
-                ei_printf("ERR: Cannot handle output type (%d)\n", output->type);
-                return EI_IMPULSE_OUTPUT_TENSOR_WAS_NULL;
-            }
-        }
+    TfLiteStatus reset_status = graph_config->model_reset(ei_aligned_free);
+    ei_free(outputs);
 
-        result->_raw_outputs[learn_block_index].blockId = block_config->block_id;
+    if (output_res != EI_IMPULSE_OK) {
+        return output_res;
     }
 
-    graph_config->model_reset(ei_aligned_free);
-    ei_free(outputs);
-
     if (run_res != EI_IMPULSE_OK) {
         return run_res;
     }
 
+    if (reset_status != kTfLiteOk) {
+        return EI_IMPULSE_TFLITE_ERROR;
+    }
+
     return EI_IMPULSE_OK;
 }
 #endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1
@@ -36,6 +36,7 @@
 #define _EI_CLASSIFIER_INFERENCING_ENGINE_TFLITE_HELPER_H_
 
 #include "edge-impulse-sdk/classifier/ei_quantize.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
 #if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_FULL) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSORRT) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_TIDL)
 
 #if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_FULL) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_TIDL)
@@ -63,6 +64,8 @@ EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
     size_t fmtx_size,
     size_t omtx_size
 ) {
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_QUANTIZE);
+
     size_t matrix_els = 0;
     uint32_t input_idx = 0;
 
@@ -121,6 +124,60 @@ EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
     return EI_IMPULSE_OK;
 }
 
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+/**
+ * Fill an input tensor that aliases the tail of the features (see
+ * classifier/ei_memory_plan.h). Quantizes back to front, so every byte
+ * written was already read as long as the tensor starts at or after the
+ * last input->bytes / count-th of the features.
+ */
+EI_IMPULSE_ERROR fill_input_tensor_in_place(
+    const float *features,
+    size_t count,
+    TfLiteTensor *input
+) {
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_QUANTIZE);
+
+    switch (input->type) {
+        case kTfLiteFloat32: {
+            if (input->bytes != count * sizeof(float)) {
+                return EI_IMPULSE_INVALID_SIZE;
+            }
+            memmove(input->data.f, features, input->bytes);
+            break;
+        }
+        case kTfLiteInt8: {
+            if (input->bytes != count) {
+                return EI_IMPULSE_INVALID_SIZE;
+            }
+            for (size_t ix = count; ix-- > 0; ) {
+                float val = features[ix];
+                input->data.int8[ix] = static_cast<int8_t>(
+                    pre_cast_quantize(val, input->params.scale, input->params.zero_point, true));
+            }
+            break;
+        }
+        case kTfLiteUInt8: {
+            if (input->bytes != count) {
+                return EI_IMPULSE_INVALID_SIZE;
+            }
+            for (size_t ix = count; ix-- > 0; ) {
+                float val = features[ix];
+                input->data.uint8[ix] = static_cast<uint8_t>(
+                    pre_cast_quantize(val, input->params.scale, input->params.zero_point, false));
+            }
+            break;
+        }
+        default: {
+            ei_printf("ERR: Cannot handle input type (%d)\n", input->type);
+            return EI_IMPULSE_INPUT_TENSOR_WAS_NULL;
+        }
+    }
+
+    return EI_IMPULSE_OK;
+}
+#endif // EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+
 EI_IMPULSE_ERROR fill_input_tensor_from_signal(
     signal_t *signal,
     TfLiteTensor *input
@@ -218,7 +218,11 @@ static EI_IMPULSE_ERROR inference_tflite_run(
     void* micro_profiler) {
 
     // Run inference, and report any error
-    TfLiteStatus invoke_status = interpreter->Invoke();
+    TfLiteStatus invoke_status;
+    {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_INVOKE);
+        invoke_status = interpreter->Invoke();
+    }
     if (invoke_status != kTfLiteOk) {
         delete interpreter;
         ei_printf("Invoke failed (%d)\n", invoke_status);
@@ -297,7 +301,11 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
     }
 
     // Run inference, and report any error
-    TfLiteStatus invoke_status = interpreter->Invoke();
+    TfLiteStatus invoke_status;
+    {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_INVOKE);
+        invoke_status = interpreter->Invoke();
+    }
     if (invoke_status != kTfLiteOk) {
         ei_printf("Invoke failed (%d)\n", invoke_status);
         return EI_IMPULSE_TFLITE_ERROR;
@@ -43,6 +43,7 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "model-parameters/model_metadata.h"
 #include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_top_k.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 
 /* Private const types ----------------------------------------------------- */
@@ -281,9 +282,11 @@ EI_IMPULSE_ERROR process_perfcal(ei_impulse_handle_t *handle,
                 has_printed_msg = true;
             }
 
+            ei_classifier_dequantize(result);
             int label_detected = perf_cal->trigger(result->classification);
 
             if (perf_cal->should_boost()) {
+                ei_classifier_drop_quantized(result);
                 for (int i = 0; i < impulse->label_count; i++) {
                     if (i == label_detected) {
                         result->classification[i].value = 1.0f;
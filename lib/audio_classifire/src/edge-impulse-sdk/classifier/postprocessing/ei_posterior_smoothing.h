@@ -0,0 +1,290 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_POSTERIOR_SMOOTHING_H
+#define EI_POSTERIOR_SMOOTHING_H
+
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+
+/* Includes ---------------------------------------------------------------- */
+#include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/dsp/returntypes.hpp"
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_top_k.h"
+
+/**
+ * Streaming smoothing of classification scores with event detection.
+ *
+ * Every result is averaged into per-label smoothed scores, either exponentially or
+ * over the last window_size results with running sums (recomputed once per window
+ * so rounding does not build up). A label raises an event when its smoothed score
+ * reaches onset_threshold, and it cannot raise another one until the score fell
+ * below release_threshold and its suppression time has passed. At most one event
+ * (the highest score) is raised per result.
+ *
+ * The output lands in result->postprocessed_output.smoothing_output: the smoothed
+ * scores, the event raised by this result (event_label -1 if none) with the
+ * ei_read_timer_ms() time it was raised at, and the label that is currently held.
+ *
+ * All memory is allocated by init_smoothing(), a result costs O(labels).
+ */
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    uint32_t n_labels;
+    uint32_t count;                 // results averaged so far (up to window_size)
+    uint32_t window_ix;
+    float *smoothed;                // smoothed scores (exponential) or running sums (window)
+    float *history;                 // window_size results of n_labels scores (window)
+    uint64_t *suppressed_until_ms;
+    bool *active;
+} ei_smoothing_state_t;
+
+/* Private functions ------------------------------------------------------- */
+static void free_smoothing_state(ei_smoothing_state_t *state)
+{
+    if (state == NULL) {
+        return;
+    }
+    ei_free(state->smoothed);
+    ei_free(state->history);
+    ei_free(state->suppressed_until_ms);
+    ei_free(state->active);
+    ei_free(state);
+}
+
+/**
+ * Forget all results and events, e.g. when the stream restarts
+ */
+static void reset_smoothing_state(ei_smoothing_state_t *state, const ei_smoothing_config_t *config)
+{
+    state->count = 0;
+    state->window_ix = 0;
+    memset(state->smoothed, 0, state->n_labels * sizeof(float));
+    if (state->history) {
+        memset(state->history, 0, config->window_size * state->n_labels * sizeof(float));
+    }
+    memset(state->suppressed_until_ms, 0, state->n_labels * sizeof(uint64_t));
+    memset(state->active, 0, state->n_labels * sizeof(bool));
+}
+
+/* Public functions -------------------------------------------------------- */
+EI_IMPULSE_ERROR init_smoothing(ei_impulse_handle_t *handle, void **state, void *config_ptr)
+{
+    const ei_impulse_t *impulse = handle->impulse;
+    const ei_smoothing_config_t *config = (ei_smoothing_config_t*)config_ptr;
+
+    if ((config->mode == EI_SMOOTHING_WINDOW) && (config->window_size == 0)) {
+        ei_printf("ERR: Smoothing window_size must be at least 1\n");
+        return EI_IMPULSE_POSTPROCESSING_ERROR;
+    }
+
+    ei_smoothing_state_t *s = (ei_smoothing_state_t*)ei_calloc(1, sizeof(ei_smoothing_state_t));
+    if (s == NULL) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    s->n_labels = impulse->label_count;
+    s->smoothed = (float*)ei_calloc(s->n_labels, sizeof(float));
+    s->suppressed_until_ms = (uint64_t*)ei_calloc(s->n_labels, sizeof(uint64_t));
+    s->active = (bool*)ei_calloc(s->n_labels, sizeof(bool));
+    if (config->mode == EI_SMOOTHING_WINDOW) {
+        s->history = (float*)ei_calloc(config->window_size * s->n_labels, sizeof(float));
+    }
+
+    if ((s->smoothed == NULL) || (s->suppressed_until_ms == NULL) || (s->active == NULL) ||
+            ((config->mode == EI_SMOOTHING_WINDOW) && (s->history == NULL))) {
+        free_smoothing_state(s);
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+
+    *state = (void *)s;
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR deinit_smoothing(void *state, void *config)
+{
+    free_smoothing_state((ei_smoothing_state_t*)state);
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR process_smoothing(ei_impulse_handle_t *handle,
+                                   uint32_t block_index,
+                                   uint32_t input_block_id,
+                                   ei_impulse_result_t *result,
+                                   void *config_ptr,
+                                   void *state)
+{
+    ei_smoothing_state_t *s = (ei_smoothing_state_t*)state;
+    const ei_smoothing_config_t *config = (ei_smoothing_config_t*)config_ptr;
+    ei_smoothing_output_t *out = &result->postprocessed_output.smoothing_output;
+
+    out->event_label = -1;
+    out->event_value = 0.0f;
+    out->event_timestamp_ms = 0;
+    out->active_label = -1;
+
+    ei_classifier_dequantize(result);
+
+    // not set up by run_classifier_init(), e.g. single windows through run_classifier()
+    if (s == NULL) {
+        for (uint32_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
+            out->value[ix] = result->classification[ix].value;
+        }
+        return EI_IMPULSE_OK;
+    }
+
+    if (config->mode == EI_SMOOTHING_WINDOW) {
+        float *slot = s->history + (s->window_ix * s->n_labels);
+        for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+            s->smoothed[ix] += result->classification[ix].value - slot[ix];
+            slot[ix] = result->classification[ix].value;
+        }
+        if (s->count < config->window_size) {
+            s->count++;
+        }
+        if (++s->window_ix == config->window_size) {
+            s->window_ix = 0;
+            // once per window, so the cost per result stays O(labels)
+            for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+                float sum = 0.0f;
+                for (uint32_t w = 0; w < config->window_size; w++) {
+                    sum += s->history[(w * s->n_labels) + ix];
+                }
+                s->smoothed[ix] = sum;
+            }
+        }
+        for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+            out->value[ix] = s->smoothed[ix] / s->count;
+        }
+    }
+    else {
+        for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+            float value = result->classification[ix].value;
+            s->smoothed[ix] = (s->count == 0) ? value : s->smoothed[ix] + config->alpha * (value - s->smoothed[ix]);
+            out->value[ix] = s->smoothed[ix];
+        }
+        s->count = 1;
+    }
+
+    const uint64_t now_ms = ei_read_timer_ms();
+    int32_t event_label = -1;
+    float event_value = 0.0f;
+
+    for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+        if (s->active[ix]) {
+            if (out->value[ix] < config->release_threshold) {
+                s->active[ix] = false;
+            }
+            continue;
+        }
+        if ((config->ignore_flags & (1u << ix)) || (now_ms < s->suppressed_until_ms[ix])) {
+            continue;
+        }
+        if ((out->value[ix] >= config->onset_threshold) && (out->value[ix] > event_value)) {
+            event_label = (int32_t)ix;
+            event_value = out->value[ix];
+        }
+    }
+
+    if (event_label >= 0) {
+        uint32_t suppression_ms = config->label_suppression_ms ?
+            config->label_suppression_ms[event_label] : config->suppression_ms;
+        s->active[event_label] = true;
+        s->suppressed_until_ms[event_label] = now_ms + suppression_ms;
+        out->event_label = event_label;
+        out->event_value = event_value;
+        out->event_timestamp_ms = now_ms;
+    }
+
+    float active_value = 0.0f;
+    for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+        if (s->active[ix] && (out->value[ix] >= active_value)) {
+            out->active_label = (int32_t)ix;
+            active_value = out->value[ix];
+        }
+    }
+
+    if (config->replace_scores) {
+        for (uint32_t ix = 0; ix < s->n_labels; ix++) {
+            result->classification[ix].value = out->value[ix];
+        }
+        ei_classifier_drop_quantized(result);
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR display_smoothing(ei_impulse_result_t *result, void *config)
+{
+    const ei_smoothing_output_t *out = &result->postprocessed_output.smoothing_output;
+
+    if (out->event_label >= 0) {
+        ei_printf("Event: %s (", result->classification[out->event_label].label);
+        ei_printf_float(out->event_value);
+        ei_printf(") at %lu ms\r\n", (unsigned long)out->event_timestamp_ms);
+    }
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Forget the smoothed scores and events kept in a postprocessing state
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_smoothing_reset_state(ei_impulse_handle_t *handle, void **state)
+{
+    int16_t block_number = get_block_number(handle, (void*)init_smoothing);
+    if ((block_number == -1) || (state == NULL) || (state[block_number] == NULL)) {
+        return EI_IMPULSE_POSTPROCESSING_ERROR;
+    }
+
+    reset_smoothing_state((ei_smoothing_state_t*)state[block_number],
+        (const ei_smoothing_config_t*)handle->impulse->postprocessing_blocks[block_number].config);
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * Forget the smoothed scores and events of the handle (streams set up with
+ * run_classifier_init(ctx, handle) keep their own, see ei_smoothing_reset(ctx))
+ */
+__attribute__((unused)) static EI_IMPULSE_ERROR ei_smoothing_reset(ei_impulse_handle_t *handle)
+{
+    return ei_smoothing_reset_state(handle, handle->post_processing_state);
+}
+
+#endif // EI_CLASSIFIER_SMOOTHING_ENABLED
+
+#endif // EI_POSTERIOR_SMOOTHING_H
@@ -36,6 +36,8 @@
 #define EI_POSTPROCESSING_H
 
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
 
 #if EI_CLASSIFIER_CALIBRATION_ENABLED
 #include "edge-impulse-sdk/classifier/postprocessing/ei_performance_calibration.h"
@@ -45,17 +47,34 @@
 #include "edge-impulse-sdk/classifier/postprocessing/ei_object_tracking.h"
 #endif
 
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+#include "edge-impulse-sdk/classifier/postprocessing/ei_posterior_smoothing.h"
+#endif
+
 #if EI_CLASSIFIER_OBJECT_COUNTING_ENABLED
 #include "edge-impulse-sdk/classifier/postprocessing/ei_object_tracking.h"
 #include "edge-impulse-sdk/classifier/postprocessing/ei_object_counting.h"
 #endif
 
-extern "C" EI_IMPULSE_ERROR init_postprocessing(ei_impulse_handle_t *handle) {
+static EI_IMPULSE_ERROR deinit_postprocessing_state(ei_impulse_handle_t *handle, void ***state);
+
+/**
+ * Set up the state of every postprocessing block of the impulse in *state, which is the
+ * handle's own (init_postprocessing()) or that of one continuous stream. A state that is
+ * still set up is released first.
+ */
+static EI_IMPULSE_ERROR init_postprocessing_state(ei_impulse_handle_t *handle, void ***state) {
     if (!handle) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
+    if (*state != NULL) {
+        deinit_postprocessing_state(handle, state);
+    }
     auto impulse = handle->impulse;
-    handle->post_processing_state = (void **)ei_malloc(impulse->postprocessing_blocks_size * sizeof(void *));
+    *state = (void **)ei_calloc(impulse->postprocessing_blocks_size, sizeof(void *));
+    if ((*state == NULL) && (impulse->postprocessing_blocks_size > 0)) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
 
     for (size_t i = 0; i < impulse->postprocessing_blocks_size; i++) {
 
@@ -63,7 +82,7 @@ extern "C" EI_IMPULSE_ERROR init_postprocessing(ei_impulse_handle_t *handle) {
             continue;
         }
 
-        EI_IMPULSE_ERROR res = impulse->postprocessing_blocks[i].init_fn(handle, &handle->post_processing_state[i], impulse->postprocessing_blocks[i].config);
+        EI_IMPULSE_ERROR res = impulse->postprocessing_blocks[i].init_fn(handle, &(*state)[i], impulse->postprocessing_blocks[i].config);
         if (res != EI_IMPULSE_OK) {
             return res;
         }
@@ -72,44 +91,66 @@ extern "C" EI_IMPULSE_ERROR init_postprocessing(ei_impulse_handle_t *handle) {
     return EI_IMPULSE_OK;
 }
 
-extern "C" EI_IMPULSE_ERROR deinit_postprocessing(ei_impulse_handle_t *handle) {
+static EI_IMPULSE_ERROR deinit_postprocessing_state(ei_impulse_handle_t *handle, void ***state) {
     if (!handle) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
     auto impulse = handle->impulse;
 
     for (size_t i = 0; i < impulse->postprocessing_blocks_size; i++) {
-        void* state = NULL;
-        if (handle->post_processing_state != NULL) {
-            state = handle->post_processing_state[i];
+        void* block_state = NULL;
+        if (*state != NULL) {
+            block_state = (*state)[i];
         }
 
         if (impulse->postprocessing_blocks[i].deinit_fn == nullptr) {
             continue;
         }
 
-        EI_IMPULSE_ERROR res = impulse->postprocessing_blocks[i].deinit_fn(state, impulse->postprocessing_blocks[i].config);
+        EI_IMPULSE_ERROR res = impulse->postprocessing_blocks[i].deinit_fn(block_state, impulse->postprocessing_blocks[i].config);
         if (res != EI_IMPULSE_OK) {
             return res;
         }
     }
-    ei_free(handle->post_processing_state);
-    handle->post_processing_state = NULL;
+    ei_free(*state);
+    *state = NULL;
 
     return EI_IMPULSE_OK;
 }
 
-extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
-                                               ei_impulse_result_t *result) {
+extern "C" EI_IMPULSE_ERROR init_postprocessing(ei_impulse_handle_t *handle) {
+    if (!handle) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    return init_postprocessing_state(handle, &handle->post_processing_state);
+}
+
+extern "C" EI_IMPULSE_ERROR deinit_postprocessing(ei_impulse_handle_t *handle) {
+    if (!handle) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    return deinit_postprocessing_state(handle, &handle->post_processing_state);
+}
+
+/**
+ * Run the postprocessing blocks with the given state (see init_postprocessing_state()),
+ * NULL runs them without state
+ */
+static EI_IMPULSE_ERROR run_postprocessing_state(ei_impulse_handle_t *handle,
+                                                 void **state,
+                                                 ei_impulse_result_t *result) {
+    EI_PROFILE_ZONE(EI_PROFILER_ZONE_POSTPROCESS);
+    EI_MEM_STAGE(&result->memory.postprocessing);
+
     if (!handle) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
     auto impulse = handle->impulse;
 
     for (size_t ix = 0; ix < impulse->postprocessing_blocks_size; ix++) {
-        void* state = NULL;
-        if (handle->post_processing_state != NULL) {
-            state = handle->post_processing_state[ix];
+        void* block_state = NULL;
+        if (state != NULL) {
+            block_state = state[ix];
         }
 
         EI_IMPULSE_ERROR res = impulse->postprocessing_blocks[ix].postprocess_fn(handle,
@@ -117,7 +158,7 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
                                                                                 impulse->postprocessing_blocks[ix].input_block_id,
                                                                                 result,
                                                                                 impulse->postprocessing_blocks[ix].config,
-                                                                                state);
+                                                                                block_state);
         if (res != EI_IMPULSE_OK) {
             return res;
         }
@@ -134,6 +175,14 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
     return EI_IMPULSE_OK;
 }
 
+extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
+                                               ei_impulse_result_t *result) {
+    if (!handle) {
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    return run_postprocessing_state(handle, handle->post_processing_state, result);
+}
+
 extern "C" EI_IMPULSE_ERROR display_postprocessing(ei_impulse_handle_t *handle,
                                                    ei_impulse_result_t *result) {
     if (!handle) {
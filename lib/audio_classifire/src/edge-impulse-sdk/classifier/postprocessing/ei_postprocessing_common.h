@@ -300,6 +300,9 @@ EI_IMPULSE_ERROR process_classification_f32(ei_impulse_handle_t *handle,
         return EI_IMPULSE_POSTPROCESSING_ERROR;
     }
 
+    // float scores only, top-k falls back to them
+    result->quantized.count = 0;
+
     for (uint32_t ix = 0; ix < stop_count; ix++) {
         float value = raw_output_mtx->buffer[ix];
 
@@ -334,7 +337,17 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_classification_i8(ei_imp
     ei::matrix_i8_t* raw_output_mtx = NULL;
     find_mtx_by_idx(result->_raw_outputs, &raw_output_mtx, input_block_id, impulse->learning_blocks_size);
 
+    // keep the scores as they are, top-k and thresholds can work on them directly
+    result->quantized.zero_point = config->zero_point;
+    result->quantized.scale = config->scale;
+    result->quantized.count = impulse->label_count;
+    result->quantized.dequantized = !EI_CLASSIFIER_LAZY_DEQUANTIZE;
+
     for (uint32_t ix = 0; ix < impulse->label_count; ix++) {
+        result->quantized.value[ix] = raw_output_mtx->buffer[ix];
+        result->classification[ix].label = impulse->categories[ix];
+
+#if !EI_CLASSIFIER_LAZY_DEQUANTIZE
         float value = static_cast<float>(raw_output_mtx->buffer[ix] - config->zero_point) * config->scale;
 
 #if EI_LOG_LEVEL == EI_LOG_LEVEL_DEBUG
@@ -343,8 +356,8 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_classification_i8(ei_imp
         ei_printf("\n");
 #endif
 
-        result->classification[ix].label = impulse->categories[ix];
         result->classification[ix].value = value;
+#endif // !EI_CLASSIFIER_LAZY_DEQUANTIZE
     }
 
 
@@ -368,6 +381,9 @@ __attribute__((unused)) static EI_IMPULSE_ERROR process_classification_u8(ei_imp
     ei::matrix_u8_t* raw_output_mtx = NULL;
     find_mtx_by_idx(result->_raw_outputs, &raw_output_mtx, input_block_id, impulse->learning_blocks_size);
 
+    // float scores only, top-k falls back to them
+    result->quantized.count = 0;
+
     for (uint32_t ix = 0; ix < impulse->label_count; ix++) {
         float value = static_cast<float>(raw_output_mtx->buffer[ix] - config->zero_point) * config->scale;
 
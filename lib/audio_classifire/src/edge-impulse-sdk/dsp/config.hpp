@@ -58,6 +58,16 @@
 #endif // Mbed / ARM Core check
 #endif // ifndef EIDSP_USE_CMSIS_DSP
 
+// Real FFT from dsp_engines/ei_esp_dsp.h on the Espressif targets. The code is portable,
+// set to 1 on other targets to run it instead of kissfft
+#ifndef EIDSP_USE_ESP_DSP
+#if defined(ESP32) && !EIDSP_USE_CMSIS_DSP
+    #define EIDSP_USE_ESP_DSP       1
+#else
+    #define EIDSP_USE_ESP_DSP       0
+#endif // ESP32 check
+#endif // EIDSP_USE_ESP_DSP
+
 #if EIDSP_USE_CMSIS_DSP == 1
 #define EIDSP_i32                int32_t
 #define EIDSP_i16                int16_t
@@ -87,6 +97,12 @@
 #define EIDSP_QUANTIZE_FILTERBANK    1
 #endif // EIDSP_QUANTIZE_FILTERBANK
 
+// times the DSP and classifier stages with nested zones and latency histograms,
+// see ei_profiler.h. Compiles to nothing when disabled
+#ifndef EIDSP_PROFILING
+#define EIDSP_PROFILING              0
+#endif // EIDSP_PROFILING
+
 // prints buffer allocations to stdout, useful when debugging
 #ifndef EIDSP_TRACK_ALLOCATIONS
 #define EIDSP_TRACK_ALLOCATIONS      0
@@ -98,6 +114,12 @@
 #define EIDSP_PRINT_ALLOCATIONS      1
 #endif
 
+// number of DCT bases (one per num_filters / num_cepstral pair) that mfcc() keeps
+// after the first call, 0 builds the basis on every call
+#ifndef EIDSP_DCT_BASIS_CACHE_SIZE
+#define EIDSP_DCT_BASIS_CACHE_SIZE   2
+#endif // EIDSP_DCT_BASIS_CACHE_SIZE
+
 #ifndef EIDSP_SIGNAL_C_FN_POINTER
 #define EIDSP_SIGNAL_C_FN_POINTER    0
 #endif // EIDSP_SIGNAL_C_FN_POINTER
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef __EI_ESP_DSP__H__
+#define __EI_ESP_DSP__H__
+
+#include <atomic>
+#include <cstddef>
+#include "edge-impulse-sdk/dsp/returntypes.hpp"
+#include "edge-impulse-sdk/dsp/numpy_types.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+// Real FFT for the Espressif targets. An n_fft point real FFT runs as an n_fft / 2
+// point complex FFT (radix-4 butterflies, one radix-2 pass if log2(n_fft / 2) is odd)
+// followed by a split step. The LX6 / LX7 FPU is scalar, so the gain over kissfft comes
+// from halving the passes over memory, from precomputed twiddle and bit reversal tables,
+// and from running in place in the output buffer without scratch allocations.
+// The code is plain C++ so the host build can check it against kissfft.
+
+namespace ei {
+
+namespace fft {
+
+constexpr int MIN_FFT_SIZE = 32;
+constexpr int MAX_FFT_SIZE = 4096;
+
+typedef struct {
+    size_t n_fft;
+    size_t log2_n_fft;
+    // W_n_fft^j for j < 3 * n_fft / 4, covers the complex FFT twiddles and the split step
+    const fft_complex_t *twiddles;
+    // position of every input pair in bit reversed order (n_fft / 2 entries)
+    const uint16_t *bitrev;
+} esp_rfft_plan_t;
+
+static bool can_do_fft(size_t n_fft)
+{
+    return n_fft >= (size_t)MIN_FFT_SIZE && n_fft <= (size_t)MAX_FFT_SIZE && (n_fft & (n_fft - 1)) == 0;
+}
+
+// Twiddles are computed by constexpr functions, so the tables of the FFT sizes a model
+// uses (EI_CLASSIFIER_LOAD_FFT_*) are built by the compiler and end up in flash. They
+// round to the same floats as cos() / sin() of the same phase, like kissfft's twiddles.
+
+// pi / 2 split in a 33 bit head and the rest, so the range reduction below is exact
+constexpr double esp_fft_pio2_hi = 1.57079632673412561417e+00;
+constexpr double esp_fft_pio2_lo = 6.07710050650619224932e-11;
+
+constexpr double esp_fft_taylor(double r2, double term, int n)
+{
+    return n > 24 ? term : term + esp_fft_taylor(r2, -term * r2 / ((n + 1) * (n + 2)), n + 2);
+}
+
+constexpr double esp_fft_sin_reduced(double r) { return esp_fft_taylor(r * r, r, 1); }
+constexpr double esp_fft_cos_reduced(double r) { return esp_fft_taylor(r * r, 1.0, 0); }
+
+// phase = r + k * pi / 2 with |r| <= pi / 4
+constexpr int esp_fft_quadrant(double phase)
+{
+    return (int)(phase / (esp_fft_pio2_hi + esp_fft_pio2_lo) + (phase < 0 ? -0.5 : 0.5));
+}
+
+constexpr double esp_fft_reduce(double phase, int k)
+{
+    return (phase - k * esp_fft_pio2_hi) - k * esp_fft_pio2_lo;
+}
+
+constexpr double esp_fft_cos_quadrant(double r, int k)
+{
+    return (k & 3) == 0 ? esp_fft_cos_reduced(r) :
+           (k & 3) == 1 ? -esp_fft_sin_reduced(r) :
+           (k & 3) == 2 ? -esp_fft_cos_reduced(r) :
+                          esp_fft_sin_reduced(r);
+}
+
+constexpr double esp_fft_cos(double phase)
+{
+    return esp_fft_cos_quadrant(esp_fft_reduce(phase, esp_fft_quadrant(phase)), esp_fft_quadrant(phase));
+}
+
+constexpr double esp_fft_sin(double phase)
+{
+    // sin(x) = cos(x - pi / 2)
+    return esp_fft_cos_quadrant(esp_fft_reduce(phase, esp_fft_quadrant(phase)), esp_fft_quadrant(phase) - 1);
+}
+
+constexpr double esp_fft_phase(size_t j, size_t n_fft)
+{
+    return -2.0 * 3.14159265358979323846 * (double)j / (double)n_fft;
+}
+
+constexpr fft_complex_t esp_fft_twiddle(size_t j, size_t n_fft)
+{
+    return fft_complex_t{ (float)esp_fft_cos(esp_fft_phase(j, n_fft)), (float)esp_fft_sin(esp_fft_phase(j, n_fft)) };
+}
+
+constexpr uint16_t esp_fft_bitrev(size_t ix, size_t bits)
+{
+    return bits == 0 ? 0 : (uint16_t)(((ix & 1) << (bits - 1)) | esp_fft_bitrev(ix >> 1, bits - 1));
+}
+
+#if EI_CLASSIFIER_HAS_FFT_INFO == 1 && !defined(EI_CLASSIFIER_LOAD_ALL_FFTS)
+// index sequences (std::index_sequence is C++14), built in log(n) steps
+template <size_t... Is> struct esp_fft_seq { typedef esp_fft_seq type; };
+
+template <class A, class B> struct esp_fft_seq_cat;
+template <size_t... A, size_t... B>
+struct esp_fft_seq_cat<esp_fft_seq<A...>, esp_fft_seq<B...>> : esp_fft_seq<A..., (sizeof...(A) + B)...> { };
+
+template <size_t N>
+struct esp_fft_make_seq
+    : esp_fft_seq_cat<typename esp_fft_make_seq<N / 2>::type, typename esp_fft_make_seq<N - N / 2>::type> { };
+template <> struct esp_fft_make_seq<0> : esp_fft_seq<> { };
+template <> struct esp_fft_make_seq<1> : esp_fft_seq<0> { };
+
+template <size_t NFft, size_t Log2NFft, class TwiddleSeq, class BitrevSeq> struct esp_rfft_tables;
+
+template <size_t NFft, size_t Log2NFft, size_t... Tw, size_t... Br>
+struct esp_rfft_tables<NFft, Log2NFft, esp_fft_seq<Tw...>, esp_fft_seq<Br...>> {
+    __attribute__((aligned(16))) static constexpr fft_complex_t twiddles[sizeof...(Tw)] = {
+        esp_fft_twiddle(Tw, NFft)...
+    };
+    static constexpr uint16_t bitrev[sizeof...(Br)] = { esp_fft_bitrev(Br, Log2NFft - 1)... };
+};
+
+template <size_t NFft, size_t Log2NFft, size_t... Tw, size_t... Br>
+constexpr fft_complex_t esp_rfft_tables<NFft, Log2NFft, esp_fft_seq<Tw...>, esp_fft_seq<Br...>>::twiddles[sizeof...(Tw)];
+template <size_t NFft, size_t Log2NFft, size_t... Tw, size_t... Br>
+constexpr uint16_t esp_rfft_tables<NFft, Log2NFft, esp_fft_seq<Tw...>, esp_fft_seq<Br...>>::bitrev[sizeof...(Br)];
+
+template <size_t NFft, size_t Log2NFft>
+struct esp_rfft_const_plan {
+    typedef esp_rfft_tables<NFft, Log2NFft,
+        typename esp_fft_make_seq<3 * NFft / 4>::type, typename esp_fft_make_seq<NFft / 2>::type> tables;
+    static constexpr esp_rfft_plan_t plan = { NFft, Log2NFft, tables::twiddles, tables::bitrev };
+};
+
+template <size_t NFft, size_t Log2NFft>
+constexpr esp_rfft_plan_t esp_rfft_const_plan<NFft, Log2NFft>::plan;
+
+/**
+ * Get the plan for n_fft, only the sizes in model_metadata.h have tables
+ */
+static const esp_rfft_plan_t *esp_rfft_get_plan(size_t n_fft, size_t log2_n_fft)
+{
+    (void)log2_n_fft;
+
+    switch (n_fft) {
+#if EI_CLASSIFIER_LOAD_FFT_32 == 1
+        case 32: return &esp_rfft_const_plan<32, 5>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_64 == 1
+        case 64: return &esp_rfft_const_plan<64, 6>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_128 == 1
+        case 128: return &esp_rfft_const_plan<128, 7>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_256 == 1
+        case 256: return &esp_rfft_const_plan<256, 8>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_512 == 1
+        case 512: return &esp_rfft_const_plan<512, 9>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_1024 == 1
+        case 1024: return &esp_rfft_const_plan<1024, 10>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_2048 == 1
+        case 2048: return &esp_rfft_const_plan<2048, 11>::plan;
+#endif
+#if EI_CLASSIFIER_LOAD_FFT_4096 == 1
+        case 4096: return &esp_rfft_const_plan<4096, 12>::plan;
+#endif
+        default: return nullptr;
+    }
+}
+
+constexpr int esp_rfft_no_plan_error = ei::EIDSP_FFT_TABLE_NOT_LOADED;
+
+#else
+
+/**
+ * One plan per FFT size, shared by all translation units and threads
+ */
+inline std::atomic<esp_rfft_plan_t *> *esp_rfft_plans()
+{
+    static std::atomic<esp_rfft_plan_t *> plans[12 - 5 + 1];
+    return plans;
+}
+
+/**
+ * Get the plan for n_fft, building it on first use. Plans are never freed.
+ */
+static const esp_rfft_plan_t *esp_rfft_get_plan(size_t n_fft, size_t log2_n_fft)
+{
+    std::atomic<esp_rfft_plan_t *> *slot = &esp_rfft_plans()[log2_n_fft - 5];
+    esp_rfft_plan_t *plan = slot->load(std::memory_order_acquire);
+    if (plan) {
+        return plan;
+    }
+
+    const size_t m = n_fft / 2;
+    const size_t twiddle_count = 3 * n_fft / 4;
+    // 16 byte aligned twiddles, so every complex value sits in one cache line
+    size_t bytes = 15 + sizeof(esp_rfft_plan_t) + 15 + twiddle_count * sizeof(fft_complex_t) +
+        m * sizeof(uint16_t);
+    void *alloc = ei_calloc(bytes, 1);
+    if (!alloc) {
+        return nullptr;
+    }
+
+    uintptr_t p = ((uintptr_t)alloc + 15) & ~(uintptr_t)15;
+    plan = (esp_rfft_plan_t *)p;
+    p = (p + sizeof(esp_rfft_plan_t) + 15) & ~(uintptr_t)15;
+    fft_complex_t *twiddles = (fft_complex_t *)p;
+    uint16_t *bitrev = (uint16_t *)(p + twiddle_count * sizeof(fft_complex_t));
+
+    for (size_t j = 0; j < twiddle_count; j++) {
+        twiddles[j] = esp_fft_twiddle(j, n_fft);
+    }
+    for (size_t ix = 0; ix < m; ix++) {
+        bitrev[ix] = esp_fft_bitrev(ix, log2_n_fft - 1);
+    }
+
+    plan->n_fft = n_fft;
+    plan->log2_n_fft = log2_n_fft;
+    plan->twiddles = twiddles;
+    plan->bitrev = bitrev;
+
+    // another thread may have built the same plan meanwhile, keep the first one
+    esp_rfft_plan_t *expected = nullptr;
+    if (!slot->compare_exchange_strong(expected, plan, std::memory_order_acq_rel)) {
+        ei_free(alloc);
+        return expected;
+    }
+    return plan;
+}
+
+constexpr int esp_rfft_no_plan_error = ei::EIDSP_OUT_OF_MEM;
+
+#endif // EI_CLASSIFIER_HAS_FFT_INFO == 1 && !defined(EI_CLASSIFIER_LOAD_ALL_FFTS)
+
+/**
+ * Complex FFT of the n_fft / 2 values in buf, which are already in bit reversed order
+ */
+static void esp_cfft_radix4(fft_complex_t *buf, const esp_rfft_plan_t *plan)
+{
+    const size_t m = plan->n_fft / 2;
+    const fft_complex_t *tw = plan->twiddles;
+    size_t l = 1;
+
+    if ((plan->log2_n_fft - 1) & 1) {
+        for (size_t ix = 0; ix < m; ix += 2) {
+            fft_complex_t a = buf[ix];
+            fft_complex_t b = buf[ix + 1];
+            buf[ix].r = a.r + b.r;
+            buf[ix].i = a.i + b.i;
+            buf[ix + 1].r = a.r - b.r;
+            buf[ix + 1].i = a.i - b.i;
+        }
+        l = 2;
+    }
+
+    // every pass merges four transforms of length l into one of length 4 * l
+    for (; l < m; l *= 4) {
+        // twiddle W_4l^k is W_n_fft^(k * stride)
+        const size_t stride = plan->n_fft / (4 * l);
+
+        for (size_t k = 0; k < l; k++) {
+            const fft_complex_t w1 = tw[k * stride];
+            const fft_complex_t w2 = tw[2 * k * stride];
+            const fft_complex_t w3 = tw[3 * k * stride];
+
+            for (size_t base = k; base < m; base += 4 * l) {
+                fft_complex_t *p0 = &buf[base];
+                fft_complex_t *p1 = p0 + l;
+                fft_complex_t *p2 = p1 + l;
+                fft_complex_t *p3 = p2 + l;
+
+                const float ar = p0->r, ai = p0->i;
+                const float br = p1->r * w2.r - p1->i * w2.i, bi = p1->r * w2.i + p1->i * w2.r;
+                const float cr = p2->r * w1.r - p2->i * w1.i, ci = p2->r * w1.i + p2->i * w1.r;
+                const float dr = p3->r * w3.r - p3->i * w3.i, di = p3->r * w3.i + p3->i * w3.r;
+
+                const float t0r = ar + br, t0i = ai + bi;
+                const float t1r = ar - br, t1i = ai - bi;
+                const float t2r = cr + dr, t2i = ci + di;
+                const float t3r = cr - dr, t3i = ci - di;
+
+                p0->r = t0r + t2r;
+                p0->i = t0i + t2i;
+                p2->r = t0r - t2r;
+                p2->i = t0i - t2i;
+                // t1 -/+ i * t3
+                p1->r = t1r + t3i;
+                p1->i = t1i - t3r;
+                p3->r = t1r - t3i;
+                p3->i = t1i + t3r;
+            }
+        }
+    }
+}
+
+/**
+ * Real FFT, output gets n_fft / 2 + 1 bins like kissfft / numpy. input and output must not overlap.
+ */
+static int hw_r2c_fft(const float *input, ei::fft_complex_t *output, size_t n_fft)
+{
+    if (!can_do_fft(n_fft)) { return ei::EIDSP_FFT_SIZE_NOT_SUPPORTED; }
+
+    size_t log2_n_fft = 0;
+    while (((size_t)1 << log2_n_fft) < n_fft) {
+        log2_n_fft++;
+    }
+
+    const esp_rfft_plan_t *plan = esp_rfft_get_plan(n_fft, log2_n_fft);
+    if (!plan) { return esp_rfft_no_plan_error; }
+
+    const size_t m = n_fft / 2;
+
+    // even samples go to the real, odd samples to the imaginary part, in bit reversed order
+    const fft_complex_t *in = (const fft_complex_t *)input;
+    for (size_t ix = 0; ix < m; ix++) {
+        output[plan->bitrev[ix]] = in[ix];
+    }
+
+    esp_cfft_radix4(output, plan);
+
+    // split the transform of the packed signal into the spectrum of the real one:
+    // X[k] = E[k] - i W^k O[k], X[m - k] = conj(E[k] + i W^k O[k])
+    const fft_complex_t *tw = plan->twiddles;
+    for (size_t k = 1; k <= m / 2; k++) {
+        const fft_complex_t zk = output[k];
+        const fft_complex_t zmk = output[m - k];
+
+        const float e_r = 0.5f * (zk.r + zmk.r), e_i = 0.5f * (zk.i - zmk.i);
+        const float o_r = 0.5f * (zk.r - zmk.r), o_i = 0.5f * (zk.i + zmk.i);
+        const float t_r = tw[k].r * o_r - tw[k].i * o_i;
+        const float t_i = tw[k].r * o_i + tw[k].i * o_r;
+
+        output[k].r = e_r + t_i;
+        output[k].i = e_i - t_r;
+        output[m - k].r = e_r - t_i;
+        output[m - k].i = -(e_i + t_r);
+    }
+
+    const float z0r = output[0].r, z0i = output[0].i;
+    output[0].r = z0r + z0i;
+    output[0].i = 0.0f;
+    output[m].r = z0r - z0i;
+    output[m].i = 0.0f;
+
+    return ei::EIDSP_OK;
+}
+
+} // namespace fft
+
+} // namespace ei
+
+#endif  //!__EI_ESP_DSP__H__
@@ -31,26 +31,273 @@
 #ifndef __EIPROFILER__H__
 #define __EIPROFILER__H__
 
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "edge-impulse-sdk/dsp/config.hpp"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
-class EiProfiler {
+/**
+ * Scoped, zero-allocation profiler for the DSP and classifier stages.
+ *
+ * Wrap a stage in EI_PROFILE_ZONE(EI_PROFILER_ZONE_FFT); the time until the end
+ * of the enclosing scope is added to the zone. A stage that is followed by
+ * another one in the same scope is closed early with
+ * EI_PROFILE_ZONE_NAMED(zone_var, zone) ... EI_PROFILE_ZONE_END(zone_var). Zones nest: every zone remembers
+ * the zone it was entered from, and its self time excludes time spent in
+ * nested zones. Per zone a histogram with two buckets per octave of
+ * microseconds is kept, from which p50 / p95 / p99 are estimated (the reported
+ * value is the upper bound of the bucket, so within ~50% of the real value).
+ *
+ * All state is static (about 3K), the profiler is not thread safe and should
+ * only be entered from the task running the classifier.
+ * Build with EIDSP_PROFILING=1 to enable, otherwise the zones compile to nothing
+ * and ei_profiler_snapshot() returns 0.
+ */
+typedef enum {
+    EI_PROFILER_ZONE_RUN_CLASSIFIER = 0,
+    EI_PROFILER_ZONE_DSP,
+    EI_PROFILER_ZONE_CAPTURE,
+    EI_PROFILER_ZONE_PREEMPHASIS,
+    EI_PROFILER_ZONE_FRAMING,
+    EI_PROFILER_ZONE_FFT,
+    EI_PROFILER_ZONE_MEL,
+    EI_PROFILER_ZONE_NORMALIZATION,
+    EI_PROFILER_ZONE_INFERENCE,
+    EI_PROFILER_ZONE_QUANTIZE,
+    EI_PROFILER_ZONE_INVOKE,
+    EI_PROFILER_ZONE_POSTPROCESS,
+    EI_PROFILER_ZONE_COUNT
+} ei_profiler_zone_t;
+
+#define EI_PROFILER_HISTOGRAM_BUCKETS   48  // up to 2^24 us
+#define EI_PROFILER_MAX_DEPTH           8
+
+/** Snapshot of a single zone, see ei_profiler_snapshot() */
+typedef struct {
+    const char *name;
+    int8_t parent;          // zone this one was last entered from, -1 for a root
+    uint8_t depth;
+    uint32_t count;
+    uint64_t total_us;
+    uint64_t self_us;       // total_us minus the time spent in nested zones
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+} ei_profiler_zone_stats_t;
+
+static inline const char *ei_profiler_zone_name(int zone) {
+    static const char *names[EI_PROFILER_ZONE_COUNT] = {
+        "run_classifier", "dsp", "capture", "preemphasis", "framing", "fft",
+        "mel", "normalization", "inference", "quantize", "invoke", "postprocess"
+    };
+    return (zone >= 0 && zone < EI_PROFILER_ZONE_COUNT) ? names[zone] : "unknown";
+}
+
+#if EIDSP_PROFILING == 1
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_us;
+    uint64_t self_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    int8_t parent;
+    uint8_t depth;
+    uint32_t histogram[EI_PROFILER_HISTOGRAM_BUCKETS];
+} ei_profiler_zone_data_t;
+
+typedef struct {
+    ei_profiler_zone_data_t zones[EI_PROFILER_ZONE_COUNT];
+    struct {
+        uint8_t zone;
+        uint64_t start_us;
+        uint64_t child_us;
+    } stack[EI_PROFILER_MAX_DEPTH];
+    uint8_t depth;
+} ei_profiler_state_t;
+
+// function local static, so all translation units share one instance
+static inline ei_profiler_state_t &ei_profiler_state() {
+    static ei_profiler_state_t state;
+    return state;
+}
+
+static inline size_t ei_profiler_bucket(uint32_t us) {
+    if (us < 2) {
+        return us;
+    }
+    size_t msb = 0;
+    while ((us >> (msb + 1)) != 0) {
+        msb++;
+    }
+    size_t bucket = 2 * msb + ((us >> (msb - 1)) & 1);
+    return bucket < EI_PROFILER_HISTOGRAM_BUCKETS ? bucket : EI_PROFILER_HISTOGRAM_BUCKETS - 1;
+}
+
+// largest value that falls in a bucket
+static inline uint32_t ei_profiler_bucket_upper_us(size_t bucket) {
+    if (bucket < 2) {
+        return (uint32_t)bucket;
+    }
+    size_t next = bucket + 1;
+    uint32_t lower = (1u << (next / 2)) + (next & 1) * (1u << (next / 2 - 1));
+    return lower - 1;
+}
+
+static inline bool ei_profiler_zone_begin(ei_profiler_zone_t zone) {
+    ei_profiler_state_t &s = ei_profiler_state();
+    if (s.depth >= EI_PROFILER_MAX_DEPTH) {
+        return false;
+    }
+    s.zones[zone].parent = s.depth ? (int8_t)s.stack[s.depth - 1].zone : -1;
+    s.zones[zone].depth = s.depth;
+    s.stack[s.depth].zone = (uint8_t)zone;
+    s.stack[s.depth].child_us = 0;
+    s.stack[s.depth].start_us = ei_read_timer_us();
+    s.depth++;
+    return true;
+}
+
+static inline void ei_profiler_zone_end() {
+    uint64_t end_us = ei_read_timer_us();
+    ei_profiler_state_t &s = ei_profiler_state();
+    if (s.depth == 0) {
+        return;
+    }
+    s.depth--;
+    uint64_t elapsed = end_us - s.stack[s.depth].start_us;
+    uint32_t elapsed_us = elapsed > 0xffffffffULL ? 0xffffffffUL : (uint32_t)elapsed;
+
+    ei_profiler_zone_data_t &z = s.zones[s.stack[s.depth].zone];
+    if (z.count == 0 || elapsed_us < z.min_us) {
+        z.min_us = elapsed_us;
+    }
+    if (elapsed_us > z.max_us) {
+        z.max_us = elapsed_us;
+    }
+    z.count++;
+    z.total_us += elapsed;
+    z.self_us += elapsed - s.stack[s.depth].child_us;
+    z.histogram[ei_profiler_bucket(elapsed_us)]++;
+
+    if (s.depth) {
+        s.stack[s.depth - 1].child_us += elapsed;
+    }
+}
+
+static inline uint32_t ei_profiler_percentile(const ei_profiler_zone_data_t &z, uint32_t percent) {
+    if (z.count == 0) {
+        return 0;
+    }
+    uint64_t rank = ((uint64_t)z.count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t ix = 0; ix < EI_PROFILER_HISTOGRAM_BUCKETS; ix++) {
+        seen += z.histogram[ix];
+        if (seen >= rank) {
+            uint32_t upper = ei_profiler_bucket_upper_us(ix);
+            return upper < z.max_us ? upper : z.max_us;
+        }
+    }
+    return z.max_us;
+}
+
+/**
+ * Copy the statistics of every zone into `out`, indexed by ei_profiler_zone_t
+ * @returns number of zones written (at most `max_zones`)
+ */
+static inline size_t ei_profiler_snapshot(ei_profiler_zone_stats_t *out, size_t max_zones) {
+    ei_profiler_state_t &s = ei_profiler_state();
+    size_t n = max_zones < EI_PROFILER_ZONE_COUNT ? max_zones : EI_PROFILER_ZONE_COUNT;
+    for (size_t ix = 0; ix < n; ix++) {
+        const ei_profiler_zone_data_t &z = s.zones[ix];
+        out[ix].name = ei_profiler_zone_name((int)ix);
+        out[ix].parent = z.count ? z.parent : -1;
+        out[ix].depth = z.depth;
+        out[ix].count = z.count;
+        out[ix].total_us = z.total_us;
+        out[ix].self_us = z.self_us;
+        out[ix].min_us = z.min_us;
+        out[ix].max_us = z.max_us;
+        out[ix].p50_us = ei_profiler_percentile(z, 50);
+        out[ix].p95_us = ei_profiler_percentile(z, 95);
+        out[ix].p99_us = ei_profiler_percentile(z, 99);
+    }
+    return n;
+}
+
+/**
+ * Clear all statistics. Must not be called from inside a zone.
+ */
+static inline void ei_profiler_reset() {
+    ei_profiler_state_t &s = ei_profiler_state();
+    memset(&s, 0, sizeof(s));
+}
+
+class EiProfilerZone {
 public:
-    EiProfiler()
+    EiProfilerZone(ei_profiler_zone_t zone)
     {
-        reset();
+        _active = ei_profiler_zone_begin(zone);
     }
-    void reset()
+    ~EiProfilerZone()
     {
-        timestamp = ei_read_timer_ms();
+        end();
     }
-    void report(const char *message)
+
+    void end()
     {
-        ei_printf("%s took %llu\r\n", message, ei_read_timer_ms() - timestamp);
-        timestamp = ei_read_timer_ms(); //read again to not count printf time
+        if (_active) {
+            ei_profiler_zone_end();
+            _active = false;
+        }
     }
 
 private:
-    uint64_t timestamp;
+    bool _active;
 };
 
+#define EI_PROFILE_ZONE_CONCAT_(a, b) a##b
+#define EI_PROFILE_ZONE_CONCAT(a, b) EI_PROFILE_ZONE_CONCAT_(a, b)
+#define EI_PROFILE_ZONE(zone) EiProfilerZone EI_PROFILE_ZONE_CONCAT(_ei_profile_zone_, __LINE__)(zone)
+#define EI_PROFILE_ZONE_NAMED(var, zone) EiProfilerZone var(zone)
+#define EI_PROFILE_ZONE_END(var) var.end()
+
+#else
+
+static inline size_t ei_profiler_snapshot(ei_profiler_zone_stats_t *out, size_t max_zones) {
+    (void)out;
+    (void)max_zones;
+    return 0;
+}
+
+static inline void ei_profiler_reset() { }
+
+#define EI_PROFILE_ZONE(zone) (void)0
+#define EI_PROFILE_ZONE_NAMED(var, zone) (void)0
+#define EI_PROFILE_ZONE_END(var) (void)0
+
+#endif // EIDSP_PROFILING == 1
+
+/**
+ * Print every zone that was entered, indented by nesting depth
+ */
+static inline void ei_profiler_print() {
+    ei_profiler_zone_stats_t stats[EI_PROFILER_ZONE_COUNT];
+    size_t n = ei_profiler_snapshot(stats, EI_PROFILER_ZONE_COUNT);
+    for (size_t ix = 0; ix < n; ix++) {
+        if (stats[ix].count == 0) {
+            continue;
+        }
+        ei_printf("%*s%s: n=%lu total=%llu us self=%llu us min=%lu p50=%lu p95=%lu p99=%lu max=%lu us\r\n",
+            (int)stats[ix].depth * 2, "", stats[ix].name, (unsigned long)stats[ix].count,
+            (unsigned long long)stats[ix].total_us, (unsigned long long)stats[ix].self_us,
+            (unsigned long)stats[ix].min_us, (unsigned long)stats[ix].p50_us,
+            (unsigned long)stats[ix].p95_us, (unsigned long)stats[ix].p99_us,
+            (unsigned long)stats[ix].max_us);
+    }
+}
+
 #endif  //!__EIPROFILER__H__
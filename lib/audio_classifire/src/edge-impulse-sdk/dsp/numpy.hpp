@@ -59,6 +59,7 @@
 #include "returntypes.hpp"
 #include "memory.hpp"
 #include "ei_utils.h"
+#include "ei_profiler.h"
 #include "dct/fast-dct-fft.h"
 #include "kissfft/kiss_fftr.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
@@ -75,6 +76,8 @@
 #endif
 #elif EIDSP_USE_CMSIS_DSP
 #include "edge-impulse-sdk/dsp/dsp_engines/ei_arm_cmsis_dsp.h"
+#elif EIDSP_USE_ESP_DSP
+#include "edge-impulse-sdk/dsp/dsp_engines/ei_esp_dsp.h"
 #else
 #define EIDSP_INCLUDE_KISSFFT 1
 #include "edge-impulse-sdk/dsp/dsp_engines/ei_no_hw_dsp.h"
@@ -642,6 +645,35 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Fill a matrix with the first basis vectors of the DCT type 2, one per column.
+     * For a matrix of N rows and K columns, dot(x, basis) gives the first K
+     * coefficients of dct2() of every N long row of x.
+     * @param basis Output matrix (N x K, K <= N)
+     * @param normalization Same as for dct2()
+     * @returns EIDSP_OK if OK
+     */
+    static int dct2_basis(matrix_t *basis, DCT_NORMALIZATION_MODE normalization = DCT_NORMALIZATION_NONE) {
+        const size_t N = basis->rows;
+        const size_t K = basis->cols;
+        if (K > N) {
+            EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
+        }
+
+        for (size_t k = 0; k < K; k++) {
+            double scale = 2.0;
+            if (normalization == DCT_NORMALIZATION_ORTHO) {
+                scale = k == 0 ? sqrt(1.0 / N) : sqrt(2.0 / N);
+            }
+            for (size_t n = 0; n < N; n++) {
+                basis->buffer[n * K + k] =
+                    static_cast<float>(scale * cos(M_PI * k * (2 * n + 1) / (2.0 * N)));
+            }
+        }
+
+        return EIDSP_OK;
+    }
+
     /**
      * Quantize a float value between zero and one
      * @param value Float value
@@ -2047,6 +2079,8 @@ public:
         size_t out_buffer_size,
         uint16_t fft_points)
     {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_FFT);
+
         if (out_buffer_size != static_cast<size_t>(fft_points / 2 + 1)) {
             EIDSP_ERR(EIDSP_MATRIX_SIZE_MISMATCH);
         }
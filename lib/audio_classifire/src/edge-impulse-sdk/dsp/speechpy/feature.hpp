@@ -32,6 +32,7 @@
 #define _EIDSP_SPEECHPY_FEATURE_H_
 
 #include <stdint.h>
+#include <atomic>
 #include "../../porting/ei_classifier_porting.h"
 #include "../ei_utils.h"
 #include "functions.hpp"
@@ -356,6 +357,7 @@ public:
                 out_energies->buffer[ix] = energy;
             }
 
+            EI_PROFILE_ZONE_NAMED(mel_zone, EI_PROFILER_ZONE_MEL);
             auto row_ptr = out_features->get_row_ptr(ix);
             for (size_t i = 0; i < num_filters; i++) {
                 size_t left = bins[i];
@@ -384,6 +386,7 @@ public:
                     }
                 }
             }
+            EI_PROFILE_ZONE_END(mel_zone);
 
             if (ret != 0) {
                 EIDSP_ERR(ret);
@@ -534,6 +537,7 @@ public:
             }
 
             // calculate the out_features directly here
+            EI_PROFILE_ZONE_NAMED(mel_zone, EI_PROFILER_ZONE_MEL);
             ret = numpy::dot_by_row(
                 ix,
                 power_spectrum_frame.buffer,
@@ -541,6 +545,7 @@ public:
                 &filterbanks,
                 out_features
             );
+            EI_PROFILE_ZONE_END(mel_zone);
 
             if (ret != 0) {
                 EIDSP_ERR(ret);
@@ -762,23 +767,34 @@ public:
             EIDSP_ERR(ret);
         }
 
-        // now do DST type 2
-        ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
+        // now do DCT type 2. Only the first num_cepstral coefficients are kept, so
+        // multiply all frames with those basis vectors instead of transforming every row
+        const float *cached_basis = get_dct_basis(features_matrix.cols, num_cepstral);
+        if (cached_basis) {
+            matrix_t dct_basis(features_matrix.cols, num_cepstral, const_cast<float *>(cached_basis));
+            ret = numpy::dot(&features_matrix, &dct_basis, out_features);
+        }
+        else {
+            EI_DSP_MATRIX(dct_basis, features_matrix.cols, num_cepstral);
+            if (!dct_basis.buffer) {
+                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            }
+
+            ret = numpy::dct2_basis(&dct_basis, DCT_NORMALIZATION_ORTHO);
+            if (ret != EIDSP_OK) {
+                EIDSP_ERR(ret);
+            }
+
+            ret = numpy::dot(&features_matrix, &dct_basis, out_features);
+        }
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
 
         // replace first cepstral coefficient with log of frame energy for DC elimination
         if (dc_elimination) {
-            for (size_t row = 0; row < features_matrix.rows; row++) {
-                features_matrix.buffer[row * features_matrix.cols] = numpy::log(energy_matrix.buffer[row]);
-            }
-        }
-
-        // copy to the output...
-        for (size_t row = 0; row < features_matrix.rows; row++) {
-            for(int i = 0; i < num_cepstral; i++) {
-                *(out_features->buffer + (num_cepstral * row) + i) = *(features_matrix.buffer + (features_matrix.cols * row) + i);
+            for (size_t row = 0; row < out_features->rows; row++) {
+                out_features->buffer[row * num_cepstral] = numpy::log(energy_matrix.buffer[row]);
             }
         }
 
@@ -813,6 +829,83 @@ public:
         size_matrix.cols = (uint32_t)cols;
         return size_matrix;
     }
+
+private:
+    typedef struct {
+        size_t num_filters;
+        size_t num_cepstral;
+        float *basis;
+    } dct_basis_entry_t;
+
+#if EIDSP_DCT_BASIS_CACHE_SIZE > 0
+    /**
+     * Cached orthonormal DCT bases, shared by all translation units and threads
+     */
+    static std::atomic<dct_basis_entry_t *> *dct_basis_cache() {
+        static std::atomic<dct_basis_entry_t *> entries[EIDSP_DCT_BASIS_CACHE_SIZE];
+        return entries;
+    }
+#endif
+
+    /**
+     * Get the orthonormal DCT basis of num_filters rows and num_cepstral columns,
+     * building it on first use. Entries are never freed.
+     * @returns the basis, or NULL when the cache is full or out of memory
+     */
+    static const float *get_dct_basis(size_t num_filters, size_t num_cepstral) {
+#if EIDSP_DCT_BASIS_CACHE_SIZE > 0
+        std::atomic<dct_basis_entry_t *> *entries = dct_basis_cache();
+        dct_basis_entry_t *built = NULL;
+
+        for (size_t ix = 0; ix < EIDSP_DCT_BASIS_CACHE_SIZE; ix++) {
+            dct_basis_entry_t *entry = entries[ix].load(std::memory_order_acquire);
+            if (entry) {
+                if (entry->num_filters == num_filters && entry->num_cepstral == num_cepstral) {
+                    if (built) {
+                        ei_free(built);
+                    }
+                    return entry->basis;
+                }
+                continue;
+            }
+
+            if (!built) {
+                built = (dct_basis_entry_t *)ei_calloc(
+                    sizeof(dct_basis_entry_t) + num_filters * num_cepstral * sizeof(float), 1);
+                if (!built) {
+                    return NULL;
+                }
+                built->num_filters = num_filters;
+                built->num_cepstral = num_cepstral;
+                built->basis = (float *)(built + 1);
+
+                matrix_t basis(num_filters, num_cepstral, built->basis);
+                if (numpy::dct2_basis(&basis, DCT_NORMALIZATION_ORTHO) != EIDSP_OK) {
+                    ei_free(built);
+                    return NULL;
+                }
+            }
+
+            // another thread may have taken this slot meanwhile, maybe with the same shape
+            dct_basis_entry_t *expected = NULL;
+            if (entries[ix].compare_exchange_strong(expected, built, std::memory_order_acq_rel)) {
+                return built->basis;
+            }
+            if (expected->num_filters == num_filters && expected->num_cepstral == num_cepstral) {
+                ei_free(built);
+                return expected->basis;
+            }
+        }
+
+        if (built) {
+            ei_free(built);
+        }
+#else
+        (void)num_filters;
+        (void)num_cepstral;
+#endif // EIDSP_DCT_BASIS_CACHE_SIZE > 0
+        return NULL;
+    }
 };
 
 } // namespace speechpy
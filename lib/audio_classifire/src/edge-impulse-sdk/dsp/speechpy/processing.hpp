@@ -84,6 +84,7 @@ public:
             }
 
             int ret;
+            EI_PROFILE_ZONE_NAMED(capture_zone, EI_PROFILER_ZONE_CAPTURE);
             if (static_cast<int32_t>(offset) - _shift >= 0) {
                 ret = _signal->get_data(offset - _shift, _shift, _prev_buffer);
                 if (ret != 0) {
@@ -96,8 +97,10 @@ public:
             if (ret != 0) {
                 EIDSP_ERR(ret);
             }
+            EI_PROFILE_ZONE_END(capture_zone);
 
             // now we have the signal and we can preemphasize
+            EI_PROFILE_ZONE(EI_PROFILER_ZONE_PREEMPHASIS);
             for (size_t ix = 0; ix < length; ix++) {
                 float now = out_buffer[ix];
 
@@ -163,6 +166,8 @@ namespace processing {
      */
     __attribute__((unused)) static int preemphasis(float *signal, size_t signal_size, int shift = 1, float cof = 0.98f)
     {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_PREEMPHASIS);
+
         if (shift < 0) {
             shift = signal_size + shift;
         }
@@ -277,6 +282,8 @@ namespace processing {
                             bool zero_padding,
                             uint16_t version)
     {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_FRAMING);
+
         if (!info->signal || !info->signal->get_data || info->signal->total_length == 0) {
             EIDSP_ERR(EIDSP_SIGNAL_SIZE_MISMATCH);
         }
@@ -384,6 +391,19 @@ namespace processing {
         return numframes;
     }
 
+    /**
+     * Row that lands at offset (relative to the first row) when padding a matrix
+     * of `rows` rows symmetrically, the same as numpy::pad_1d_symmetric
+     */
+    static inline int32_t symmetric_row(int32_t offset, int32_t rows) {
+        const int32_t period = 2 * rows;
+        int32_t ix = offset % period;
+        if (ix < 0) {
+            ix += period;
+        }
+        return ix < rows ? ix : period - 1 - ix;
+    }
+
     /**
      * This function performs local cepstral mean and
      * variance normalization on a sliding window. The code assumes that
@@ -400,79 +420,76 @@ namespace processing {
     static int cmvnw(matrix_t *features_matrix, uint16_t win_size = 301, bool variance_normalization = false,
         bool scale = false)
     {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_NORMALIZATION);
+
         if (win_size == 0) {
             return EIDSP_OK;
         }
 
-        uint16_t pad_size = (win_size - 1) / 2;
-
-        int ret;
-        float *features_buffer_ptr;
-
-        // mean & variance normalization
-        EI_DSP_MATRIX(vec_pad, features_matrix->rows + (pad_size * 2), features_matrix->cols);
-        if (!vec_pad.buffer) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        if (features_matrix->rows == 0) {
+            EIDSP_ERR(EIDSP_INPUT_MATRIX_EMPTY);
         }
 
-        ret = numpy::pad_1d_symmetric(features_matrix, &vec_pad, pad_size, pad_size);
-        if (ret != EIDSP_OK) {
-            EIDSP_ERR(ret);
-        }
+        const int32_t rows = features_matrix->rows;
+        const size_t cols = features_matrix->cols;
+        const int32_t pad_size = (win_size - 1) / 2;
+
+        int ret;
 
-        EI_DSP_MATRIX(mean_matrix, vec_pad.cols, 1);
-        if (!mean_matrix.buffer) {
+        // The windows run over the rows padded symmetrically by pad_size (like
+        // numpy::pad_1d_symmetric), so window ix covers offsets ix - pad_size up to
+        // ix - pad_size + win_size - 1. Every column is handled on its own with running
+        // sums over a copy of it, as the results are written back in place.
+        EI_DSP_MATRIX(column, 1, rows);
+        if (!column.buffer) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
 
-        EI_DSP_MATRIX(window_variance, vec_pad.cols, 1);
-        if (!window_variance.buffer) {
-            return EIDSP_OUT_OF_MEM;
-        }
+        for (size_t col = 0; col < cols; col++) {
+            float *features_col = features_matrix->buffer + col;
 
-        for (size_t ix = 0; ix < features_matrix->rows; ix++) {
-            // create a slice on the vec_pad
-            EI_DSP_MATRIX_B(window, win_size, vec_pad.cols, vec_pad.buffer + (ix * vec_pad.cols));
-            if (!window.buffer) {
-                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            for (int32_t row = 0; row < rows; row++) {
+                column.buffer[row] = features_col[row * cols];
             }
 
-            ret = numpy::mean_axis0(&window, &mean_matrix);
-            if (ret != EIDSP_OK) {
-                EIDSP_ERR(ret);
+            // mean normalization
+            double sum = 0.0;
+            for (int32_t offset = -pad_size; offset < win_size - pad_size; offset++) {
+                sum += column.buffer[symmetric_row(offset, rows)];
             }
+            for (int32_t row = 0; row < rows; row++) {
+                features_col[row * cols] = column.buffer[row] - static_cast<float>(sum / win_size);
 
-            // subtract the mean for the features
-            for (size_t fm_col = 0; fm_col < features_matrix->cols; fm_col++) {
-                features_matrix->buffer[(ix * features_matrix->cols) + fm_col] =
-                    features_matrix->buffer[(ix * features_matrix->cols) + fm_col] - mean_matrix.buffer[fm_col];
+                sum += column.buffer[symmetric_row(row - pad_size + win_size, rows)];
+                sum -= column.buffer[symmetric_row(row - pad_size, rows)];
             }
-        }
-
-        ret = numpy::pad_1d_symmetric(features_matrix, &vec_pad, pad_size, pad_size);
-        if (ret != EIDSP_OK) {
-            EIDSP_ERR(ret);
-        }
 
-        for (size_t ix = 0; ix < features_matrix->rows; ix++) {
-            // create a slice on the vec_pad
-            EI_DSP_MATRIX_B(window, win_size, vec_pad.cols, vec_pad.buffer + (ix * vec_pad.cols));
-            if (!window.buffer) {
-                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            if (!variance_normalization) {
+                continue;
             }
 
-            if (variance_normalization == true) {
-                ret = numpy::std_axis0(&window, &window_variance);
-                if (ret != EIDSP_OK) {
-                    EIDSP_ERR(ret);
-                }
+            // variance normalization, over the mean normalized values
+            for (int32_t row = 0; row < rows; row++) {
+                column.buffer[row] = features_col[row * cols];
+            }
 
-                features_buffer_ptr = &features_matrix->buffer[ix * vec_pad.cols];
-                for (size_t col = 0; col < vec_pad.cols; col++) {
-                    *(features_buffer_ptr) = (*(features_buffer_ptr)) /
-                                             (window_variance.buffer[col] + 1e-10);
-                    features_buffer_ptr++;
-                }
+            sum = 0.0;
+            double sum_sq = 0.0;
+            for (int32_t offset = -pad_size; offset < win_size - pad_size; offset++) {
+                float v = column.buffer[symmetric_row(offset, rows)];
+                sum += v;
+                sum_sq += (double)v * v;
+            }
+            for (int32_t row = 0; row < rows; row++) {
+                double mean = sum / win_size;
+                double variance = sum_sq / win_size - mean * mean;
+                float std = static_cast<float>(sqrt(variance > 0.0 ? variance : 0.0));
+                features_col[row * cols] = column.buffer[row] / (std + 1e-10);
+
+                float in = column.buffer[symmetric_row(row - pad_size + win_size, rows)];
+                float out = column.buffer[symmetric_row(row - pad_size, rows)];
+                sum += in - (double)out;
+                sum_sq += (double)in * in - (double)out * out;
             }
         }
 
@@ -492,6 +509,8 @@ namespace processing {
      * @param features_matrix input feature matrix, will be modified in place
      */
     static int mfe_normalization(matrix_t *features_matrix, int noise_floor_db) {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_NORMALIZATION);
+
         const float noise = static_cast<float>(noise_floor_db * -1);
         const float noise_scale = 1.0f / (static_cast<float>(noise_floor_db * -1) + 12.0f);
 
@@ -530,6 +549,8 @@ namespace processing {
      * @param features_matrix input feature matrix, will be modified in place
      */
     static int spectrogram_normalization(matrix_t *features_matrix, int noise_floor_db, bool clip_at_one) {
+        EI_PROFILE_ZONE(EI_PROFILER_ZONE_NORMALIZATION);
+
         const float noise = static_cast<float>(noise_floor_db * -1);
         const float noise_scale = 1.0f / (static_cast<float>(noise_floor_db * -1) + 12.0f);
 
@@ -36,6 +36,8 @@
 #if EI_PORTING_CLIB == 1
 #include <stdarg.h>
 #include <stdio.h>
+#include "edge-impulse-sdk/porting/ei_mem_pool.h"
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
 
 __attribute__((weak)) EI_IMPULSE_ERROR ei_run_impulse_check_canceled() {
     return EI_IMPULSE_OK;
@@ -77,18 +79,64 @@ __attribute__((weak)) char ei_getchar(void)
     return getchar();
 }
 
-__attribute__((weak)) void *ei_malloc(size_t size) {
+static void *malloc_impl(size_t size) {
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+    void *p = ei_mem_pool_malloc(size);
+    if (p) {
+        return p;
+    }
+    ei_mem_pool_count_fallback();
+#endif
     return malloc(size);
 }
 
-__attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
+static void *calloc_impl(size_t nitems, size_t size) {
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+    void *p = ei_mem_pool_calloc(nitems, size);
+    if (p) {
+        return p;
+    }
+    ei_mem_pool_count_fallback();
+#endif
     return calloc(nitems, size);
 }
 
-__attribute__((weak)) void ei_free(void *ptr) {
+static void free_impl(void *ptr) {
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+    if (ei_mem_pool_free(ptr)) {
+        return;
+    }
+#endif
     free(ptr);
 }
 
+__attribute__((weak)) void *ei_malloc(size_t size) {
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    return ei_mem_accounting_track(malloc_impl(size + EI_MEM_ACCOUNTING_HEADER_BYTES), size);
+#else
+    return malloc_impl(size);
+#endif
+}
+
+__attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    if (size && nitems > (SIZE_MAX - EI_MEM_ACCOUNTING_HEADER_BYTES) / size) {
+        return NULL;
+    }
+    return ei_mem_accounting_track(calloc_impl(1, nitems * size + EI_MEM_ACCOUNTING_HEADER_BYTES), nitems * size);
+#else
+    return calloc_impl(nitems, size);
+#endif
+}
+
+__attribute__((weak)) void ei_free(void *ptr) {
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    free_impl(ei_mem_accounting_untrack(ptr));
+#else
+    free_impl(ptr);
+#endif
+}
+
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
 extern "C"
 #endif
@@ -0,0 +1,171 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
+
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static portMUX_TYPE accounting_mux = portMUX_INITIALIZER_UNLOCKED;
+#define ACCOUNTING_LOCK()     portENTER_CRITICAL(&accounting_mux)
+#define ACCOUNTING_UNLOCK()   portEXIT_CRITICAL(&accounting_mux)
+#else
+#include <atomic>
+#include <thread>
+
+// a spinlock for the same reason as in ei_mem_pool.cpp: ei_free can run from static destructors
+static std::atomic_flag accounting_flag = ATOMIC_FLAG_INIT;
+#define ACCOUNTING_LOCK()     while (accounting_flag.test_and_set(std::memory_order_acquire)) { std::this_thread::yield(); }
+#define ACCOUNTING_UNLOCK()   accounting_flag.clear(std::memory_order_release)
+#endif // ESP32
+
+typedef struct {
+    size_t size;
+} block_header_t;
+
+static_assert(sizeof(block_header_t) <= EI_MEM_ACCOUNTING_HEADER_BYTES, "header does not fit");
+
+static ei_mem_accounting_stats_t totals;
+
+// per thread, so inferences running in parallel (EI_CLASSIFIER_TFLITE_REENTRANT) each
+// measure their own stages
+static thread_local ei_mem_stage_state_t stage;
+static thread_local size_t thread_in_use_bytes;
+
+void *ei_mem_accounting_track(void *raw, size_t size)
+{
+    if (!raw) {
+        return NULL;
+    }
+
+    block_header_t *header = (block_header_t *)raw;
+    header->size = size;
+
+    ACCOUNTING_LOCK();
+    totals.in_use_bytes += size;
+    totals.alloc_count++;
+    if (totals.in_use_bytes > totals.peak_bytes) {
+        totals.peak_bytes = totals.in_use_bytes;
+    }
+    size_t heap_bytes = totals.in_use_bytes;
+    ACCOUNTING_UNLOCK();
+
+    thread_in_use_bytes += size;
+    if (thread_in_use_bytes > stage.peak_bytes) {
+        stage.peak_bytes = thread_in_use_bytes;
+    }
+    if (heap_bytes > stage.heap_peak_bytes) {
+        stage.heap_peak_bytes = heap_bytes;
+    }
+    stage.alloc_count++;
+
+    return (uint8_t *)raw + EI_MEM_ACCOUNTING_HEADER_BYTES;
+}
+
+void *ei_mem_accounting_untrack(void *ptr)
+{
+    if (!ptr) {
+        return NULL;
+    }
+
+    // ei_free only takes blocks from ei_malloc / ei_calloc, so the header is always there
+    block_header_t *header = (block_header_t *)((uint8_t *)ptr - EI_MEM_ACCOUNTING_HEADER_BYTES);
+
+    ACCOUNTING_LOCK();
+    totals.in_use_bytes -= header->size;
+    totals.free_count++;
+    ACCOUNTING_UNLOCK();
+
+    // The block may have been allocated by another thread. Its bytes stay counted on
+    // that thread (a thread_local can't be reached from here) and this thread only
+    // drops to zero, see "Blocks freed on another thread" in ei_mem_accounting.h.
+    thread_in_use_bytes -= header->size < thread_in_use_bytes ? header->size : thread_in_use_bytes;
+
+    return header;
+}
+
+void ei_mem_accounting_get_stats(ei_mem_accounting_stats_t *stats)
+{
+    ACCOUNTING_LOCK();
+    *stats = totals;
+    ACCOUNTING_UNLOCK();
+}
+
+void ei_mem_accounting_reset_peak(void)
+{
+    ACCOUNTING_LOCK();
+    totals.peak_bytes = totals.in_use_bytes;
+    ACCOUNTING_UNLOCK();
+}
+
+ei_mem_stage_state_t ei_mem_accounting_begin_stage(void)
+{
+    ei_mem_stage_state_t outer = stage;
+    stage.base_bytes = thread_in_use_bytes;
+    stage.peak_bytes = thread_in_use_bytes;
+    ACCOUNTING_LOCK();
+    stage.heap_peak_bytes = totals.in_use_bytes;
+    ACCOUNTING_UNLOCK();
+    stage.alloc_count = 0;
+    return outer;
+}
+
+void ei_mem_accounting_end_stage(ei_mem_stage_state_t outer, ei_mem_stage_stats_t *stats)
+{
+    ei_mem_stage_state_t inner = stage;
+    if (outer.peak_bytes < inner.peak_bytes) {
+        outer.peak_bytes = inner.peak_bytes;
+    }
+    if (outer.heap_peak_bytes < inner.heap_peak_bytes) {
+        outer.heap_peak_bytes = inner.heap_peak_bytes;
+    }
+    outer.alloc_count += inner.alloc_count;
+    stage = outer;
+
+    if (stats) {
+        if (stats->peak_bytes < inner.heap_peak_bytes) {
+            stats->peak_bytes = inner.heap_peak_bytes;
+        }
+        if (stats->stage_peak_bytes < inner.peak_bytes - inner.base_bytes) {
+            stats->stage_peak_bytes = inner.peak_bytes - inner.base_bytes;
+        }
+        stats->alloc_count += inner.alloc_count;
+    }
+}
+
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
@@ -0,0 +1,152 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _EI_MEM_ACCOUNTING_H_
+#define _EI_MEM_ACCOUNTING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+
+/**
+ * Lightweight memory accounting for ei_malloc / ei_calloc / ei_free.
+ *
+ * With EI_CLASSIFIER_MEMORY_ACCOUNTING set, the porting layer puts a 16 byte
+ * header holding the requested size in front of every block, so every pointer
+ * passed to ei_free must come from ei_malloc / ei_calloc. The module then
+ * keeps a handful of counters: bytes in use, peak, and number of allocations.
+ * There is no printing and no per-pointer bookkeeping, so it is cheap enough
+ * to leave on in production builds (unlike EIDSP_TRACK_ALLOCATIONS).
+ *
+ * The pipeline stages wrap themselves in an EiMemStage scope. That records the
+ * peak and the number of allocations while the stage ran into an
+ * ei_mem_stage_stats_t, which run_classifier puts in `result->memory`.
+ * Stages are tracked per thread: a stage only counts the allocations of the
+ * thread it runs on, so parallel inferences don't mix their numbers.
+ *
+ * Blocks freed on another thread than the one that allocated them are a known
+ * limit of the per thread numbers: the free is taken off the freeing thread
+ * (clamped at zero), while the allocating thread keeps counting the bytes. The
+ * freeing thread then under-reports stage_peak_bytes until its count is back
+ * in line. The SDK frees its buffers on the thread of the inference, so this
+ * only shows when the application hands blocks between threads. The heap wide
+ * numbers (in_use_bytes, peak_bytes) are always exact.
+ */
+
+#define EI_MEM_ACCOUNTING_HEADER_BYTES      16
+
+typedef struct {
+    size_t peak_bytes;          // highest SDK heap usage (all threads) while the stage ran
+    size_t stage_peak_bytes;    // highest usage of the stage's own thread, minus what it had when it started
+    uint32_t alloc_count;
+} ei_mem_stage_stats_t;
+
+// state of the stage being measured on the calling thread, internal
+typedef struct {
+    size_t base_bytes;          // bytes of this thread when the stage started
+    size_t peak_bytes;          // highest bytes of this thread
+    size_t heap_peak_bytes;     // highest SDK heap usage seen by this thread
+    uint32_t alloc_count;
+} ei_mem_stage_state_t;
+
+typedef struct {
+    size_t in_use_bytes;
+    size_t peak_bytes;
+    uint32_t alloc_count;
+    uint32_t free_count;
+} ei_mem_accounting_stats_t;
+
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+
+/**
+ * Fill in the header of a block allocated with EI_MEM_ACCOUNTING_HEADER_BYTES
+ * extra bytes and count it. Returns the pointer to hand out (NULL for NULL).
+ */
+void *ei_mem_accounting_track(void *raw, size_t size);
+
+/**
+ * Count a block as freed, returns the pointer originally allocated
+ */
+void *ei_mem_accounting_untrack(void *ptr);
+
+void ei_mem_accounting_get_stats(ei_mem_accounting_stats_t *stats);
+
+/**
+ * Set the peak back to the current usage
+ */
+void ei_mem_accounting_reset_peak(void);
+
+/**
+ * Start measuring a stage. Returns the state of the enclosing stage, which has
+ * to be passed back to ei_mem_accounting_end_stage.
+ */
+ei_mem_stage_state_t ei_mem_accounting_begin_stage(void);
+
+/**
+ * Stop measuring the current stage, merge it into `stats` (peaks are maxed,
+ * counts are added) and resume the enclosing stage.
+ */
+void ei_mem_accounting_end_stage(ei_mem_stage_state_t outer, ei_mem_stage_stats_t *stats);
+
+#ifdef __cplusplus
+namespace ei {
+
+class EiMemStage {
+public:
+    EiMemStage(ei_mem_stage_stats_t *stats) : _stats(stats), _outer(ei_mem_accounting_begin_stage()) { }
+    ~EiMemStage() { ei_mem_accounting_end_stage(_outer, _stats); }
+
+private:
+    EiMemStage(const EiMemStage&) = delete;
+    EiMemStage& operator=(const EiMemStage&) = delete;
+
+    ei_mem_stage_stats_t *_stats;
+    ei_mem_stage_state_t _outer;
+};
+
+} // namespace ei
+#endif // __cplusplus
+
+#define EI_MEM_STAGE_CONCAT_(a, b) a##b
+#define EI_MEM_STAGE_CONCAT(a, b) EI_MEM_STAGE_CONCAT_(a, b)
+#define EI_MEM_STAGE(stats) ei::EiMemStage EI_MEM_STAGE_CONCAT(_ei_mem_stage_, __LINE__)(stats)
+
+#else
+
+#define EI_MEM_STAGE(stats) (void)0
+
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
+
+#endif // _EI_MEM_ACCOUNTING_H_
@@ -0,0 +1,483 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "edge-impulse-sdk/porting/ei_mem_pool.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#include <string.h>
+
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static portMUX_TYPE pool_mux = portMUX_INITIALIZER_UNLOCKED;
+#define POOL_LOCK()     portENTER_CRITICAL(&pool_mux)
+#define POOL_UNLOCK()   portEXIT_CRITICAL(&pool_mux)
+#else
+#include <atomic>
+#include <thread>
+
+// a spinlock rather than a std::mutex, ei_free can still be called from
+// static destructors after a mutex would have been destroyed
+static std::atomic_flag pool_flag = ATOMIC_FLAG_INIT;
+#define POOL_LOCK()     while (pool_flag.test_and_set(std::memory_order_acquire)) { std::this_thread::yield(); }
+#define POOL_UNLOCK()   pool_flag.clear(std::memory_order_release)
+#endif // ESP32
+
+#define POOL_ALIGN          16
+#define POOL_ALIGN_UP(x)    (((x) + (POOL_ALIGN - 1)) & ~((size_t)POOL_ALIGN - 1))
+#define ARENA_MAGIC         0xE1A110C5
+
+#if EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL == 0
+static uint8_t builtin_region[EI_CLASSIFIER_ALLOCATOR_POOL_SIZE] __attribute__((aligned(16)));
+#endif
+
+static const uint16_t class_sizes[EI_MEM_POOL_CLASS_COUNT] = { 16, 32, 64, 128, 256, 512 };
+
+typedef struct {
+    uint8_t *base;
+    uint16_t blocks;
+    uint16_t touched;       // blocks below this index have been handed out at least once
+    uint16_t in_use;
+    uint16_t peak;
+    void *free_list;
+} size_class_t;
+
+// precedes every arena block, keeps the arena 16-byte aligned
+typedef struct {
+    uint32_t size;          // payload bytes
+    uint32_t prev;          // offset + 1 of the previous header, 0 for the first block
+    uint32_t magic;
+    uint32_t free;
+} arena_header_t;
+
+static struct {
+    bool ready;
+    uint8_t *region;
+    size_t region_bytes;
+    size_class_t classes[EI_MEM_POOL_CLASS_COUNT];
+    uint8_t *small_end;
+    uint8_t *arena;
+    size_t arena_bytes;
+    size_t top;
+    uint32_t top_header;    // offset + 1 of the last header, 0 when empty
+    size_t live;
+    size_t peak_live;
+    size_t arena_peak;
+    size_t holes;
+    uint32_t alloc_count;
+    uint32_t fallback_count;
+} pool;
+
+// must be called with the lock held
+static void pool_setup(uint8_t *region, size_t size)
+{
+    uint8_t *aligned = (uint8_t *)POOL_ALIGN_UP((uintptr_t)region);
+    size -= aligned - region;
+    size &= ~((size_t)POOL_ALIGN - 1);
+
+    size_t small = EI_CLASSIFIER_ALLOCATOR_SMALL_POOL_SIZE;
+    if (small > size / 2) {
+        small = size / 2;
+    }
+
+    memset(&pool, 0, sizeof(pool));
+    pool.region = aligned;
+    pool.region_bytes = size;
+
+    uint8_t *p = aligned;
+    for (size_t ix = 0; ix < EI_MEM_POOL_CLASS_COUNT; ix++) {
+        size_t blocks = (small / EI_MEM_POOL_CLASS_COUNT) / class_sizes[ix];
+        if (blocks > UINT16_MAX) {
+            blocks = UINT16_MAX;
+        }
+        pool.classes[ix].base = p;
+        pool.classes[ix].blocks = (uint16_t)blocks;
+        p += blocks * class_sizes[ix];
+    }
+    pool.small_end = p;
+    pool.arena = p;
+    pool.arena_bytes = size - (p - aligned);
+    pool.ready = true;
+}
+
+// must be called with the lock held, false while there is no region yet
+static bool pool_ensure_ready(void)
+{
+#if EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL == 0
+    if (!pool.ready) {
+        pool_setup(builtin_region, sizeof(builtin_region));
+    }
+#endif
+    return pool.ready;
+}
+
+static void *class_alloc(size_class_t *c, uint16_t block_size)
+{
+    void *ptr;
+    if (c->free_list) {
+        ptr = c->free_list;
+        c->free_list = *(void **)ptr;
+    }
+    else if (c->touched < c->blocks) {
+        ptr = c->base + (size_t)c->touched * block_size;
+        c->touched++;
+    }
+    else {
+        return NULL;
+    }
+    c->in_use++;
+    if (c->in_use > c->peak) {
+        c->peak = c->in_use;
+    }
+    pool.live += block_size;
+    return ptr;
+}
+
+static uint32_t arena_link(const arena_header_t *header)
+{
+    return (uint32_t)((const uint8_t *)header - pool.arena) + 1;
+}
+
+static arena_header_t *arena_first(void)
+{
+    return pool.top > 0 ? (arena_header_t *)pool.arena : NULL;
+}
+
+// the block above header, NULL for the top block
+static arena_header_t *arena_next(arena_header_t *header)
+{
+    uint8_t *next = (uint8_t *)(header + 1) + header->size;
+    return next < pool.arena + pool.top ? (arena_header_t *)next : NULL;
+}
+
+static void arena_relink_next(arena_header_t *header)
+{
+    arena_header_t *next = arena_next(header);
+    if (next) {
+        next->prev = arena_link(header);
+    }
+}
+
+// first fit over the holes, the rest of the hole is split off if a block fits in it
+static void *arena_alloc_hole(size_t payload)
+{
+    if (pool.holes < payload) {
+        return NULL;
+    }
+
+    arena_header_t *header = arena_first();
+    while (header && (!header->free || header->size < payload)) {
+        header = arena_next(header);
+    }
+    if (!header) {
+        return NULL;
+    }
+
+    size_t rest = header->size - payload;
+    if (rest >= sizeof(arena_header_t) + POOL_ALIGN) {
+        arena_header_t *split = (arena_header_t *)((uint8_t *)(header + 1) + payload);
+        split->size = (uint32_t)(rest - sizeof(arena_header_t));
+        split->prev = arena_link(header);
+        split->magic = ARENA_MAGIC;
+        split->free = 1;
+        arena_relink_next(split);
+        header->size = (uint32_t)payload;
+        pool.holes -= sizeof(arena_header_t);
+    }
+
+    header->free = 0;
+    pool.holes -= header->size;
+    pool.live += header->size;
+    return header + 1;
+}
+
+static void *arena_alloc(size_t size)
+{
+    size_t payload = POOL_ALIGN_UP(size);
+    void *ptr = arena_alloc_hole(payload);
+    if (ptr) {
+        return ptr;
+    }
+
+    size_t needed = sizeof(arena_header_t) + payload;
+    if (needed > pool.arena_bytes - pool.top) {
+        return NULL;
+    }
+
+    arena_header_t *header = (arena_header_t *)(pool.arena + pool.top);
+    header->size = (uint32_t)payload;
+    header->prev = pool.top_header;
+    header->magic = ARENA_MAGIC;
+    header->free = 0;
+
+    pool.top_header = (uint32_t)pool.top + 1;
+    pool.top += needed;
+    if (pool.top > pool.arena_peak) {
+        pool.arena_peak = pool.top;
+    }
+    pool.live += payload;
+    return header + 1;
+}
+
+static void arena_free(arena_header_t *header)
+{
+    header->free = 1;
+    pool.live -= header->size;
+
+    if (arena_link(header) != pool.top_header) {
+        // merge with freed neighbours, so the hole can take larger requests
+        pool.holes += header->size;
+        arena_header_t *next = arena_next(header);
+        if (next && next->free) {
+            header->size += sizeof(arena_header_t) + next->size;
+            next->magic = 0;
+            pool.holes += sizeof(arena_header_t);
+            arena_relink_next(header);
+        }
+        arena_header_t *below = header->prev ? (arena_header_t *)(pool.arena + header->prev - 1) : NULL;
+        if (below && below->free) {
+            below->size += sizeof(arena_header_t) + header->size;
+            header->magic = 0;
+            pool.holes += sizeof(arena_header_t);
+            arena_relink_next(below);
+        }
+        return;
+    }
+
+    // rewind over this block and the freed block directly below it
+    pool.top = (uint8_t *)header - pool.arena;
+    pool.top_header = header->prev;
+    while (pool.top_header != 0) {
+        arena_header_t *below = (arena_header_t *)(pool.arena + pool.top_header - 1);
+        if (!below->free) {
+            break;
+        }
+        pool.holes -= below->size;
+        pool.top = (uint8_t *)below - pool.arena;
+        pool.top_header = below->prev;
+    }
+}
+
+EI_IMPULSE_ERROR ei_mem_pool_init(void *region, size_t size)
+{
+    if (!region || size < 2 * POOL_ALIGN) {
+        return EI_IMPULSE_INVALID_SIZE;
+    }
+
+    POOL_LOCK();
+    if (pool.live != 0) {
+        POOL_UNLOCK();
+        ei_printf("ERR: ei_mem_pool_init called while memory is allocated from the pool\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+    pool_setup((uint8_t *)region, size);
+    POOL_UNLOCK();
+    return EI_IMPULSE_OK;
+}
+
+void *ei_mem_pool_malloc(size_t size)
+{
+    if (size == 0) {
+        size = 1;
+    }
+
+    POOL_LOCK();
+    if (!pool_ensure_ready()) {
+        POOL_UNLOCK();
+        return NULL;
+    }
+
+    void *ptr = NULL;
+    for (size_t ix = 0; ix < EI_MEM_POOL_CLASS_COUNT && !ptr; ix++) {
+        if (size <= class_sizes[ix]) {
+            ptr = class_alloc(&pool.classes[ix], class_sizes[ix]);
+        }
+    }
+    if (!ptr) {
+        ptr = arena_alloc(size);
+    }
+    if (ptr) {
+        pool.alloc_count++;
+        if (pool.live > pool.peak_live) {
+            pool.peak_live = pool.live;
+        }
+    }
+    POOL_UNLOCK();
+
+    return ptr;
+}
+
+void *ei_mem_pool_calloc(size_t nitems, size_t size)
+{
+    if (size != 0 && nitems > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = ei_mem_pool_malloc(nitems * size);
+    if (ptr) {
+        memset(ptr, 0, nitems * size);
+    }
+    return ptr;
+}
+
+bool ei_mem_pool_free(void *ptr)
+{
+    uint8_t *p = (uint8_t *)ptr;
+
+    POOL_LOCK();
+    if (!pool.ready || p < pool.region || p >= pool.region + pool.region_bytes) {
+        POOL_UNLOCK();
+        return false;
+    }
+    if (p < pool.small_end) {
+        for (size_t ix = 0; ix < EI_MEM_POOL_CLASS_COUNT; ix++) {
+            size_class_t *c = &pool.classes[ix];
+            if (p < c->base + (size_t)c->blocks * class_sizes[ix]) {
+                *(void **)p = c->free_list;
+                c->free_list = p;
+                c->in_use--;
+                pool.live -= class_sizes[ix];
+                break;
+            }
+        }
+    }
+    else {
+        arena_header_t *header = (arena_header_t *)p - 1;
+        if (header->magic == ARENA_MAGIC && !header->free) {
+            arena_free(header);
+        }
+        else {
+            POOL_UNLOCK();
+            ei_printf("ERR: ei_mem_pool_free called with invalid pointer %p\n", ptr);
+            return true;
+        }
+    }
+    POOL_UNLOCK();
+    return true;
+}
+
+void ei_mem_pool_count_fallback(void)
+{
+    POOL_LOCK();
+    pool.fallback_count++;
+    POOL_UNLOCK();
+}
+
+void ei_mem_pool_get_stats(ei_mem_pool_stats_t *stats)
+{
+    memset(stats, 0, sizeof(ei_mem_pool_stats_t));
+
+    POOL_LOCK();
+    pool_ensure_ready();
+    stats->region_bytes = pool.region_bytes;
+    stats->live_bytes = pool.live;
+    stats->peak_live_bytes = pool.peak_live;
+    stats->arena_bytes = pool.arena_bytes;
+    stats->arena_used_bytes = pool.top;
+    stats->arena_peak_bytes = pool.arena_peak;
+    stats->arena_hole_bytes = pool.holes;
+    stats->alloc_count = pool.alloc_count;
+    stats->heap_fallback_count = pool.fallback_count;
+
+    if (pool.arena_bytes - pool.top > sizeof(arena_header_t)) {
+        stats->largest_free_block = pool.arena_bytes - pool.top - sizeof(arena_header_t);
+    }
+    for (arena_header_t *header = arena_first(); header && pool.holes > 0; header = arena_next(header)) {
+        if (header->free && header->size > stats->largest_free_block) {
+            stats->largest_free_block = header->size;
+        }
+    }
+    for (size_t ix = 0; ix < EI_MEM_POOL_CLASS_COUNT; ix++) {
+        const size_class_t *c = &pool.classes[ix];
+        stats->class_size[ix] = class_sizes[ix];
+        stats->class_blocks[ix] = c->blocks;
+        stats->class_in_use[ix] = c->in_use;
+        stats->class_peak[ix] = c->peak;
+        if (c->in_use < c->blocks && class_sizes[ix] > stats->largest_free_block) {
+            stats->largest_free_block = class_sizes[ix];
+        }
+    }
+    POOL_UNLOCK();
+}
+
+void ei_mem_pool_reset_peaks(void)
+{
+    POOL_LOCK();
+    pool.peak_live = pool.live;
+    pool.arena_peak = pool.top;
+    for (size_t ix = 0; ix < EI_MEM_POOL_CLASS_COUNT; ix++) {
+        pool.classes[ix].peak = pool.classes[ix].in_use;
+    }
+    POOL_UNLOCK();
+}
+
+#else
+
+EI_IMPULSE_ERROR ei_mem_pool_init(void *region, size_t size)
+{
+    return EI_IMPULSE_OK;
+}
+
+void *ei_mem_pool_malloc(size_t size)
+{
+    return NULL;
+}
+
+void *ei_mem_pool_calloc(size_t nitems, size_t size)
+{
+    return NULL;
+}
+
+bool ei_mem_pool_free(void *ptr)
+{
+    return false;
+}
+
+void ei_mem_pool_count_fallback(void)
+{
+}
+
+void ei_mem_pool_get_stats(ei_mem_pool_stats_t *stats)
+{
+    memset(stats, 0, sizeof(ei_mem_pool_stats_t));
+}
+
+void ei_mem_pool_reset_peaks(void)
+{
+}
+
+#endif // EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
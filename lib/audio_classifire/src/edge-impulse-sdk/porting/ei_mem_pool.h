@@ -0,0 +1,125 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _EI_MEM_POOL_H_
+#define _EI_MEM_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/dsp/returntypes.h"
+
+/**
+ * Bounded allocator behind ei_malloc / ei_calloc / ei_free.
+ *
+ * With EI_CLASSIFIER_ALLOCATOR_POOL_SIZE set, a region of that many bytes is
+ * reserved at link time and every SDK allocation is served from it, so the
+ * classifier no longer competes with the rest of the application for the
+ * system heap. With EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL nothing is reserved,
+ * the region is the one passed to ei_mem_pool_init(). The region is split in two:
+ *
+ *  - size-class pools (16 .. 512 bytes, EI_CLASSIFIER_ALLOCATOR_SMALL_POOL_SIZE
+ *    bytes in total, shared equally between the classes) with a free list each,
+ *    for the many small vectors and matrices the DSP code creates.
+ *  - a bump arena for everything larger (frame / FFT buffers, the feature
+ *    matrix, the tensor arena). Freeing the block on top rewinds the arena,
+ *    together with a freed block directly below it, so once an inference
+ *    has released its buffers the arena is back at its base. Blocks freed out
+ *    of order become holes: they are merged with freed neighbours and reused
+ *    first fit, before the arena grows.
+ *
+ * Requests that don't fit are passed on to the system heap by the porting
+ * layer and counted in `heap_fallback_count`, so enabling the pool never turns
+ * a working allocation into a failure. All blocks are 16-byte aligned.
+ *
+ * The allocator is thread safe. It does not depend on any target API other
+ * than a lock, so it also runs in hosted builds.
+ */
+
+#define EI_MEM_POOL_CLASS_COUNT     6
+
+typedef struct {
+    size_t region_bytes;
+    size_t live_bytes;          // bytes handed out from the region, rounded up to block size
+    size_t peak_live_bytes;
+    size_t arena_bytes;         // size of the bump arena
+    size_t arena_used_bytes;    // current bump position, including holes
+    size_t arena_peak_bytes;
+    size_t arena_hole_bytes;    // freed, but below a live block, reused first fit
+    size_t largest_free_block;  // largest request that can be served right now
+    uint32_t alloc_count;
+    uint32_t heap_fallback_count;
+    uint16_t class_size[EI_MEM_POOL_CLASS_COUNT];
+    uint16_t class_blocks[EI_MEM_POOL_CLASS_COUNT];
+    uint16_t class_in_use[EI_MEM_POOL_CLASS_COUNT];
+    uint16_t class_peak[EI_MEM_POOL_CLASS_COUNT];
+} ei_mem_pool_stats_t;
+
+/**
+ * Use `region` instead of the built-in one. Only allowed while nothing is
+ * allocated from the pool, e.g. at boot to place the pool in external RAM.
+ * Required with EI_CLASSIFIER_ALLOCATOR_POOL_EXTERNAL, which reserves no
+ * built-in region.
+ */
+EI_IMPULSE_ERROR ei_mem_pool_init(void *region, size_t size);
+
+/**
+ * Allocate from the pool, returns NULL if the request doesn't fit
+ */
+void *ei_mem_pool_malloc(size_t size);
+
+/**
+ * Allocate zeroed memory from the pool, returns NULL if the request doesn't fit
+ */
+void *ei_mem_pool_calloc(size_t nitems, size_t size);
+
+/**
+ * Free a block, returns false if `ptr` was not allocated from the pool
+ */
+bool ei_mem_pool_free(void *ptr);
+
+/**
+ * Count a request that was served by the system heap instead
+ */
+void ei_mem_pool_count_fallback(void);
+
+void ei_mem_pool_get_stats(ei_mem_pool_stats_t *stats);
+
+/**
+ * Set the peak counters back to the current usage
+ */
+void ei_mem_pool_reset_peaks(void);
+
+#endif // _EI_MEM_POOL_H_
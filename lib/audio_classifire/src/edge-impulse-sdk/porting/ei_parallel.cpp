@@ -0,0 +1,358 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "edge-impulse-sdk/porting/ei_parallel.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#if EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS > 0
+
+#include <atomic>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// one helper per remaining core
+#if EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS > (portNUM_PROCESSORS - 1)
+#define EI_PARALLEL_WORKERS         (portNUM_PROCESSORS - 1)
+#else
+#define EI_PARALLEL_WORKERS         EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS
+#endif
+
+#ifndef EI_PARALLEL_TASK_STACK_SIZE
+#define EI_PARALLEL_TASK_STACK_SIZE 2048
+#endif
+
+#else
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#define EI_PARALLEL_WORKERS         EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS
+#endif // ESP32
+
+typedef struct {
+    ei_parallel_fn_t fn;
+    void *ctx;
+    int start;
+    int end;
+} ei_parallel_job_t;
+
+static ei_parallel_job_t jobs[EI_PARALLEL_WORKERS];
+static bool running = false;
+static std::atomic_flag busy = ATOMIC_FLAG_INIT;
+
+#if defined(ESP32)
+
+static TaskHandle_t worker_tasks[EI_PARALLEL_WORKERS];
+static SemaphoreHandle_t start_sems[EI_PARALLEL_WORKERS];
+static SemaphoreHandle_t done_sems[EI_PARALLEL_WORKERS];
+
+static void worker_loop(void *arg)
+{
+    const int ix = (int)(intptr_t)arg;
+
+    while (true) {
+        xSemaphoreTake(start_sems[ix], portMAX_DELAY);
+        const ei_parallel_job_t job = jobs[ix];
+        if (job.fn == NULL) {
+            break;
+        }
+        job.fn(job.ctx, job.start, job.end);
+        xSemaphoreGive(done_sems[ix]);
+    }
+
+    xSemaphoreGive(done_sems[ix]);
+    vTaskDelete(NULL);
+}
+
+static bool workers_start()
+{
+    const BaseType_t core = xPortGetCoreID();
+    const UBaseType_t priority = uxTaskPriorityGet(NULL);
+
+    for (int ix = 0; ix < EI_PARALLEL_WORKERS; ix++) {
+        start_sems[ix] = xSemaphoreCreateBinary();
+        done_sems[ix] = xSemaphoreCreateBinary();
+        if (!start_sems[ix] || !done_sems[ix]) {
+            return false;
+        }
+        if (xTaskCreatePinnedToCore(worker_loop, "ei_parallel", EI_PARALLEL_TASK_STACK_SIZE,
+                (void *)(intptr_t)ix, priority, &worker_tasks[ix],
+                (core + 1 + ix) % portNUM_PROCESSORS) != pdPASS) {
+            worker_tasks[ix] = NULL;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void workers_post(int count)
+{
+    for (int ix = 0; ix < count; ix++) {
+        xSemaphoreGive(start_sems[ix]);
+    }
+}
+
+static void workers_wait(int count)
+{
+    for (int ix = 0; ix < count; ix++) {
+        xSemaphoreTake(done_sems[ix], portMAX_DELAY);
+    }
+}
+
+static void workers_stop()
+{
+    for (int ix = 0; ix < EI_PARALLEL_WORKERS; ix++) {
+        if (worker_tasks[ix]) {
+            jobs[ix].fn = NULL;
+            xSemaphoreGive(start_sems[ix]);
+            xSemaphoreTake(done_sems[ix], portMAX_DELAY);
+            worker_tasks[ix] = NULL;
+        }
+        if (start_sems[ix]) {
+            vSemaphoreDelete(start_sems[ix]);
+            start_sems[ix] = NULL;
+        }
+        if (done_sems[ix]) {
+            vSemaphoreDelete(done_sems[ix]);
+            done_sems[ix] = NULL;
+        }
+    }
+}
+
+#else
+
+// Heap allocated and only freed by ei_parallel_deinit, so the parked threads
+// don't get their mutex / condition variables destroyed under them at exit.
+typedef struct {
+    std::thread threads[EI_PARALLEL_WORKERS];
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    unsigned generation;
+    int active;
+    int pending;
+    bool stopping;
+} ei_parallel_pool_t;
+
+static ei_parallel_pool_t *pool = NULL;
+
+static void worker_loop(int ix)
+{
+    unsigned seen = 0;
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        pool->start_cv.wait(lock, [&] { return pool->stopping || pool->generation != seen; });
+        if (pool->stopping) {
+            return;
+        }
+        seen = pool->generation;
+        if (ix >= pool->active) {
+            continue;
+        }
+        const ei_parallel_job_t job = jobs[ix];
+        lock.unlock();
+
+        job.fn(job.ctx, job.start, job.end);
+
+        lock.lock();
+        if (--pool->pending == 0) {
+            pool->done_cv.notify_one();
+        }
+    }
+}
+
+static bool workers_start()
+{
+    pool = new (std::nothrow) ei_parallel_pool_t();
+    if (!pool) {
+        return false;
+    }
+    for (int ix = 0; ix < EI_PARALLEL_WORKERS; ix++) {
+        pool->threads[ix] = std::thread(worker_loop, ix);
+    }
+    return true;
+}
+
+static void workers_post(int count)
+{
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->active = count;
+    pool->pending = count;
+    pool->generation++;
+    pool->start_cv.notify_all();
+}
+
+static void workers_wait(int count)
+{
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->done_cv.wait(lock, [] { return pool->pending == 0; });
+}
+
+static void workers_stop()
+{
+    if (!pool) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->stopping = true;
+        pool->start_cv.notify_all();
+    }
+    for (int ix = 0; ix < EI_PARALLEL_WORKERS; ix++) {
+        if (pool->threads[ix].joinable()) {
+            pool->threads[ix].join();
+        }
+    }
+    delete pool;
+    pool = NULL;
+}
+
+#endif // ESP32
+
+// must be called with busy held
+static EI_IMPULSE_ERROR pool_start()
+{
+    if (running) {
+        return EI_IMPULSE_OK;
+    }
+    if (!workers_start()) {
+        ei_printf("ERR: failed to start parallel workers\n");
+        workers_stop();
+        return EI_IMPULSE_OUT_OF_MEMORY;
+    }
+    running = true;
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR ei_parallel_init(void)
+{
+    // pool in use, so it is already running
+    if (busy.test_and_set()) {
+        return EI_IMPULSE_OK;
+    }
+    EI_IMPULSE_ERROR res = pool_start();
+    busy.clear();
+    return res;
+}
+
+void ei_parallel_deinit(void)
+{
+    if (busy.test_and_set()) {
+        return;
+    }
+    if (running) {
+        workers_stop();
+        running = false;
+    }
+    busy.clear();
+}
+
+int ei_parallel_thread_count(void)
+{
+    return EI_PARALLEL_WORKERS + 1;
+}
+
+void ei_parallel_for(int count, int grain, ei_parallel_fn_t fn, void *ctx)
+{
+    if (grain < 1) {
+        grain = 1;
+    }
+
+    int chunks = count / grain;
+    if (chunks > EI_PARALLEL_WORKERS + 1) {
+        chunks = EI_PARALLEL_WORKERS + 1;
+    }
+
+    if (chunks < 2 || busy.test_and_set()) {
+        fn(ctx, 0, count);
+        return;
+    }
+
+    if (pool_start() != EI_IMPULSE_OK) {
+        busy.clear();
+        fn(ctx, 0, count);
+        return;
+    }
+
+    // caller takes the first chunk, helpers the rest
+    const int helpers = chunks - 1;
+    const int per_chunk = count / chunks;
+    const int remainder = count % chunks;
+    int start = per_chunk + (remainder > 0 ? 1 : 0);
+    const int first_end = start;
+
+    for (int ix = 0; ix < helpers; ix++) {
+        const int len = per_chunk + ((ix + 1) < remainder ? 1 : 0);
+        jobs[ix].fn = fn;
+        jobs[ix].ctx = ctx;
+        jobs[ix].start = start;
+        jobs[ix].end = start + len;
+        start += len;
+    }
+
+    workers_post(helpers);
+    fn(ctx, 0, first_end);
+    workers_wait(helpers);
+
+    busy.clear();
+}
+
+#else
+
+EI_IMPULSE_ERROR ei_parallel_init(void)
+{
+    return EI_IMPULSE_OK;
+}
+
+void ei_parallel_deinit(void)
+{
+}
+
+int ei_parallel_thread_count(void)
+{
+    return 1;
+}
+
+void ei_parallel_for(int count, int grain, ei_parallel_fn_t fn, void *ctx)
+{
+    fn(ctx, 0, count);
+}
+
+#endif // EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS > 0
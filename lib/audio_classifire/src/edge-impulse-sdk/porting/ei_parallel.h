@@ -0,0 +1,92 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _EI_PARALLEL_H_
+#define _EI_PARALLEL_H_
+
+#include <stdint.h>
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/dsp/returntypes.h"
+
+/**
+ * Intra-op parallelism for the TFLite kernels.
+ *
+ * A kernel describes its work as a range of independent items (output rows of a
+ * fully connected layer, output columns of a convolution) and hands it to
+ * `ei_parallel_for`. The range is split into contiguous chunks: the calling
+ * thread runs the first chunk and up to EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS
+ * helper threads run the others. The call returns when every chunk is done.
+ *
+ * On ESP32 the helper is a FreeRTOS task pinned to the other core, on hosted
+ * builds the helpers are std::threads. With EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS
+ * set to 0 (default) everything runs inline on the calling thread.
+ *
+ * The helpers are started on the first call and parked on a semaphore between
+ * calls; `ei_parallel_deinit` stops them. Calls that arrive while the pool is
+ * busy (e.g. from a second inference thread) run inline.
+ */
+
+/**
+ * Work function, processes items [start, end)
+ */
+typedef void (*ei_parallel_fn_t)(void *ctx, int start, int end);
+
+/**
+ * Start the helper threads. Optional, `ei_parallel_for` starts them on first use.
+ */
+EI_IMPULSE_ERROR ei_parallel_init(void);
+
+/**
+ * Stop the helper threads and free their resources.
+ */
+void ei_parallel_deinit(void);
+
+/**
+ * Number of threads (including the caller) `ei_parallel_for` splits work across.
+ */
+int ei_parallel_thread_count(void);
+
+/**
+ * Run fn over [0, count), split across the calling thread and the helpers.
+ *
+ * @param count Number of items
+ * @param grain Minimum number of items per chunk; ranges shorter than
+ *              2 * grain are not split
+ * @param fn Work function, must only touch the items it is given
+ * @param ctx Passed to fn
+ */
+void ei_parallel_for(int count, int grain, ei_parallel_fn_t fn, void *ctx);
+
+#endif // _EI_PARALLEL_H_
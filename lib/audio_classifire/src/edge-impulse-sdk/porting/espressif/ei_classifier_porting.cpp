@@ -49,6 +49,8 @@
 
 // memory handling
 #include "esp_heap_caps.h"
+#include "edge-impulse-sdk/porting/ei_mem_pool.h"
+#include "edge-impulse-sdk/porting/ei_mem_accounting.h"
 
 #define EI_WEAK_FN __attribute__((weak))
 
@@ -97,7 +99,14 @@ __attribute__((weak)) void ei_printf_float(float f) {
 
 // we use alligned alloc instead of regular malloc
 // due to https://github.com/espressif/esp-nn/issues/7
-__attribute__((weak)) void *ei_malloc(size_t size) {
+static void *malloc_impl(size_t size) {
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+    void *p = ei_mem_pool_malloc(size);
+    if (p) {
+        return p;
+    }
+    ei_mem_pool_count_fallback();
+#endif
 #if defined(CONFIG_IDF_TARGET_ESP32S3)
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 1)
     return heap_caps_aligned_alloc(16, size, MALLOC_CAP_DEFAULT);
@@ -108,7 +117,14 @@ __attribute__((weak)) void *ei_malloc(size_t size) {
     return malloc(size);
 }
 
-__attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
+static void *calloc_impl(size_t nitems, size_t size) {
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+    void *pool_ptr = ei_mem_pool_calloc(nitems, size);
+    if (pool_ptr) {
+        return pool_ptr;
+    }
+    ei_mem_pool_count_fallback();
+#endif
 #if defined(CONFIG_IDF_TARGET_ESP32S3)
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 1)
     return heap_caps_calloc(nitems, size, MALLOC_CAP_DEFAULT);
@@ -125,10 +141,42 @@ __attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
     return calloc(nitems, size);
 }
 
-__attribute__((weak)) void ei_free(void *ptr) {
+static void free_impl(void *ptr) {
+#if EI_CLASSIFIER_ALLOCATOR_POOL_SIZE > 0
+    if (ei_mem_pool_free(ptr)) {
+        return;
+    }
+#endif
     free(ptr);
 }
 
+__attribute__((weak)) void *ei_malloc(size_t size) {
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    return ei_mem_accounting_track(malloc_impl(size + EI_MEM_ACCOUNTING_HEADER_BYTES), size);
+#else
+    return malloc_impl(size);
+#endif
+}
+
+__attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    if (size && nitems > (SIZE_MAX - EI_MEM_ACCOUNTING_HEADER_BYTES) / size) {
+        return NULL;
+    }
+    return ei_mem_accounting_track(calloc_impl(1, nitems * size + EI_MEM_ACCOUNTING_HEADER_BYTES), nitems * size);
+#else
+    return calloc_impl(nitems, size);
+#endif
+}
+
+__attribute__((weak)) void ei_free(void *ptr) {
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    free_impl(ei_mem_accounting_untrack(ptr));
+#else
+    free_impl(ptr);
+#endif
+}
+
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
 extern "C"
 #endif
@@ -0,0 +1,541 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#if EI_CLASSIFIER_TFLITE_ENABLE_ESP_NN
+
+#include <stdio.h>
+#include <string.h>
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/porting/espressif/ei_esp_nn_dispatch.h"
+
+#if EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+#include "nvs.h"
+#endif
+
+#define EI_ESP_NN_ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+static const ei_esp_nn_conv_impl_t conv_impls[] = {
+    { "ansi", esp_nn_conv_s8_ansi, esp_nn_get_conv_scratch_size_ansi, esp_nn_set_conv_scratch_buf_ansi },
+    { "opt", esp_nn_conv_s8_opt, esp_nn_get_conv_scratch_size_opt, esp_nn_set_conv_scratch_buf_opt },
+#if defined(ARCH_ESP32_S3)
+    { "esp32s3", esp_nn_conv_s8_esp32s3, esp_nn_get_conv_scratch_size_esp32s3, esp_nn_set_conv_scratch_buf_esp32s3 },
+#endif
+#if defined(ARCH_ESP32_P4)
+    { "esp32p4", esp_nn_conv_s8_esp32p4, esp_nn_get_conv_scratch_size_esp32p4, esp_nn_set_conv_scratch_buf_esp32p4 },
+#endif
+};
+
+static const ei_esp_nn_fully_connected_impl_t fully_connected_impls[] = {
+    { "ansi", esp_nn_fully_connected_s8_ansi },
+#if defined(ARCH_ESP32_S3)
+    { "esp32s3", esp_nn_fully_connected_s8_esp32s3 },
+#endif
+};
+
+static const ei_esp_nn_pool_impl_t pool_impls[] = {
+    { "ansi", esp_nn_max_pool_s8_ansi, esp_nn_avg_pool_s8_ansi, 1 },
+#if defined(ARCH_ESP32_S3)
+    { "esp32s3", esp_nn_max_pool_s8_esp32s3, esp_nn_avg_pool_s8_esp32s3, 4 },
+#endif
+};
+
+// The variants esp_nn.h selects at compile time
+static size_t default_conv_impl()
+{
+    for (size_t ix = 0; ix < EI_ESP_NN_ARRAY_SIZE(conv_impls); ix++) {
+        if (conv_impls[ix].conv == esp_nn_conv_s8) {
+            return ix;
+        }
+    }
+    return 0;
+}
+
+static size_t default_fully_connected_impl()
+{
+    for (size_t ix = 0; ix < EI_ESP_NN_ARRAY_SIZE(fully_connected_impls); ix++) {
+        if (fully_connected_impls[ix].fully_connected == esp_nn_fully_connected_s8) {
+            return ix;
+        }
+    }
+    return 0;
+}
+
+static size_t default_pool_impl(bool is_max, int32_t channels)
+{
+    for (size_t ix = 0; ix < EI_ESP_NN_ARRAY_SIZE(pool_impls); ix++) {
+        ei_esp_nn_pool_fn_t fn = is_max ? pool_impls[ix].max_pool : pool_impls[ix].avg_pool;
+        if (fn == (is_max ? esp_nn_max_pool_s8 : esp_nn_avg_pool_s8)
+                && channels % pool_impls[ix].channel_multiple == 0) {
+            return ix;
+        }
+    }
+    return 0;
+}
+
+#if EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+
+#ifndef EI_ESP_NN_AUTOTUNE_RUNS
+#define EI_ESP_NN_AUTOTUNE_RUNS     3
+#endif
+
+#ifndef EI_ESP_NN_AUTOTUNE_CACHE_SIZE
+#define EI_ESP_NN_AUTOTUNE_CACHE_SIZE 16
+#endif
+
+// bump when the candidate lists change, so stale NVS entries are ignored
+#define EI_ESP_NN_AUTOTUNE_VERSION  1
+
+#define EI_ESP_NN_NVS_NAMESPACE     "ei_esp_nn"
+
+typedef struct {
+    uint32_t key;
+    uint8_t impl;
+} autotune_entry_t;
+
+static autotune_entry_t autotune_cache[EI_ESP_NN_AUTOTUNE_CACHE_SIZE];
+static size_t autotune_cache_count = 0;
+
+static uint32_t shape_key(char op, const int32_t *values, size_t count)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    const int32_t header[] = { op, EI_ESP_NN_AUTOTUNE_VERSION };
+    for (size_t ix = 0; ix < 2 + count; ix++) {
+        uint32_t v = (uint32_t)(ix < 2 ? header[ix] : values[ix - 2]);
+        for (int b = 0; b < 4; b++) {
+            hash ^= (v >> (b * 8)) & 0xff;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+static void nvs_key(char op, uint32_t key, char *out)
+{
+    snprintf(out, 16, "%c%08x", op, (unsigned int)key);
+}
+
+static bool autotune_lookup(char op, uint32_t key, size_t candidates, size_t *impl)
+{
+    for (size_t ix = 0; ix < autotune_cache_count; ix++) {
+        if (autotune_cache[ix].key == key) {
+            *impl = autotune_cache[ix].impl;
+            return true;
+        }
+    }
+
+    nvs_handle_t handle;
+    if (nvs_open(EI_ESP_NN_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    char name[16];
+    nvs_key(op, key, name);
+    uint8_t value;
+    esp_err_t err = nvs_get_u8(handle, name, &value);
+    nvs_close(handle);
+    if (err != ESP_OK || value >= candidates) {
+        return false;
+    }
+
+    if (autotune_cache_count < EI_ESP_NN_AUTOTUNE_CACHE_SIZE) {
+        autotune_cache[autotune_cache_count].key = key;
+        autotune_cache[autotune_cache_count].impl = value;
+        autotune_cache_count++;
+    }
+    *impl = value;
+    return true;
+}
+
+static void autotune_store(char op, uint32_t key, size_t impl)
+{
+    if (autotune_cache_count < EI_ESP_NN_AUTOTUNE_CACHE_SIZE) {
+        autotune_cache[autotune_cache_count].key = key;
+        autotune_cache[autotune_cache_count].impl = (uint8_t)impl;
+        autotune_cache_count++;
+    }
+
+    // NVS not initialized (nvs_flash_init) or full: keep the RAM copy only
+    nvs_handle_t handle;
+    if (nvs_open(EI_ESP_NN_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return;
+    }
+    char name[16];
+    nvs_key(op, key, name);
+    if (nvs_set_u8(handle, name, (uint8_t)impl) == ESP_OK) {
+        nvs_commit(handle);
+    }
+    nvs_close(handle);
+}
+
+typedef struct {
+    void *raw;
+    void *ptr;
+} autotune_buffer_t;
+
+// 16-byte aligned, the S3 kernels use aligned loads
+static bool buffer_alloc(autotune_buffer_t *buf, size_t bytes)
+{
+    buf->raw = ei_malloc(bytes + 16);
+    if (!buf->raw) {
+        buf->ptr = NULL;
+        return false;
+    }
+    buf->ptr = (void *)(((uintptr_t)buf->raw + 15) & ~(uintptr_t)15);
+    return true;
+}
+
+static void buffer_free(autotune_buffer_t *buf)
+{
+    if (buf->raw) {
+        ei_free(buf->raw);
+    }
+    buf->raw = NULL;
+    buf->ptr = NULL;
+}
+
+static void fill_random(int8_t *data, size_t count, uint32_t seed)
+{
+    for (size_t ix = 0; ix < count; ix++) {
+        seed = seed * 1103515245u + 12345u;
+        data[ix] = (int8_t)(seed >> 16);
+    }
+}
+
+static void print_result(size_t ix, const char *name, uint64_t time_us, bool matches)
+{
+    if (matches) {
+        ei_printf("%s%s %llu us", ix == 0 ? "" : ", ", name, (unsigned long long)time_us);
+    }
+    else {
+        ei_printf("%s%s mismatch", ix == 0 ? "" : ", ", name);
+    }
+}
+
+static size_t tune_conv(const data_dims_t *input_dims, const data_dims_t *filter_dims,
+    const data_dims_t *output_dims, const conv_params_t *conv_params, size_t fallback)
+{
+    const size_t candidates = EI_ESP_NN_ARRAY_SIZE(conv_impls);
+    const size_t input_size = input_dims->width * input_dims->height * input_dims->channels;
+    const size_t filter_size = output_dims->channels * filter_dims->width * filter_dims->height *
+        input_dims->channels;
+    const size_t output_size = output_dims->width * output_dims->height * output_dims->channels;
+    const size_t out_channels = output_dims->channels;
+
+    autotune_buffer_t input = { 0 }, filter = { 0 }, bias = { 0 }, shift = { 0 }, mult = { 0 };
+    autotune_buffer_t output = { 0 }, expected = { 0 };
+    if (!buffer_alloc(&input, input_size) || !buffer_alloc(&filter, filter_size) ||
+            !buffer_alloc(&bias, out_channels * sizeof(int32_t)) ||
+            !buffer_alloc(&shift, out_channels * sizeof(int32_t)) ||
+            !buffer_alloc(&mult, out_channels * sizeof(int32_t)) ||
+            !buffer_alloc(&output, output_size) || !buffer_alloc(&expected, output_size)) {
+        ei_printf("ESP-NN autotune: out of memory, using %s for conv\n", conv_impls[fallback].name);
+        buffer_free(&input); buffer_free(&filter); buffer_free(&bias); buffer_free(&shift);
+        buffer_free(&mult); buffer_free(&output); buffer_free(&expected);
+        return fallback;
+    }
+
+    fill_random((int8_t *)input.ptr, input_size, 1);
+    fill_random((int8_t *)filter.ptr, filter_size, 2);
+    for (size_t ix = 0; ix < out_channels; ix++) {
+        ((int32_t *)bias.ptr)[ix] = (int32_t)(ix * 97) - 1000;
+        ((int32_t *)shift.ptr)[ix] = -8;
+        ((int32_t *)mult.ptr)[ix] = 0x40000000;
+    }
+
+    conv_params_t params = *conv_params;
+    params.in_offset = 128;
+    params.out_offset = -128;
+    params.activation.min = -128;
+    params.activation.max = 127;
+    quant_data_t quant_data = { (int32_t *)shift.ptr, (int32_t *)mult.ptr };
+
+    ei_printf("ESP-NN autotune conv %dx%dx%d -> %dx%dx%d, filter %dx%d: ",
+        (int)input_dims->width, (int)input_dims->height, (int)input_dims->channels,
+        (int)output_dims->width, (int)output_dims->height, (int)output_dims->channels,
+        (int)filter_dims->width, (int)filter_dims->height);
+
+    size_t best = fallback;
+    uint64_t best_time = UINT64_MAX;
+    for (size_t ix = 0; ix < candidates; ix++) {
+        const ei_esp_nn_conv_impl_t *impl = &conv_impls[ix];
+        autotune_buffer_t scratch = { 0 };
+        int scratch_size = impl->get_scratch_size(input_dims, filter_dims, output_dims, &params);
+        if (scratch_size > 0 && !buffer_alloc(&scratch, scratch_size)) {
+            ei_printf("%s%s no memory", ix == 0 ? "" : ", ", impl->name);
+            if (ix == 0) {
+                // without the reference output nothing can be checked, keep the default
+                break;
+            }
+            continue;
+        }
+        impl->set_scratch_buf(scratch.ptr);
+
+        int8_t *out = (int8_t *)(ix == 0 ? expected.ptr : output.ptr);
+        uint64_t time_us = UINT64_MAX;
+        for (int run = 0; run < EI_ESP_NN_AUTOTUNE_RUNS; run++) {
+            uint64_t start = ei_read_timer_us();
+            impl->conv(input_dims, (const int8_t *)input.ptr, filter_dims, (const int8_t *)filter.ptr,
+                (const int32_t *)bias.ptr, output_dims, out, &params, &quant_data);
+            uint64_t elapsed = ei_read_timer_us() - start;
+            if (elapsed < time_us) {
+                time_us = elapsed;
+            }
+        }
+        impl->set_scratch_buf(NULL);
+        buffer_free(&scratch);
+
+        // candidate 0 is the ansi reference
+        bool matches = ix == 0 || memcmp(output.ptr, expected.ptr, output_size) == 0;
+        print_result(ix, impl->name, time_us, matches);
+        // ties go to the compile-time default
+        if (matches && (time_us < best_time || (time_us == best_time && ix == fallback))) {
+            best = ix;
+            best_time = time_us;
+        }
+    }
+    ei_printf(" -> %s\n", conv_impls[best].name);
+
+    buffer_free(&input); buffer_free(&filter); buffer_free(&bias); buffer_free(&shift);
+    buffer_free(&mult); buffer_free(&output); buffer_free(&expected);
+    return best;
+}
+
+static size_t tune_fully_connected(uint16_t row_len, uint16_t out_channels, size_t fallback)
+{
+    const size_t candidates = EI_ESP_NN_ARRAY_SIZE(fully_connected_impls);
+    const size_t filter_size = (size_t)row_len * out_channels;
+
+    autotune_buffer_t input = { 0 }, filter = { 0 }, bias = { 0 }, output = { 0 }, expected = { 0 };
+    if (!buffer_alloc(&input, row_len) || !buffer_alloc(&filter, filter_size) ||
+            !buffer_alloc(&bias, out_channels * sizeof(int32_t)) ||
+            !buffer_alloc(&output, out_channels) || !buffer_alloc(&expected, out_channels)) {
+        ei_printf("ESP-NN autotune: out of memory, using %s for fully connected\n",
+            fully_connected_impls[fallback].name);
+        buffer_free(&input); buffer_free(&filter); buffer_free(&bias);
+        buffer_free(&output); buffer_free(&expected);
+        return fallback;
+    }
+
+    fill_random((int8_t *)input.ptr, row_len, 3);
+    fill_random((int8_t *)filter.ptr, filter_size, 4);
+    for (size_t ix = 0; ix < out_channels; ix++) {
+        ((int32_t *)bias.ptr)[ix] = (int32_t)(ix * 97) - 1000;
+    }
+
+    ei_printf("ESP-NN autotune fully connected %d -> %d: ", (int)row_len, (int)out_channels);
+
+    size_t best = fallback;
+    uint64_t best_time = UINT64_MAX;
+    for (size_t ix = 0; ix < candidates; ix++) {
+        const ei_esp_nn_fully_connected_impl_t *impl = &fully_connected_impls[ix];
+        int8_t *out = (int8_t *)(ix == 0 ? expected.ptr : output.ptr);
+        uint64_t time_us = UINT64_MAX;
+        for (int run = 0; run < EI_ESP_NN_AUTOTUNE_RUNS; run++) {
+            uint64_t start = ei_read_timer_us();
+            impl->fully_connected((const int8_t *)input.ptr, 128, row_len, (const int8_t *)filter.ptr, 0,
+                (const int32_t *)bias.ptr, out, out_channels, -128, -8, 0x40000000, -128, 127);
+            uint64_t elapsed = ei_read_timer_us() - start;
+            if (elapsed < time_us) {
+                time_us = elapsed;
+            }
+        }
+
+        bool matches = ix == 0 || memcmp(output.ptr, expected.ptr, out_channels) == 0;
+        print_result(ix, impl->name, time_us, matches);
+        // ties go to the compile-time default
+        if (matches && (time_us < best_time || (time_us == best_time && ix == fallback))) {
+            best = ix;
+            best_time = time_us;
+        }
+    }
+    ei_printf(" -> %s\n", fully_connected_impls[best].name);
+
+    buffer_free(&input); buffer_free(&filter); buffer_free(&bias);
+    buffer_free(&output); buffer_free(&expected);
+    return best;
+}
+
+static size_t tune_pool(bool is_max, const data_dims_t *input_dims, const data_dims_t *output_dims,
+    const data_2d_t *filter, const data_2d_t *stride, const data_2d_t *padding, size_t fallback)
+{
+    const size_t candidates = EI_ESP_NN_ARRAY_SIZE(pool_impls);
+    const size_t input_size = input_dims->width * input_dims->height * input_dims->channels;
+    const size_t output_size = output_dims->width * output_dims->height * output_dims->channels;
+
+    autotune_buffer_t input = { 0 }, output = { 0 }, expected = { 0 };
+    if (!buffer_alloc(&input, input_size) || !buffer_alloc(&output, output_size) ||
+            !buffer_alloc(&expected, output_size)) {
+        ei_printf("ESP-NN autotune: out of memory, using %s for pooling\n", pool_impls[fallback].name);
+        buffer_free(&input); buffer_free(&output); buffer_free(&expected);
+        return fallback;
+    }
+
+    fill_random((int8_t *)input.ptr, input_size, 5);
+
+    ei_printf("ESP-NN autotune %s pool %dx%dx%d -> %dx%dx%d: ", is_max ? "max" : "avg",
+        (int)input_dims->width, (int)input_dims->height, (int)input_dims->channels,
+        (int)output_dims->width, (int)output_dims->height, (int)output_dims->channels);
+
+    size_t best = fallback;
+    uint64_t best_time = UINT64_MAX;
+    for (size_t ix = 0; ix < candidates; ix++) {
+        const ei_esp_nn_pool_impl_t *impl = &pool_impls[ix];
+        if (input_dims->channels % impl->channel_multiple != 0) {
+            if (ix == 0) {
+                // without the reference output nothing can be checked, keep the default
+                break;
+            }
+            continue;
+        }
+        ei_esp_nn_pool_fn_t fn = is_max ? impl->max_pool : impl->avg_pool;
+        int8_t *out = (int8_t *)(ix == 0 ? expected.ptr : output.ptr);
+        uint64_t time_us = UINT64_MAX;
+        for (int run = 0; run < EI_ESP_NN_AUTOTUNE_RUNS; run++) {
+            uint64_t start = ei_read_timer_us();
+            fn((const int8_t *)input.ptr, input_dims->width, input_dims->height, out,
+                output_dims->width, output_dims->height, stride->width, stride->height,
+                filter->width, filter->height, padding->width, padding->height, -128, 127,
+                input_dims->channels);
+            uint64_t elapsed = ei_read_timer_us() - start;
+            if (elapsed < time_us) {
+                time_us = elapsed;
+            }
+        }
+
+        bool matches = ix == 0 || memcmp(output.ptr, expected.ptr, output_size) == 0;
+        print_result(ix, impl->name, time_us, matches);
+        // ties go to the compile-time default
+        if (matches && (time_us < best_time || (time_us == best_time && ix == fallback))) {
+            best = ix;
+            best_time = time_us;
+        }
+    }
+    ei_printf(" -> %s\n", pool_impls[best].name);
+
+    buffer_free(&input); buffer_free(&output); buffer_free(&expected);
+    return best;
+}
+
+#endif // EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+
+const ei_esp_nn_conv_impl_t *ei_esp_nn_select_conv(const data_dims_t *input_dims,
+                                                   const data_dims_t *filter_dims,
+                                                   const data_dims_t *output_dims,
+                                                   const conv_params_t *conv_params)
+{
+    size_t impl = default_conv_impl();
+
+#if EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+    const int32_t shape[] = {
+        input_dims->width, input_dims->height, input_dims->channels,
+        filter_dims->width, filter_dims->height,
+        output_dims->width, output_dims->height, output_dims->channels,
+        conv_params->stride.width, conv_params->stride.height,
+        conv_params->padding.width, conv_params->padding.height
+    };
+    const uint32_t key = shape_key('c', shape, EI_ESP_NN_ARRAY_SIZE(shape));
+    if (!autotune_lookup('c', key, EI_ESP_NN_ARRAY_SIZE(conv_impls), &impl)) {
+        impl = tune_conv(input_dims, filter_dims, output_dims, conv_params, impl);
+        autotune_store('c', key, impl);
+    }
+#endif
+
+    return &conv_impls[impl];
+}
+
+const ei_esp_nn_fully_connected_impl_t *ei_esp_nn_select_fully_connected(uint16_t row_len,
+                                                                         uint16_t out_channels)
+{
+    size_t impl = default_fully_connected_impl();
+
+#if EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+    if (EI_ESP_NN_ARRAY_SIZE(fully_connected_impls) > 1) {
+        const int32_t shape[] = { row_len, out_channels };
+        const uint32_t key = shape_key('f', shape, EI_ESP_NN_ARRAY_SIZE(shape));
+        if (!autotune_lookup('f', key, EI_ESP_NN_ARRAY_SIZE(fully_connected_impls), &impl)) {
+            impl = tune_fully_connected(row_len, out_channels, impl);
+            autotune_store('f', key, impl);
+        }
+    }
+#endif
+
+    return &fully_connected_impls[impl];
+}
+
+const ei_esp_nn_pool_impl_t *ei_esp_nn_select_pool(bool is_max,
+                                                   const data_dims_t *input_dims,
+                                                   const data_dims_t *output_dims,
+                                                   const data_2d_t *filter,
+                                                   const data_2d_t *stride,
+                                                   const data_2d_t *padding)
+{
+    size_t impl = default_pool_impl(is_max, input_dims->channels);
+
+#if EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+    if (EI_ESP_NN_ARRAY_SIZE(pool_impls) > 1) {
+        const char op = is_max ? 'm' : 'a';
+        const int32_t shape[] = {
+            input_dims->width, input_dims->height, input_dims->channels,
+            output_dims->width, output_dims->height,
+            filter->width, filter->height, stride->width, stride->height,
+            padding->width, padding->height
+        };
+        const uint32_t key = shape_key(op, shape, EI_ESP_NN_ARRAY_SIZE(shape));
+        if (!autotune_lookup(op, key, EI_ESP_NN_ARRAY_SIZE(pool_impls), &impl)) {
+            impl = tune_pool(is_max, input_dims, output_dims, filter, stride, padding, impl);
+            autotune_store(op, key, impl);
+        }
+    }
+#endif
+
+    return &pool_impls[impl];
+}
+
+void ei_esp_nn_autotune_reset(void)
+{
+#if EI_CLASSIFIER_ESP_NN_AUTOTUNE == 1
+    autotune_cache_count = 0;
+
+    nvs_handle_t handle;
+    if (nvs_open(EI_ESP_NN_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK) {
+        nvs_erase_all(handle);
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+#endif
+}
+
+#endif // EI_CLASSIFIER_TFLITE_ENABLE_ESP_NN
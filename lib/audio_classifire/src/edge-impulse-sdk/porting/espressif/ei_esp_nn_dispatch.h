@@ -0,0 +1,156 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _EI_ESP_NN_DISPATCH_H_
+#define _EI_ESP_NN_DISPATCH_H_
+
+#include <stdint.h>
+#include "edge-impulse-sdk/porting/espressif/ESP-NN/include/esp_nn.h"
+
+/**
+ * Runtime selection between the ESP-NN kernel variants built for this target.
+ *
+ * esp_nn.h picks one implementation per op at compile time (ansi, generic opt,
+ * or the S3 / P4 assembly). That choice is not always the fastest for a given
+ * layer shape. With EI_CLASSIFIER_ESP_NN_AUTOTUNE enabled, the first time a layer
+ * shape is seen every candidate is run on synthetic data of that shape, the
+ * fastest one whose output matches the ansi reference wins, and the winner is
+ * cached in RAM and in NVS (namespace "ei_esp_nn"), so later boots skip the
+ * benchmark. The timings are printed with ei_printf.
+ *
+ * Without EI_CLASSIFIER_ESP_NN_AUTOTUNE the select functions return the variant
+ * esp_nn.h would have picked.
+ *
+ * The kernels call the select functions from Prepare and keep the returned
+ * pointer in their node data, the returned structs are static.
+ */
+
+typedef void (*ei_esp_nn_conv_fn_t)(const data_dims_t *input_dims,
+                                    const int8_t *input_data,
+                                    const data_dims_t *filter_dims,
+                                    const int8_t *filter_data,
+                                    const int32_t *bias,
+                                    const data_dims_t *output_dims,
+                                    int8_t *out_data,
+                                    const conv_params_t *conv_params,
+                                    const quant_data_t *quant_data);
+
+typedef int (*ei_esp_nn_conv_scratch_size_fn_t)(const data_dims_t *input_dims,
+                                                const data_dims_t *filter_dims,
+                                                const data_dims_t *output_dims,
+                                                const conv_params_t *conv_params);
+
+typedef void (*ei_esp_nn_set_scratch_buf_fn_t)(const void *buf);
+
+typedef void (*ei_esp_nn_fully_connected_fn_t)(const int8_t *input_data,
+                                               const int32_t input_offset,
+                                               const uint16_t row_len,
+                                               const int8_t *filter_data,
+                                               const int32_t filter_offset,
+                                               const int32_t *bias,
+                                               int8_t *out_data,
+                                               const uint16_t out_channels,
+                                               const int32_t out_offset,
+                                               const int32_t out_shift,
+                                               const int32_t out_mult,
+                                               const int32_t activation_min,
+                                               const int32_t activation_max);
+
+typedef void (*ei_esp_nn_pool_fn_t)(const int8_t *input,
+                                    const uint16_t input_wd,
+                                    const uint16_t input_ht,
+                                    int8_t *output,
+                                    const uint16_t output_wd,
+                                    const uint16_t output_ht,
+                                    const uint16_t stride_wd,
+                                    const uint16_t stride_ht,
+                                    const uint16_t filter_wd,
+                                    const uint16_t filter_ht,
+                                    const uint16_t pad_wd,
+                                    const uint16_t pad_ht,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max,
+                                    const uint16_t channels);
+
+typedef struct {
+    const char *name;
+    ei_esp_nn_conv_fn_t conv;
+    ei_esp_nn_conv_scratch_size_fn_t get_scratch_size;
+    ei_esp_nn_set_scratch_buf_fn_t set_scratch_buf;
+} ei_esp_nn_conv_impl_t;
+
+typedef struct {
+    const char *name;
+    ei_esp_nn_fully_connected_fn_t fully_connected;
+} ei_esp_nn_fully_connected_impl_t;
+
+typedef struct {
+    const char *name;
+    ei_esp_nn_pool_fn_t max_pool;
+    ei_esp_nn_pool_fn_t avg_pool;
+    uint16_t channel_multiple; /**< only usable if channels % channel_multiple == 0 */
+} ei_esp_nn_pool_impl_t;
+
+/**
+ * Conv variant for this layer shape. Only the dims, stride and padding
+ * in the arguments are used.
+ */
+const ei_esp_nn_conv_impl_t *ei_esp_nn_select_conv(const data_dims_t *input_dims,
+                                                   const data_dims_t *filter_dims,
+                                                   const data_dims_t *output_dims,
+                                                   const conv_params_t *conv_params);
+
+/**
+ * Fully connected variant for this layer shape
+ */
+const ei_esp_nn_fully_connected_impl_t *ei_esp_nn_select_fully_connected(uint16_t row_len,
+                                                                         uint16_t out_channels);
+
+/**
+ * Pooling variant for this layer shape (max pool if is_max, else average pool)
+ */
+const ei_esp_nn_pool_impl_t *ei_esp_nn_select_pool(bool is_max,
+                                                   const data_dims_t *input_dims,
+                                                   const data_dims_t *output_dims,
+                                                   const data_2d_t *filter,
+                                                   const data_2d_t *stride,
+                                                   const data_2d_t *padding);
+
+/**
+ * Forget the tuned variants, in RAM and in NVS
+ */
+void ei_esp_nn_autotune_reset(void);
+
+#endif // _EI_ESP_NN_DISPATCH_H_
@@ -1703,6 +1703,7 @@ limitations under the License.
 
 #if ESP_NN
 #include "edge-impulse-sdk/porting/espressif/ESP-NN/include/esp_nn.h"
+#include "edge-impulse-sdk/porting/espressif/ei_esp_nn_dispatch.h"
 #endif
 
 
@@ -1715,12 +1716,20 @@ struct NodeData {
   OpDataConv op_data;
 #if ESP_NN
   int buffer_idx;
+  const ei_esp_nn_conv_impl_t* impl;
 #endif
 };
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+  void* data = context->AllocatePersistentBuffer(context, sizeof(NodeData));
+#if ESP_NN
+  // only int8 nodes pick a variant
+  if (data != nullptr) {
+    static_cast<NodeData*>(data)->impl = nullptr;
+  }
+#endif
+  return data;
 }
 
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
@@ -1803,7 +1812,9 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                   .dilation = {0, 0}, .activation = {-128, 127}
                                 };
 
-    int scratch_buf_size = esp_nn_get_conv_scratch_size(
+    data->impl = ei_esp_nn_select_conv(&input_dims, &filter_dims,
+                                       &output_dims, &conv_params);
+    int scratch_buf_size = data->impl->get_scratch_size(
         &input_dims, &filter_dims, &output_dims, &conv_params);
     if (scratch_buf_size > 0) {
       TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
@@ -1876,7 +1887,7 @@ inline void EvalQuantizedPerChannel(
     if (data.buffer_idx > -1) {
       scratch_buf = context->GetScratchBuffer(context, data.buffer_idx);
     }
-    esp_nn_set_conv_scratch_buf(scratch_buf);
+    data.impl->set_scratch_buf(scratch_buf);
 
     const int input_size = input_width * input_height * input_depth;
     const int output_size = output_width * output_height * output_depth;
@@ -1906,11 +1917,11 @@ inline void EvalQuantizedPerChannel(
                               };
 
     for (int i_batch = 0; i_batch < batch_size; i_batch++) {
-      esp_nn_conv_s8(&input_dims, input_data + i_batch * input_size,
-                     &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
-                     tflite::micro::GetTensorData<int32_t>(bias),
-                     &output_dims, output_data + i_batch * output_size,
-                     &conv_params, &quant_data);
+      data.impl->conv(&input_dims, input_data + i_batch * input_size,
+                      &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
+                      tflite::micro::GetTensorData<int32_t>(bias),
+                      &output_dims, output_data + i_batch * output_size,
+                      &conv_params, &quant_data);
     }
   } else {
     reference_integer_ops::ConvPerChannel(
@@ -2028,10 +2039,25 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+#if ESP_NN
+// Name of the ESP-NN variant the node dispatches to, for per-layer profiling
+const char* ProfilingString(const TfLiteContext* context,
+                            const TfLiteNode* node) {
+  const NodeData* data = static_cast<const NodeData*>(node->user_data);
+  return (data != nullptr && data->impl != nullptr) ? data->impl->name
+                                                    : nullptr;
+}
+#endif
+
 }  // namespace
 
 TfLiteRegistration Register_CONV_2D() {
-  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+  TfLiteRegistration registration =
+      tflite::micro::RegisterOp(Init, Prepare, Eval);
+#if ESP_NN
+  registration.profiling_string = ProfilingString;
+#endif
+  return registration;
 }
 
 }  // namespace tflite
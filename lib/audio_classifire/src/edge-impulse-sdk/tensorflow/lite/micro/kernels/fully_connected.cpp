@@ -1420,6 +1420,8 @@ limitations under the License.
 
 #if ESP_NN
 #include "edge-impulse-sdk/porting/espressif/ESP-NN/include/esp_nn.h"
+#include "edge-impulse-sdk/porting/espressif/ei_esp_nn_dispatch.h"
+#include "edge-impulse-sdk/porting/ei_parallel.h"
 #endif
 
 #include <esp_timer.h>
@@ -1429,10 +1431,56 @@ long long fc_total_time = 0;
 namespace tflite {
 namespace {
 
+struct NodeData {
+  OpDataFullyConnected op_data;
+#if ESP_NN
+  const ei_esp_nn_fully_connected_impl_t* impl;
+#endif
+};
+
+#if ESP_NN
+// Below this many multiply-accumulates per chunk the output rows are not split
+// across cores.
+constexpr int kParallelGrainMacs = 8192;
+
+struct FullyConnectedJob {
+  const ei_esp_nn_fully_connected_impl_t* impl;
+  const OpDataFullyConnected* data;
+  const int8_t* input_data;
+  const int8_t* filter_data;
+  const int32_t* bias_data;
+  int8_t* output_data;
+  int accum_depth;
+};
+
+// Output rows [start, end) of a single batch. Quantization is per-tensor, so
+// a row range is just an offset into the filter, bias and output.
+void FullyConnectedRows(void* ctx, int start, int end) {
+  const FullyConnectedJob& job = *static_cast<const FullyConnectedJob*>(ctx);
+  const OpDataFullyConnected& data = *job.data;
+  job.impl->fully_connected(job.input_data, -data.input_zero_point,
+                            job.accum_depth,
+                            job.filter_data + start * job.accum_depth,
+                            -data.filter_zero_point,
+                            job.bias_data ? job.bias_data + start : nullptr,
+                            job.output_data + start, end - start,
+                            data.output_zero_point,
+                            data.output_shift, data.output_multiplier,
+                            data.output_activation_min,
+                            data.output_activation_max);
+}
+#endif
+
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context,
-                                           sizeof(OpDataFullyConnected));
+  void* data = context->AllocatePersistentBuffer(context, sizeof(NodeData));
+#if ESP_NN
+  // only int8 nodes pick a variant
+  if (data != nullptr) {
+    static_cast<NodeData*>(data)->impl = nullptr;
+  }
+#endif
+  return data;
 }
 
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
@@ -1441,7 +1489,8 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TFLITE_DCHECK(node->user_data != nullptr);
   TFLITE_DCHECK(node->builtin_data != nullptr);
 
-  auto* data = static_cast<OpDataFullyConnected*>(node->user_data);
+  auto* node_data = static_cast<NodeData*>(node->user_data);
+  auto* data = &node_data->op_data;
   const auto params =
       static_cast<const TfLiteFullyConnectedParams*>(node->builtin_data);
 
@@ -1465,6 +1514,14 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                  context, params->activation, input->type,
                                  input, filter, bias, output, data));
 
+#if ESP_NN
+  if (input->type == kTfLiteInt8) {
+    node_data->impl = ei_esp_nn_select_fully_connected(
+        filter->dims->data[filter->dims->size - 1],
+        output->dims->data[output->dims->size - 1]);
+  }
+#endif
+
   micro_context->DeallocateTempTfLiteTensor(input);
   micro_context->DeallocateTempTfLiteTensor(filter);
   if (bias != nullptr) {
@@ -1489,8 +1546,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       tflite::micro::GetEvalOutput(context, node, kFullyConnectedOutputTensor);
 
   TFLITE_DCHECK(node->user_data != nullptr);
-  const auto& data =
-      *(static_cast<const OpDataFullyConnected*>(node->user_data));
+  const auto& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const auto& data = node_data.op_data;
 
   long long start_time = esp_timer_get_time();
   // Checks in Prepare ensure input, output and filter types are all the same.
@@ -1537,14 +1594,13 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       const int8_t *filter_data = tflite::micro::GetTensorData<int8_t>(filter);
 
       for (int b = 0; b < batches; ++b) {
-        esp_nn_fully_connected_s8(input_data, -data.input_zero_point,
-                                  accum_depth,
-                                  filter_data, -data.filter_zero_point,
-                                  bias_data, output_data, output_depth,
-                                  data.output_zero_point,
-                                  data.output_shift, data.output_multiplier,
-                                  data.output_activation_min,
-                                  data.output_activation_max);
+        FullyConnectedJob job = {node_data.impl, &data,
+                                 input_data,     filter_data,
+                                 bias_data,      output_data,
+                                 accum_depth};
+        ei_parallel_for(output_depth,
+                        (kParallelGrainMacs + accum_depth - 1) / accum_depth,
+                        FullyConnectedRows, &job);
         input_data += accum_depth;
         output_data += output_depth;
       }
@@ -1590,10 +1646,25 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+#if ESP_NN
+// Name of the ESP-NN variant the node dispatches to, for per-layer profiling
+const char* ProfilingString(const TfLiteContext* context,
+                            const TfLiteNode* node) {
+  const NodeData* data = static_cast<const NodeData*>(node->user_data);
+  return (data != nullptr && data->impl != nullptr) ? data->impl->name
+                                                    : nullptr;
+}
+#endif
+
 }  // namespace
 
 TfLiteRegistration Register_FULLY_CONNECTED() {
-  return tflite::micro::RegisterOp(Init, Prepare, Eval);
+  TfLiteRegistration registration =
+      tflite::micro::RegisterOp(Init, Prepare, Eval);
+#if ESP_NN
+  registration.profiling_string = ProfilingString;
+#endif
+  return registration;
 }
 
 }  // namespace tflite
@@ -68,6 +68,17 @@ TfLiteStatus CalculateOpDataFullyConnected(
     TfLiteType data_type, const TfLiteTensor* input, const TfLiteTensor* filter,
     const TfLiteTensor* bias, TfLiteTensor* output, OpDataFullyConnected* data);
 
+// Int8 fully connected over a batch of inputs, input [batches, accum_depth],
+// filter [output_depth, accum_depth], output [batches, output_depth]. Each
+// filter row is read once for the whole batch (the reference kernel reads the
+// whole filter once per input), which matters when the filter does not fit in
+// cache. Bit exact with reference_integer_ops::FullyConnected.
+void FullyConnectedInt8Batched(const OpDataFullyConnected& data, int batches,
+                               int accum_depth, int output_depth,
+                               const int8_t* input_data,
+                               const int8_t* filter_data,
+                               const int32_t* bias_data, int8_t* output_data);
+
 // This is the most generic TfLiteRegistration. The actual supported types may
 // still be target dependent. The only requirement is that every implementation
 // (reference or optimized) must define this function.
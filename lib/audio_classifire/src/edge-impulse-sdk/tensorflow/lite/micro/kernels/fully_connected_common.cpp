@@ -23,6 +23,7 @@ limitations under the License.
 #include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/kernels/fully_connected.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/porting/ei_parallel.h"
 
 namespace tflite {
 
@@ -81,4 +82,75 @@ TfLiteStatus CalculateOpDataFullyConnected(
   return kTfLiteOk;
 }
 
+namespace {
+
+struct BatchedJob {
+  const OpDataFullyConnected* data;
+  int batches;
+  int accum_depth;
+  int output_depth;
+  const int8_t* input_data;
+  const int8_t* filter_data;
+  const int32_t* bias_data;
+  int8_t* output_data;
+};
+
+// Output rows [start, end) for every input of the batch. The filter row stays
+// in cache while it is applied to all inputs.
+void BatchedRows(void* ctx, int start, int end) {
+  const BatchedJob& job = *static_cast<const BatchedJob*>(ctx);
+  const OpDataFullyConnected& data = *job.data;
+  const int32_t input_offset = -data.input_zero_point;
+  const int32_t filter_offset = -data.filter_zero_point;
+
+  for (int out_c = start; out_c < end; ++out_c) {
+    const int8_t* f = job.filter_data + out_c * job.accum_depth;
+
+    // with a symmetric filter the input offset folds into the bias:
+    // sum(f * (x + input_offset)) = sum(f * x) + input_offset * sum(f)
+    int32_t filter_sum = 0;
+    for (int d = 0; d < job.accum_depth; ++d) {
+      filter_sum += f[d];
+    }
+    const int32_t bias = job.bias_data ? job.bias_data[out_c] : 0;
+
+    for (int b = 0; b < job.batches; ++b) {
+      const int8_t* x = job.input_data + b * job.accum_depth;
+      int32_t acc = 0;
+      if (filter_offset == 0) {
+        for (int d = 0; d < job.accum_depth; ++d) {
+          acc += f[d] * x[d];
+        }
+        acc += input_offset * filter_sum;
+      } else {
+        for (int d = 0; d < job.accum_depth; ++d) {
+          acc += (f[d] + filter_offset) * (x[d] + input_offset);
+        }
+      }
+      acc += bias;
+      acc = MultiplyByQuantizedMultiplier(acc, data.output_multiplier,
+                                          data.output_shift);
+      acc += data.output_zero_point;
+      acc = std::max(acc, data.output_activation_min);
+      acc = std::min(acc, data.output_activation_max);
+      job.output_data[b * job.output_depth + out_c] = static_cast<int8_t>(acc);
+    }
+  }
+}
+
+}  // namespace
+
+void FullyConnectedInt8Batched(const OpDataFullyConnected& data, int batches,
+                               int accum_depth, int output_depth,
+                               const int8_t* input_data,
+                               const int8_t* filter_data,
+                               const int32_t* bias_data, int8_t* output_data) {
+  BatchedJob job = {&data,      batches,     accum_depth, output_depth,
+                    input_data, filter_data, bias_data,   output_data};
+  // same grain as the specialized kernel, in multiply-accumulates per chunk
+  const int macs_per_row = accum_depth * batches;
+  ei_parallel_for(output_depth, (8192 + macs_per_row - 1) / macs_per_row,
+                  BatchedRows, &job);
+}
+
 }  // namespace tflite
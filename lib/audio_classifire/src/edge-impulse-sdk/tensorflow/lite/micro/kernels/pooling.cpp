@@ -1204,6 +1204,7 @@ limitations under the License.
 
 #if ESP_NN
 #include "edge-impulse-sdk/porting/espressif/ESP-NN/include/esp_nn.h"
+#include "edge-impulse-sdk/porting/espressif/ei_esp_nn_dispatch.h"
 #endif
 
 #include <esp_timer.h>
@@ -1213,11 +1214,68 @@ long long pooling_total_time = 0;
 namespace tflite {
 
 namespace {
+
+// op_data must stay the first member, PoolingPrepare treats user_data as
+// OpDataPooling.
+struct NodeData {
+  OpDataPooling op_data;
 #if ESP_NN
+  const ei_esp_nn_pool_impl_t* impl;
+#endif
+};
+
+#if ESP_NN
+TfLiteStatus PrepareQuantized(TfLiteContext* context, TfLiteNode* node,
+                              bool is_max) {
+  TF_LITE_ENSURE_STATUS(PoolingPrepare(context, node));
+
+  NodeData* node_data = static_cast<NodeData*>(node->user_data);
+  const auto* params =
+      reinterpret_cast<const TfLitePoolParams*>(node->builtin_data);
+
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kPoolingInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TfLiteTensor* output =
+      micro_context->AllocateTempOutputTensor(node, kPoolingOutputTensor);
+  TF_LITE_ENSURE(context, output != nullptr);
+
+  if (input->type == kTfLiteInt8) {
+    data_dims_t input_dims = {
+                               .width = input->dims->data[2], .height = input->dims->data[1],
+                               .channels = input->dims->data[3], .extra = 1
+                             };
+    data_dims_t output_dims = {
+                                .width = output->dims->data[2], .height = output->dims->data[1],
+                                .channels = output->dims->data[3], .extra = 1
+                              };
+    data_2d_t filter = { params->filter_width, params->filter_height };
+    data_2d_t stride = { params->stride_width, params->stride_height };
+    data_2d_t padding = { node_data->op_data.padding.width,
+                          node_data->op_data.padding.height };
+    node_data->impl = ei_esp_nn_select_pool(is_max, &input_dims, &output_dims,
+                                            &filter, &stride, &padding);
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+TfLiteStatus AveragePrepare(TfLiteContext* context, TfLiteNode* node) {
+  return PrepareQuantized(context, node, false);
+}
+
+TfLiteStatus MaxPrepare(TfLiteContext* context, TfLiteNode* node) {
+  return PrepareQuantized(context, node, true);
+}
+
 void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
-                          const TfLitePoolParams* params, const OpDataPooling* data,
+                          const TfLitePoolParams* params, const NodeData* node_data,
                           const TfLiteEvalTensor* input,
                           TfLiteEvalTensor* output) {
+  const OpDataPooling* data = &node_data->op_data;
 
   const int stride_height = params->stride_height;
   const int stride_width = params->stride_width;
@@ -1246,34 +1304,23 @@ void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
   const int input_size = input_width * input_height * depth;
   const int output_size = output_width * output_height * depth;
 
-  if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_avg_pool_s8(input_data, input_width, input_height,
-                         output_data, output_width, output_height,
-                         stride_width, stride_height,
-                         filter_width, filter_height,
-                         pad_width, pad_height,
-                         activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
-  } else {
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_avg_pool_s8_ansi(input_data, input_width, input_height,
+  // the dispatcher only picks variants that support this channel count
+  for (int batch = 0; batch < batches; ++batch) {
+    node_data->impl->avg_pool(input_data, input_width, input_height,
                               output_data, output_width, output_height,
                               stride_width, stride_height,
                               filter_width, filter_height,
                               pad_width, pad_height,
                               activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
+    input_data += input_size;
+    output_data += output_size;
   }
 }
 
 void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
-                      TfLitePoolParams* params, const OpDataPooling* data,
+                      TfLitePoolParams* params, const NodeData* node_data,
                       const TfLiteEvalTensor* input, TfLiteEvalTensor* output) {
+  const OpDataPooling* data = &node_data->op_data;
 
   const int stride_height = params->stride_height;
   const int stride_width = params->stride_width;
@@ -1301,28 +1348,16 @@ void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
 
   const int input_size = input_width * input_height * depth;
   const int output_size = output_width * output_height * depth;
-  if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_max_pool_s8(input_data, input_width, input_height,
-                         output_data, output_width, output_height,
-                         stride_width, stride_height,
-                         filter_width, filter_height,
-                         pad_width, pad_height,
-                         activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
-  } else {
-    for (int batch = 0; batch < batches; ++batch) {
-      esp_nn_max_pool_s8_ansi(input_data, input_width, input_height,
+  // the dispatcher only picks variants that support this channel count
+  for (int batch = 0; batch < batches; ++batch) {
+    node_data->impl->max_pool(input_data, input_width, input_height,
                               output_data, output_width, output_height,
                               stride_width, stride_height,
                               filter_width, filter_height,
                               pad_width, pad_height,
                               activation_min, activation_max, depth);
-      input_data += input_size;
-      output_data += output_size;
-    }
+    input_data += input_size;
+    output_data += output_size;
   }
 }
 #endif
@@ -1332,8 +1367,8 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
   auto* params = reinterpret_cast<TfLitePoolParams*>(node->builtin_data);
 
   TFLITE_DCHECK(node->user_data != nullptr);
-  const OpDataPooling* data =
-      static_cast<const OpDataPooling*>(node->user_data);
+  const NodeData* node_data = static_cast<const NodeData*>(node->user_data);
+  const OpDataPooling* data = &node_data->op_data;
 
   const TfLiteEvalTensor* input =
       micro::GetEvalInput(context, node, kPoolingInputTensor);
@@ -1358,7 +1393,7 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
       return kTfLiteError;
 #endif
 #if ESP_NN
-      AverageEvalQuantized(context, node, params, data, input, output);
+      AverageEvalQuantized(context, node, params, node_data, input, output);
 #else
       AveragePoolingEvalQuantized<int8_t>(context, node, params, data, input, output);
 #endif
@@ -1377,8 +1412,8 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
   auto* params = reinterpret_cast<TfLitePoolParams*>(node->builtin_data);
 
   TFLITE_DCHECK(node->user_data != nullptr);
-  const OpDataPooling* data =
-      static_cast<const OpDataPooling*>(node->user_data);
+  const NodeData* node_data = static_cast<const NodeData*>(node->user_data);
+  const OpDataPooling* data = &node_data->op_data;
 
   const TfLiteEvalTensor* input =
       micro::GetEvalInput(context, node, kPoolingInputTensor);
@@ -1402,7 +1437,7 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
       return kTfLiteError;
 #endif
 #if ESP_NN
-      MaxEvalQuantized(context, node, params, data, input, output);
+      MaxEvalQuantized(context, node, params, node_data, input, output);
 #else
       MaxPoolingEvalQuantized<int8_t>(context, node, params, data, input, output);
 #endif
@@ -1418,11 +1453,43 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
 
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
-  return context->AllocatePersistentBuffer(context, sizeof(OpDataPooling));
+  void* data = context->AllocatePersistentBuffer(context, sizeof(NodeData));
+#if ESP_NN
+  // only int8 nodes pick a variant
+  if (data != nullptr) {
+    static_cast<NodeData*>(data)->impl = nullptr;
+  }
+#endif
+  return data;
 }
 
+#if ESP_NN
+// Name of the ESP-NN variant the node dispatches to, for per-layer profiling
+const char* ProfilingString(const TfLiteContext* context,
+                            const TfLiteNode* node) {
+  const NodeData* data = static_cast<const NodeData*>(node->user_data);
+  return (data != nullptr && data->impl != nullptr) ? data->impl->name
+                                                    : nullptr;
+}
+#endif
+
 }  // namespace
 
+#if ESP_NN
+TfLiteRegistration Register_AVERAGE_POOL_2D() {
+  TfLiteRegistration registration =
+      tflite::micro::RegisterOp(Init, AveragePrepare, AverageEval);
+  registration.profiling_string = ProfilingString;
+  return registration;
+}
+
+TfLiteRegistration Register_MAX_POOL_2D() {
+  TfLiteRegistration registration =
+      tflite::micro::RegisterOp(Init, MaxPrepare, MaxEval);
+  registration.profiling_string = ProfilingString;
+  return registration;
+}
+#else
 TfLiteRegistration Register_AVERAGE_POOL_2D() {
   return tflite::micro::RegisterOp(Init, PoolingPrepare, AverageEval);
 }
@@ -1430,6 +1497,7 @@ TfLiteRegistration Register_AVERAGE_POOL_2D() {
 TfLiteRegistration Register_MAX_POOL_2D() {
   return tflite::micro::RegisterOp(Init, PoolingPrepare, MaxEval);
 }
+#endif
 
 }  // namespace tflite
 
@@ -0,0 +1,372 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_SPECIALIZED_KERNELS_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_SPECIALIZED_KERNELS_H_
+
+// Shape-specialized int8 kernels for compiled (EON) models.
+//
+// The generic kernels read every dimension from the tensors at runtime, which
+// keeps the inner loops opaque to the compiler. When the model is compiled
+// ahead of time the shapes of each node are known, so the EON compiler can
+// instantiate these templates with the channel counts, filter width and
+// stride of a layer and the inner loops become fixed-trip-count loops that
+// are fully unrolled.
+//
+// Only the 1xN convolutions (height 1, no dilation) and the fully connected
+// layers produced by the audio models are specialized. If a node does not
+// match the template parameters at Eval time the kernel falls back to the
+// reference implementation, so a mismatched instantiation is slow but never
+// wrong. The arithmetic (accumulation, requantization and clamping) is the
+// same as the reference kernels, so the output is bit exact with them.
+//
+// The output columns (conv) and rows (fully connected) are independent, so
+// both kernels hand them to ei_parallel_for, which splits them across cores
+// when EI_CLASSIFIER_TFLITE_PARALLEL_WORKERS is set.
+
+#include <algorithm>
+#include <cstdint>
+
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/porting/ei_parallel.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
+#include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/common.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "edge-impulse-sdk/tensorflow/lite/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/conv.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/fully_connected.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_util.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+namespace specialized {
+
+// Layers with fewer multiply-accumulates per chunk than this are not split,
+// the thread handoff would cost more than it saves.
+constexpr int kParallelGrainMacs = 8192;
+
+inline int32_t Requantize(int32_t acc, int32_t multiplier, int shift,
+                          int32_t output_offset, int32_t activation_min,
+                          int32_t activation_max) {
+  acc = MultiplyByQuantizedMultiplier(acc, multiplier, shift);
+  acc += output_offset;
+  acc = std::max(acc, activation_min);
+  acc = std::min(acc, activation_max);
+  return acc;
+}
+
+// Conv 2D, int8 in/out, per-channel quantized, input [1, 1, W, kInputDepth],
+// filter [kOutputDepth, 1, kFilterWidth, kInputDepth].
+template <int kInputDepth, int kOutputDepth, int kFilterWidth, int kStride>
+struct Conv1xN {
+  static void* Init(TfLiteContext* context, const char* buffer,
+                    size_t length) {
+    TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+    return context->AllocatePersistentBuffer(context, sizeof(OpDataConv));
+  }
+
+  static TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+    MicroContext* micro_context = GetMicroContext(context);
+    TfLiteTensor* input =
+        micro_context->AllocateTempInputTensor(node, kConvInputTensor);
+    TF_LITE_ENSURE(context, input != nullptr);
+    TF_LITE_ENSURE_TYPES_EQ(context, input->type, kTfLiteInt8);
+    micro_context->DeallocateTempTfLiteTensor(input);
+
+    return ConvPrepare(context, node);
+  }
+
+  // One output pixel, all output channels. kCheckBounds is false for the
+  // interior of the row, where every filter tap lands inside the input.
+  template <bool kCheckBounds>
+  static inline void Pixel(const OpDataConv& data, const int8_t* input_data,
+                           int input_width, int in_x_origin,
+                           const int8_t* filter_data,
+                           const int32_t* bias_data, int8_t* output_data) {
+    const int32_t input_offset = -data.input_zero_point;
+    for (int out_channel = 0; out_channel < kOutputDepth; ++out_channel) {
+      const int8_t* filter_row =
+          filter_data + out_channel * kFilterWidth * kInputDepth;
+      int32_t acc = 0;
+      for (int filter_x = 0; filter_x < kFilterWidth; ++filter_x) {
+        const int in_x = in_x_origin + filter_x;
+        if (kCheckBounds && (in_x < 0 || in_x >= input_width)) {
+          continue;
+        }
+        const int8_t* in = input_data + in_x * kInputDepth;
+        const int8_t* f = filter_row + filter_x * kInputDepth;
+        for (int in_channel = 0; in_channel < kInputDepth; ++in_channel) {
+          acc += f[in_channel] * (in[in_channel] + input_offset);
+        }
+      }
+      if (bias_data) {
+        acc += bias_data[out_channel];
+      }
+      output_data[out_channel] = static_cast<int8_t>(Requantize(
+          acc, data.per_channel_output_multiplier[out_channel],
+          data.per_channel_output_shift[out_channel], data.output_zero_point,
+          data.output_activation_min, data.output_activation_max));
+    }
+  }
+
+  struct Job {
+    const OpDataConv* data;
+    const int8_t* input_data;
+    const int8_t* filter_data;
+    const int32_t* bias_data;
+    int8_t* output_data;
+    int input_width;
+  };
+
+  // Output columns [start, end).
+  static void Columns(void* ctx, int start, int end) {
+    const Job& job = *static_cast<const Job*>(ctx);
+    const int pad_width = job.data->padding.width;
+    for (int out_x = start; out_x < end; ++out_x) {
+      const int in_x_origin = out_x * kStride - pad_width;
+      int8_t* out = job.output_data + out_x * kOutputDepth;
+      if (in_x_origin >= 0 && in_x_origin + kFilterWidth <= job.input_width) {
+        Pixel<false>(*job.data, job.input_data, job.input_width, in_x_origin,
+                     job.filter_data, job.bias_data, out);
+      } else {
+        Pixel<true>(*job.data, job.input_data, job.input_width, in_x_origin,
+                    job.filter_data, job.bias_data, out);
+      }
+    }
+  }
+
+  static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteEvalTensor* input =
+        tflite::micro::GetEvalInput(context, node, kConvInputTensor);
+    const TfLiteEvalTensor* filter =
+        tflite::micro::GetEvalInput(context, node, kConvWeightsTensor);
+    const TfLiteEvalTensor* bias =
+        (NumInputs(node) == 3)
+            ? tflite::micro::GetEvalInput(context, node, kConvBiasTensor)
+            : nullptr;
+    TfLiteEvalTensor* output =
+        tflite::micro::GetEvalOutput(context, node, kConvOutputTensor);
+
+    TFLITE_DCHECK(node->builtin_data != nullptr);
+    const auto& params =
+        *(reinterpret_cast<TfLiteConvParams*>(node->builtin_data));
+    TFLITE_DCHECK(node->user_data != nullptr);
+    const auto& data = *(static_cast<const OpDataConv*>(node->user_data));
+
+    const RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
+    const RuntimeShape filter_shape = tflite::micro::GetTensorShape(filter);
+    const RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
+    const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+    const int8_t* filter_data = tflite::micro::GetTensorData<int8_t>(filter);
+    const int32_t* bias_data =
+        tflite::micro::GetOptionalTensorData<int32_t>(bias);
+    int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
+
+    const bool matches =
+        filter->type == kTfLiteInt8 && input_shape.Dims(0) == 1 &&
+        input_shape.Dims(1) == 1 && input_shape.Dims(3) == kInputDepth &&
+        filter_shape.Dims(0) == kOutputDepth && filter_shape.Dims(1) == 1 &&
+        filter_shape.Dims(2) == kFilterWidth &&
+        filter_shape.Dims(3) == kInputDepth && output_shape.Dims(1) == 1 &&
+        params.stride_width == kStride && params.dilation_width_factor == 1 &&
+        params.dilation_height_factor == 1 && data.padding.height == 0;
+
+    if (!matches) {
+      reference_integer_ops::ConvPerChannel(
+          ConvParamsQuantized(params, data),
+          data.per_channel_output_multiplier, data.per_channel_output_shift,
+          input_shape, input_data, filter_shape, filter_data,
+          tflite::micro::GetTensorShape(bias), bias_data, output_shape,
+          output_data);
+      return kTfLiteOk;
+    }
+
+    Job job = {&data,     input_data,  filter_data,
+               bias_data, output_data, input_shape.Dims(2)};
+    constexpr int kColumnMacs = kOutputDepth * kFilterWidth * kInputDepth;
+    ei_parallel_for(output_shape.Dims(2),
+                    (kParallelGrainMacs + kColumnMacs - 1) / kColumnMacs,
+                    Columns, &job);
+    return kTfLiteOk;
+  }
+};
+
+// Fully connected, int8 in/out, input [1, kAccumDepth],
+// filter [kOutputDepth, kAccumDepth].
+template <int kAccumDepth, int kOutputDepth>
+struct FullyConnectedFixed {
+  struct OpData {
+    OpDataFullyConnected fc;
+    // bias + input_offset * sum(filter row); folds the input zero point out
+    // of the inner loop. Only valid when the filter is symmetric.
+    int32_t* folded_bias;
+  };
+
+  static void* Init(TfLiteContext* context, const char* buffer,
+                    size_t length) {
+    TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+    return context->AllocatePersistentBuffer(context, sizeof(OpData));
+  }
+
+  static TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
+    MicroContext* micro_context = GetMicroContext(context);
+
+    TFLITE_DCHECK(node->user_data != nullptr);
+    TFLITE_DCHECK(node->builtin_data != nullptr);
+
+    auto* data = static_cast<OpData*>(node->user_data);
+    const auto params =
+        static_cast<const TfLiteFullyConnectedParams*>(node->builtin_data);
+
+    TfLiteTensor* input = micro_context->AllocateTempInputTensor(
+        node, kFullyConnectedInputTensor);
+    TF_LITE_ENSURE(context, input != nullptr);
+    TfLiteTensor* filter = micro_context->AllocateTempInputTensor(
+        node, kFullyConnectedWeightsTensor);
+    TF_LITE_ENSURE(context, filter != nullptr);
+    TfLiteTensor* bias = micro_context->AllocateTempInputTensor(
+        node, kFullyConnectedBiasTensor);
+    TfLiteTensor* output = micro_context->AllocateTempOutputTensor(
+        node, kFullyConnectedOutputTensor);
+    TF_LITE_ENSURE(context, output != nullptr);
+    TF_LITE_ENSURE_TYPES_EQ(context, input->type, kTfLiteInt8);
+    TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteInt8);
+
+    TF_LITE_ENSURE_OK(context, CalculateOpDataFullyConnected(
+                                   context, params->activation, input->type,
+                                   input, filter, bias, output, &data->fc));
+
+    data->folded_bias = nullptr;
+    const RuntimeShape filter_shape = GetTensorShape(filter);
+    if (filter->type == kTfLiteInt8 && data->fc.filter_zero_point == 0 &&
+        filter->data.int8 != nullptr &&
+        filter_shape.DimensionsCount() == 2 &&
+        filter_shape.Dims(0) == kOutputDepth &&
+        filter_shape.Dims(1) == kAccumDepth) {
+      data->folded_bias =
+          static_cast<int32_t*>(context->AllocatePersistentBuffer(
+              context, kOutputDepth * sizeof(int32_t)));
+      TF_LITE_ENSURE(context, data->folded_bias != nullptr);
+
+      const int32_t input_offset = -data->fc.input_zero_point;
+      const int32_t* bias_data = bias != nullptr ? bias->data.i32 : nullptr;
+      for (int out_c = 0; out_c < kOutputDepth; ++out_c) {
+        const int8_t* f = filter->data.int8 + out_c * kAccumDepth;
+        int32_t sum = 0;
+        for (int d = 0; d < kAccumDepth; ++d) {
+          sum += f[d];
+        }
+        data->folded_bias[out_c] =
+            (bias_data ? bias_data[out_c] : 0) + sum * input_offset;
+      }
+    }
+
+    micro_context->DeallocateTempTfLiteTensor(input);
+    micro_context->DeallocateTempTfLiteTensor(filter);
+    if (bias != nullptr) {
+      micro_context->DeallocateTempTfLiteTensor(bias);
+    }
+    micro_context->DeallocateTempTfLiteTensor(output);
+    return kTfLiteOk;
+  }
+
+  struct Job {
+    const OpData* data;
+    const int8_t* input_data;
+    const int8_t* filter_data;
+    int8_t* output_data;
+  };
+
+  // Output rows [start, end).
+  static void Rows(void* ctx, int start, int end) {
+    const Job& job = *static_cast<const Job*>(ctx);
+    const OpDataFullyConnected& fc = job.data->fc;
+    for (int out_c = start; out_c < end; ++out_c) {
+      const int8_t* f = job.filter_data + out_c * kAccumDepth;
+      int32_t acc = job.data->folded_bias[out_c];
+      for (int d = 0; d < kAccumDepth; ++d) {
+        acc += f[d] * job.input_data[d];
+      }
+      job.output_data[out_c] = static_cast<int8_t>(Requantize(
+          acc, fc.output_multiplier, fc.output_shift, fc.output_zero_point,
+          fc.output_activation_min, fc.output_activation_max));
+    }
+  }
+
+  static TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteEvalTensor* input = tflite::micro::GetEvalInput(
+        context, node, kFullyConnectedInputTensor);
+    const TfLiteEvalTensor* filter = tflite::micro::GetEvalInput(
+        context, node, kFullyConnectedWeightsTensor);
+    const TfLiteEvalTensor* bias = tflite::micro::GetEvalInput(
+        context, node, kFullyConnectedBiasTensor);
+    TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(
+        context, node, kFullyConnectedOutputTensor);
+
+    TFLITE_DCHECK(node->user_data != nullptr);
+    const auto& data = *(static_cast<const OpData*>(node->user_data));
+
+    const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+    const int8_t* filter_data = tflite::micro::GetTensorData<int8_t>(filter);
+    int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
+    const RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
+
+    if (data.folded_bias == nullptr ||
+        FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1) !=
+            1) {
+      tflite::reference_integer_ops::FullyConnected(
+          FullyConnectedParamsQuantized(data.fc),
+          tflite::micro::GetTensorShape(input), input_data,
+          tflite::micro::GetTensorShape(filter), filter_data,
+          tflite::micro::GetTensorShape(bias),
+          tflite::micro::GetOptionalTensorData<int32_t>(bias), output_shape,
+          output_data);
+      return kTfLiteOk;
+    }
+
+    Job job = {&data, input_data, filter_data, output_data};
+    ei_parallel_for(kOutputDepth,
+                    (kParallelGrainMacs + kAccumDepth - 1) / kAccumDepth, Rows,
+                    &job);
+    return kTfLiteOk;
+  }
+};
+
+}  // namespace specialized
+
+// Returns a TfLiteRegistration for an int8 1xN convolution with the given
+// depths, filter width and stride. See the notes at the top of this file.
+template <int kInputDepth, int kOutputDepth, int kFilterWidth, int kStride>
+TfLiteRegistration Register_CONV_2D_SPECIALIZED() {
+  using Kernel = specialized::Conv1xN<kInputDepth, kOutputDepth, kFilterWidth,
+                                      kStride>;
+  return tflite::micro::RegisterOp(Kernel::Init, Kernel::Prepare,
+                                   Kernel::Eval);
+}
+
+// Returns a TfLiteRegistration for an int8 fully connected layer with the
+// given input and output depths.
+template <int kAccumDepth, int kOutputDepth>
+TfLiteRegistration Register_FULLY_CONNECTED_SPECIALIZED() {
+  using Kernel = specialized::FullyConnectedFixed<kAccumDepth, kOutputDepth>;
+  return tflite::micro::RegisterOp(Kernel::Init, Kernel::Prepare,
+                                   Kernel::Eval);
+}
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_SPECIALIZED_KERNELS_H_
@@ -140,6 +140,9 @@
 #define EI_CLASSIFIER_FUSION_AXES_STRING         "audio"
 #define EI_CLASSIFIER_CALIBRATION_ENABLED        0
 #define EI_CLASSIFIER_OBJECT_TRACKING_ENABLED    0
+#ifndef EI_CLASSIFIER_SMOOTHING_ENABLED
+#define EI_CLASSIFIER_SMOOTHING_ENABLED          1
+#endif // EI_CLASSIFIER_SMOOTHING_ENABLED
 
 #ifndef EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW
 #define EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW    4
@@ -313,9 +316,23 @@ typedef struct {
     float hrv_win_size_s;
 } ei_dsp_config_hr_t;
 
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+typedef struct {
+    float value[EI_CLASSIFIER_LABEL_COUNT];
+    int32_t event_label;
+    float event_value;
+    uint64_t event_timestamp_ms;
+    int32_t active_label;
+} ei_smoothing_output_t;
+
+typedef struct {
+    ei_smoothing_output_t smoothing_output;
+} ei_post_processing_output_t;
+#else
 typedef struct {
     int:0;
 } ei_post_processing_output_t;
+#endif // EI_CLASSIFIER_SMOOTHING_ENABLED
 
 
 #endif // _EI_CLASSIFIER_MODEL_METADATA_H_
@@ -46,6 +46,12 @@
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/engines.h"
 #include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+#include "edge-impulse-sdk/classifier/postprocessing/ei_posterior_smoothing.h"
+#endif
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+#include "edge-impulse-sdk/classifier/ei_memory_plan.h"
+#endif
 
 const char* ei_classifier_inferencing_categories[] = { "1", "2", "3", "4", "5" };
 
@@ -91,8 +97,47 @@ const ei_config_tflite_eon_graph_t ei_config_graph_40 = {
     .model_reset = &tflite_learn_40_reset,
     .model_input = &tflite_learn_40_input,
     .model_output = &tflite_learn_40_output,
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+    .model_layer_count = &tflite_learn_40_layer_count,
+    .model_layer_stats = &tflite_learn_40_layer_stats,
+    .model_reset_layer_stats = &tflite_learn_40_reset_layer_stats,
+    .model_set_profiler = &tflite_learn_40_set_profiler,
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    .model_arena_usage = &tflite_learn_40_arena_usage,
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
+#if EI_CLASSIFIER_TFLITE_REENTRANT
+    .model_create = &tflite_learn_40_create,
+    .model_instance_invoke = &tflite_learn_40_instance_invoke,
+    .model_instance_input = &tflite_learn_40_instance_input,
+    .model_instance_output = &tflite_learn_40_instance_output,
+    .model_destroy = &tflite_learn_40_destroy,
+#endif // EI_CLASSIFIER_TFLITE_REENTRANT
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+    .model_set_early_exit = &tflite_learn_40_set_early_exit,
+    .model_early_exit_stats = &tflite_learn_40_early_exit_stats,
+    .model_reset_early_exit_stats = &tflite_learn_40_reset_early_exit_stats,
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+    .model_invoke_batch = &tflite_learn_40_invoke_batch,
 };
 
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+constexpr ei_memory_plan_layout_t ei_memory_plan_layout_40 = {
+    .features_bytes = 11960 * sizeof(float),
+    .arena_bytes = tflite_learn_40_arena_size,
+    .arena_tensor_bytes = tflite_learn_40_arena_tensor_size,
+    .input_offset = tflite_learn_40_input_offset,
+    .input_bytes = tflite_learn_40_input_bytes,
+};
+static_assert(ei_memory_plan_is_valid(ei_memory_plan_layout_40), "learn block 40 does not fit the unified memory plan");
+static_assert(ei_memory_plan_region_size(ei_memory_plan_layout_40) < 11960 * sizeof(float) + tflite_learn_40_arena_size,
+    "unified memory plan does not save any memory for learn block 40");
+// Peak of DSP features + tensor arena, shows up as the size of this symbol in the map file
+static uint8_t ei_memory_plan_region_40[ei_memory_plan_region_size(ei_memory_plan_layout_40)] __attribute__((aligned(16)));
+const ei_memory_plan_layout_t& ei_memory_plan_layout = ei_memory_plan_layout_40;
+uint8_t* const ei_memory_plan_region = ei_memory_plan_region_40;
+#endif // EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+
 const uint8_t ei_output_tensors_indices_40[1] = { 0 };
 const uint8_t ei_output_tensors_size_40 = 1;
 ei_learning_block_config_tflite_graph_t ei_learning_block_config_40 = {
@@ -124,7 +169,24 @@ const ei_fill_result_classification_i8_config_t ei_fill_result_classification_i8
     .scale = 0.00390625
 };
 
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+// one window (4 slices) of results, events at 0.7 until the score drops below 0.5
+const ei_smoothing_config_t ei_smoothing_config_42 = {
+    .mode = EI_SMOOTHING_WINDOW,
+    .alpha = 0.5f,
+    .window_size = 4,
+    .onset_threshold = 0.7f,
+    .release_threshold = 0.5f,
+    .suppression_ms = 1000,
+    .label_suppression_ms = NULL,
+    .ignore_flags = 0,
+    .replace_scores = false
+};
+
+const size_t ei_postprocessing_blocks_size = 2;
+#else
 const size_t ei_postprocessing_blocks_size = 1;
+#endif // EI_CLASSIFIER_SMOOTHING_ENABLED
 const ei_postprocessing_block_t ei_postprocessing_blocks[ei_postprocessing_blocks_size] = {
     {
         .block_id = 41,
@@ -136,6 +198,18 @@ const ei_postprocessing_block_t ei_postprocessing_blocks[ei_postprocessing_block
         .config = (void*)&ei_fill_result_classification_i8_config_40,
         .input_block_id = 40
     },
+#if EI_CLASSIFIER_SMOOTHING_ENABLED
+    {
+        .block_id = 42,
+        .type = EI_CLASSIFIER_MODE_CLASSIFICATION,
+        .init_fn = &init_smoothing,
+        .deinit_fn = &deinit_smoothing,
+        .postprocess_fn = &process_smoothing,
+        .display_fn = &display_smoothing,
+        .config = (void*)&ei_smoothing_config_42,
+        .input_block_id = 40
+    },
+#endif // EI_CLASSIFIER_SMOOTHING_ENABLED
 };
 
 const ei_impulse_t impulse_727906_0 = {
@@ -32,10 +32,26 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <new>
 #include "edge-impulse-sdk/tensorflow/lite/c/builtin_op_data.h"
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/fully_connected.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#if EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/specialized_kernels.h"
+#endif
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+#include <stdio.h>
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_profiler_interface.h"
+#endif
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+#include <atomic>
+#include <math.h>
+#endif
+#include "tflite_learn_40_compiled.h"
 
 #if EI_CLASSIFIER_PRINT_STATE
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
@@ -113,18 +129,20 @@ uint8_t tensor_arena[kTensorArenaSize] ALIGN(16);
 uint8_t tensor_arena[kTensorArenaSize] ALIGN(16) __attribute__((section(".tensor_arena")));
 #else
 #define EI_CLASSIFIER_ALLOCATION_HEAP 1
+// stays NULL, arena tensors below are offsets into the arena of an instance
 uint8_t* tensor_arena = NULL;
 #endif
 
-static uint8_t* tensor_boundary;
-static uint8_t* current_location;
-
 template <int SZ, class T> struct TfArray {
   int sz; T elem[SZ];
 };
 
 enum used_operators_e {
-  OP_RESHAPE, OP_CONV_2D, OP_MAX_POOL_2D, OP_FULLY_CONNECTED, OP_SOFTMAX,  OP_LAST
+  OP_RESHAPE, OP_CONV_2D, OP_MAX_POOL_2D, OP_FULLY_CONNECTED, OP_SOFTMAX,
+#if EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS
+  OP_CONV_2D_40_8, OP_CONV_2D_8_16, OP_FULLY_CONNECTED_1200_512, OP_FULLY_CONNECTED_512_5,
+#endif
+  OP_LAST
 };
 
 struct TensorInfo_t { // subset of TfLiteTensor used for initialization from constant memory
@@ -146,11 +164,8 @@ typedef struct {
   int16_t index;
 } TfLiteEvalTensorWithIndex;
 
-TfLiteContext ctx{};
 static const int MAX_TFL_TENSOR_COUNT = 4;
-static TfLiteTensorWithIndex tflTensors[MAX_TFL_TENSOR_COUNT];
 static const int MAX_TFL_EVAL_COUNT = 4;
-static TfLiteEvalTensorWithIndex tflEvalTensors[MAX_TFL_EVAL_COUNT];
 TfLiteRegistration registrations[OP_LAST];
 
 namespace g0 {
@@ -804,7 +819,7 @@ const TfArray<1, int> outputs11 = { 1, { 25 } };
 };
 
 TensorInfo_t tensorData[] = {
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 11968), (TfLiteIntArray*)&g0::tensor_dimension0, 11960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(0)), (TfLiteIntArray*)&g0::tensor_dimension0, 11960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data1, (TfLiteIntArray*)&g0::tensor_dimension1, 16, {kTfLiteNoQuantization, nullptr}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data2, (TfLiteIntArray*)&g0::tensor_dimension1, 16, {kTfLiteNoQuantization, nullptr}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data3, (TfLiteIntArray*)&g0::tensor_dimension1, 16, {kTfLiteNoQuantization, nullptr}, },
@@ -818,18 +833,18 @@ TensorInfo_t tensorData[] = {
 { kTfLiteMmapRo, kTfLiteInt8, (int32_t*)g0::tensor_data11, (TfLiteIntArray*)&g0::tensor_dimension11, 384, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant11))}, },
 { kTfLiteMmapRo, kTfLiteInt32, (int32_t*)g0::tensor_data12, (TfLiteIntArray*)&g0::tensor_dimension12, 32, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant12))}, },
 { kTfLiteMmapRo, kTfLiteInt8, (int32_t*)g0::tensor_data13, (TfLiteIntArray*)&g0::tensor_dimension13, 960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant13))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension14, 11960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 11968), (TfLiteIntArray*)&g0::tensor_dimension15, 2392, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension16, 2392, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 2400), (TfLiteIntArray*)&g0::tensor_dimension17, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension18, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 2400), (TfLiteIntArray*)&g0::tensor_dimension19, 2400, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension20, 2400, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 2400), (TfLiteIntArray*)&g0::tensor_dimension21, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension22, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 1200), (TfLiteIntArray*)&g0::tensor_dimension23, 512, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant23))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 16), (TfLiteIntArray*)&g0::tensor_dimension24, 5, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant24))}, },
-{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + 0), (TfLiteIntArray*)&g0::tensor_dimension24, 5, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(14)), (TfLiteIntArray*)&g0::tensor_dimension14, 11960, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(15)), (TfLiteIntArray*)&g0::tensor_dimension15, 2392, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(16)), (TfLiteIntArray*)&g0::tensor_dimension16, 2392, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(17)), (TfLiteIntArray*)&g0::tensor_dimension17, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(18)), (TfLiteIntArray*)&g0::tensor_dimension18, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant15))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(19)), (TfLiteIntArray*)&g0::tensor_dimension19, 2400, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(20)), (TfLiteIntArray*)&g0::tensor_dimension20, 2400, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(21)), (TfLiteIntArray*)&g0::tensor_dimension21, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(22)), (TfLiteIntArray*)&g0::tensor_dimension22, 1200, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant19))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(23)), (TfLiteIntArray*)&g0::tensor_dimension23, 512, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant23))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(24)), (TfLiteIntArray*)&g0::tensor_dimension24, 5, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant24))}, },
+{ kTfLiteArenaRw, kTfLiteInt8, (int32_t*)(tensor_arena + tflite_learn_40_tensor_offset(25)), (TfLiteIntArray*)&g0::tensor_dimension24, 5, {kTfLiteAffineQuantization, const_cast<void*>(static_cast<const void*>(&g0::quant0))}, },
 };
 
 #ifndef TF_LITE_STATIC_MEMORY
@@ -864,8 +879,13 @@ TfLiteNode tflNodes[12] = {
 };
 #endif
 
+#if EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS
+used_operators_e used_ops[] =
+{OP_RESHAPE, OP_CONV_2D_40_8, OP_RESHAPE, OP_MAX_POOL_2D, OP_RESHAPE, OP_CONV_2D_8_16, OP_RESHAPE, OP_MAX_POOL_2D, OP_RESHAPE, OP_FULLY_CONNECTED_1200_512, OP_FULLY_CONNECTED_512_5, OP_SOFTMAX, };
+#else
 used_operators_e used_ops[] =
 {OP_RESHAPE, OP_CONV_2D, OP_RESHAPE, OP_MAX_POOL_2D, OP_RESHAPE, OP_CONV_2D, OP_RESHAPE, OP_MAX_POOL_2D, OP_RESHAPE, OP_FULLY_CONNECTED, OP_FULLY_CONNECTED, OP_SOFTMAX, };
+#endif
 
 
 // Indices into tflTensors and tflNodes for subgraphs
@@ -882,9 +902,23 @@ static const int out_tensor_indices[] = {
 };
 
 
-size_t current_subgraph_index = 0;
+// Arena tensors are laid out against tensor_arena, rebase them on the arena of an instance
+static void* tensor_data_ptr(uint8_t* arena, size_t i) {
+#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
+  if (tensorData[i].allocation_type == kTfLiteArenaRw) {
+    return (void*) ((uintptr_t)tensorData[i].data + (uintptr_t) arena);
+  }
+  return tensorData[i].data;
+#else
+  uint8_t* data = (uint8_t*)tensorData[i].data;
+  if (tensor_arena <= data && data < tensor_arena + kTensorArenaSize) {
+    return arena + (data - tensor_arena);
+  }
+  return data;
+#endif // EI_CLASSIFIER_ALLOCATION_HEAP
+}
 
-static void init_tflite_tensor(size_t i, TfLiteTensor *tensor) {
+static void init_tflite_tensor(uint8_t* arena, size_t i, TfLiteTensor *tensor) {
   tensor->type = tensorData[i].type;
   tensor->is_variable = false;
 
@@ -895,19 +929,7 @@ static void init_tflite_tensor(size_t i, TfLiteTensor *tensor) {
 #endif
   tensor->bytes = tensorData[i].bytes;
   tensor->dims = tensorData[i].dims;
-
-#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
-  if(tensor->allocation_type == kTfLiteArenaRw){
-    uint8_t* start = (uint8_t*) ((uintptr_t)tensorData[i].data + (uintptr_t) tensor_arena);
-
-    tensor->data.data =  start;
-  }
-  else {
-      tensor->data.data = tensorData[i].data;
-  }
-#else
-  tensor->data.data = tensorData[i].data;
-#endif // EI_CLASSIFIER_ALLOCATION_HEAP
+  tensor->data.data = tensor_data_ptr(arena, i);
   tensor->quantization = tensorData[i].quantization;
   if (tensor->quantization.type == kTfLiteAffineQuantization) {
     TfLiteAffineQuantization const* quant = ((TfLiteAffineQuantization const*)(tensorData[i].quantization.params));
@@ -917,36 +939,169 @@ static void init_tflite_tensor(size_t i, TfLiteTensor *tensor) {
 
 }
 
-static void init_tflite_eval_tensor(int i, TfLiteEvalTensor *tensor) {
+static void init_tflite_eval_tensor(uint8_t* arena, int i, TfLiteEvalTensor *tensor) {
 
   tensor->type = tensorData[i].type;
 
   tensor->dims = tensorData[i].dims;
 
-#if defined(EI_CLASSIFIER_ALLOCATION_HEAP)
-  auto allocation_type = tensorData[i].allocation_type;
-  if(allocation_type == kTfLiteArenaRw) {
-    uint8_t* start = (uint8_t*) ((uintptr_t)tensorData[i].data + (uintptr_t) tensor_arena);
+  tensor->data.data = tensor_data_ptr(arena, i);
+}
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+#if EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS
+static const char* const op_names[OP_LAST] = {
+  "RESHAPE", "CONV_2D", "MAX_POOL_2D", "FULLY_CONNECTED", "SOFTMAX",
+  "CONV_2D_40_8", "CONV_2D_8_16", "FULLY_CONNECTED_1200_512", "FULLY_CONNECTED_512_5",
+};
+#else
+static const char* const op_names[OP_LAST] = {
+  "RESHAPE", "CONV_2D", "MAX_POOL_2D", "FULLY_CONNECTED", "SOFTMAX",
+};
+#endif
 
-    tensor->data.data =  start;
+// Profiler event tags, "<op>/<node>" or "<op>:<variant>/<node>" for kernels that pick
+// a variant in prepare. Built once after the first prepare, these need to outlive the profiler.
+static const size_t kNodeTagLength = 48;
+static char node_tags[12][kNodeTagLength];
+
+// Only the default instance forwards events, the profiler is not thread safe
+static tflite::MicroProfilerInterface* layer_profiler = nullptr;
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+
+typedef struct {
+  size_t bytes;
+  void *ptr;
+} scratch_buffer_t;
+
+struct tflite_learn_40_instance;
+
+class EonMicroContext : public MicroContext {
+ public:
+
+  explicit EonMicroContext(tflite_learn_40_instance* instance): MicroContext(nullptr, nullptr, nullptr), instance_(instance) { }
+
+  void* AllocatePersistentBuffer(size_t bytes);
+
+  TfLiteStatus RequestScratchBufferInArena(size_t bytes,
+                                           int* buffer_index);
+
+  void* GetScratchBuffer(int buffer_index);
+
+  TfLiteTensor* AllocateTempTfLiteTensor(int tensor_index);
+
+  void DeallocateTempTfLiteTensor(TfLiteTensor* tensor) {
+    return;
+  }
+
+  bool IsAllTempTfLiteTensorDeallocated() {
+    return true;
+  }
+
+  TfLiteEvalTensor* GetEvalTensor(int tensor_index);
+
+  tflite_learn_40_instance* instance() const {
+    return instance_;
+  }
+
+ private:
+  tflite_learn_40_instance* instance_;
+};
+
+// Nodes [kBatchFirstNode, kBatchEndNode) are the fully connected layers that
+// tflite_learn_40_invoke_batch runs once per batch instead of once per input
+static const size_t kBatchFirstNode = 9;
+static const size_t kBatchEndNode = 11;
+// Inputs per pass over the weights, bounds the activation buffers to a few tens of KB
+static const size_t kMaxBatch = 32;
+
+// Everything that changes while the model runs. The model itself (weights, quantization
+// parameters, tensor layout) is read-only and shared between instances.
+struct tflite_learn_40_instance {
+  tflite_learn_40_instance(): micro_context(this) { }
+
+  TfLiteContext ctx{};
+  EonMicroContext micro_context;
+  // kernels keep their op data in user_data, so every instance but the default one has a copy of tflNodes
+  TfLiteNode* nodes = nullptr;
+
+  uint8_t* tensor_arena = nullptr;
+  uint8_t* tensor_boundary = nullptr;
+  uint8_t* current_location = nullptr;
+  size_t current_subgraph_index = 0;
+
+  TfLiteTensorWithIndex tflTensors[MAX_TFL_TENSOR_COUNT];
+  TfLiteEvalTensorWithIndex tflEvalTensors[MAX_TFL_EVAL_COUNT];
+
+  void* overflow_buffers[EI_MAX_OVERFLOW_BUFFER_COUNT];
+  size_t overflow_buffers_ix = 0;
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+  size_t overflow_bytes = 0;
+#endif
+
+  scratch_buffer_t scratch_buffers[EI_MAX_SCRATCH_BUFFER_COUNT];
+  size_t scratch_buffers_ix = 0;
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+  // Node currently in init / prepare, allocations outside of it are not attributed
+  int profiling_node = -1;
+  ei_tflite_layer_stats_t layer_stats[12];
+#endif
+
+  // Quantization parameters of the batched nodes, filled on the first batch
+  OpDataFullyConnected batch_fc[kBatchEndNode - kBatchFirstNode];
+  bool batch_fc_ready = false;
+};
+
+// Used by tflite_learn_40_init / _invoke / _reset
+static tflite_learn_40_instance default_instance;
+
+static tflite_learn_40_instance* instance_of(const struct TfLiteContext* context) {
+  return static_cast<EonMicroContext*>(context->impl_)->instance();
+}
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+static void record_allocation(tflite_learn_40_instance* inst, void* ptr, size_t bytes, bool scratch) {
+  if (inst->profiling_node < 0 || !ptr) {
+    return;
+  }
+  ei_tflite_layer_stats_t* stats = &inst->layer_stats[inst->profiling_node];
+  bool in_arena = (uint8_t*)ptr >= inst->tensor_arena && (uint8_t*)ptr < inst->tensor_arena + kTensorArenaSize;
+  if (!in_arena) {
+    stats->overflow_bytes += bytes;
+  }
+  else if (scratch) {
+    stats->scratch_bytes += bytes;
   }
   else {
-    tensor->data.data = tensorData[i].data;
+    stats->persistent_bytes += bytes;
   }
-#else
-  tensor->data.data = tensorData[i].data;
-#endif // EI_CLASSIFIER_ALLOCATION_HEAP
 }
 
-static void* overflow_buffers[EI_MAX_OVERFLOW_BUFFER_COUNT];
-static size_t overflow_buffers_ix = 0;
-static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
-                                       size_t bytes) {
+// The op of the registration a node runs, plus the variant its kernel picked in
+// prepare if the registration reports one (profiling_string)
+static bool build_node_tags(tflite_learn_40_instance* inst) {
+  for (size_t i = 0; i < 12; ++i) {
+    const TfLiteRegistration& registration = registrations[used_ops[i]];
+    const char* variant = registration.profiling_string ?
+      registration.profiling_string(&inst->ctx, &inst->nodes[i]) : nullptr;
+    if (variant) {
+      snprintf(node_tags[i], kNodeTagLength, "%s:%s/%d", op_names[used_ops[i]], variant, (int)i);
+    }
+    else {
+      snprintf(node_tags[i], kNodeTagLength, "%s/%d", op_names[used_ops[i]], (int)i);
+    }
+  }
+  return true;
+}
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+
+static void * AllocateArenaBuffer(tflite_learn_40_instance* inst, size_t bytes) {
   void *ptr;
   uint32_t align_bytes = (bytes % 16) ? 16 - (bytes % 16) : 0;
 
-  if (current_location - (bytes + align_bytes) < tensor_boundary) {
-    if (overflow_buffers_ix > EI_MAX_OVERFLOW_BUFFER_COUNT - 1) {
+  if (inst->current_location - (bytes + align_bytes) < inst->tensor_boundary) {
+    if (inst->overflow_buffers_ix > EI_MAX_OVERFLOW_BUFFER_COUNT - 1) {
       ei_printf("ERR: Failed to allocate persistent buffer of size %d, does not fit in tensor arena and reached EI_MAX_OVERFLOW_BUFFER_COUNT\n",
         (int)bytes);
       return NULL;
@@ -959,33 +1114,40 @@ static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
       ei_printf("ERR: Failed to allocate persistent buffer of size %d\n", (int)bytes);
       return NULL;
     }
-    overflow_buffers[overflow_buffers_ix++] = ptr;
+    inst->overflow_buffers[inst->overflow_buffers_ix++] = ptr;
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+    inst->overflow_bytes += bytes;
+#endif
     return ptr;
   }
 
-  current_location -= bytes;
+  inst->current_location -= bytes;
 
   // align to the left aligned boundary of 16 bytes
-  current_location -= 15; // for alignment
-  current_location += 16 - ((uintptr_t)(current_location) & 15);
+  inst->current_location -= 15; // for alignment
+  inst->current_location += 16 - ((uintptr_t)(inst->current_location) & 15);
 
-  ptr = current_location;
+  ptr = inst->current_location;
   memset(ptr, 0, bytes);
 
   return ptr;
 }
 
-typedef struct {
-  size_t bytes;
-  void *ptr;
-} scratch_buffer_t;
-
-static scratch_buffer_t scratch_buffers[EI_MAX_SCRATCH_BUFFER_COUNT];
-static size_t scratch_buffers_ix = 0;
+static void * AllocatePersistentBufferImpl(struct TfLiteContext* ctx,
+                                       size_t bytes) {
+  tflite_learn_40_instance* inst = instance_of(ctx);
+  void *ptr = AllocateArenaBuffer(inst, bytes);
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+  record_allocation(inst, ptr, bytes, false);
+#endif
+  return ptr;
+}
 
 static TfLiteStatus RequestScratchBufferInArenaImpl(struct TfLiteContext* ctx, size_t bytes,
                                                 int* buffer_idx) {
-  if (scratch_buffers_ix > EI_MAX_SCRATCH_BUFFER_COUNT - 1) {
+  tflite_learn_40_instance* inst = instance_of(ctx);
+
+  if (inst->scratch_buffers_ix > EI_MAX_SCRATCH_BUFFER_COUNT - 1) {
     ei_printf("ERR: Failed to allocate scratch buffer of size %d, reached EI_MAX_SCRATCH_BUFFER_COUNT\n",
       (int)bytes);
     return kTfLiteError;
@@ -994,55 +1156,61 @@ static TfLiteStatus RequestScratchBufferInArenaImpl(struct TfLiteContext* ctx, s
   scratch_buffer_t b;
   b.bytes = bytes;
 
-  b.ptr = AllocatePersistentBufferImpl(ctx, b.bytes);
+  b.ptr = AllocateArenaBuffer(inst, b.bytes);
   if (!b.ptr) {
     ei_printf("ERR: Failed to allocate scratch buffer of size %d\n",
       (int)bytes);
     return kTfLiteError;
   }
 
-  scratch_buffers[scratch_buffers_ix] = b;
-  *buffer_idx = scratch_buffers_ix;
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+  record_allocation(inst, b.ptr, b.bytes, true);
+#endif
+
+  inst->scratch_buffers[inst->scratch_buffers_ix] = b;
+  *buffer_idx = inst->scratch_buffers_ix;
 
-  scratch_buffers_ix++;
+  inst->scratch_buffers_ix++;
 
   return kTfLiteOk;
 }
 
 static void* GetScratchBufferImpl(struct TfLiteContext* ctx, int buffer_idx) {
-  if (buffer_idx > (int)scratch_buffers_ix) {
+  tflite_learn_40_instance* inst = instance_of(ctx);
+  if (buffer_idx > (int)inst->scratch_buffers_ix) {
     return NULL;
   }
-  return scratch_buffers[buffer_idx].ptr;
+  return inst->scratch_buffers[buffer_idx].ptr;
 }
 
 static const uint16_t TENSOR_IX_UNUSED = 0x7FFF;
 
-static void ResetTensors() {
+static void ResetTensors(tflite_learn_40_instance* inst) {
   for (size_t ix = 0; ix < MAX_TFL_TENSOR_COUNT; ix++) {
-    tflTensors[ix].index = TENSOR_IX_UNUSED;
+    inst->tflTensors[ix].index = TENSOR_IX_UNUSED;
   }
   for (size_t ix = 0; ix < MAX_TFL_EVAL_COUNT; ix++) {
-    tflEvalTensors[ix].index = TENSOR_IX_UNUSED;
+    inst->tflEvalTensors[ix].index = TENSOR_IX_UNUSED;
   }
 }
 
 static TfLiteTensor* GetTensorImpl(const struct TfLiteContext* context,
                                int tensor_idx) {
+  tflite_learn_40_instance* inst = instance_of(context);
 
-  tensor_idx = tflTensors_subgraph_index[current_subgraph_index] + tensor_idx;
+  tensor_idx = tflTensors_subgraph_index[inst->current_subgraph_index] + tensor_idx;
 
   for (size_t ix = 0; ix < MAX_TFL_TENSOR_COUNT; ix++) {
     // already used? OK!
-    if (tflTensors[ix].index == tensor_idx) {
-      return &tflTensors[ix].tensor;
+    if (inst->tflTensors[ix].index == tensor_idx) {
+      return &inst->tflTensors[ix].tensor;
     }
     // passed all the ones we've used, so end of the list?
-    if (tflTensors[ix].index == TENSOR_IX_UNUSED) {
+    if (inst->tflTensors[ix].index == TENSOR_IX_UNUSED) {
       // init the tensor
-      init_tflite_tensor(tensor_idx, &tflTensors[ix].tensor);
-      tflTensors[ix].index = tensor_idx;
-      return &tflTensors[ix].tensor;
+      init_tflite_tensor(inst->tensor_arena, tensor_idx, &inst->tflTensors[ix].tensor);
+      inst->tflTensors[ix].index = tensor_idx;
+      return &inst->tflTensors[ix].tensor;
     }
   }
 
@@ -1052,20 +1220,21 @@ static TfLiteTensor* GetTensorImpl(const struct TfLiteContext* context,
 
 static TfLiteEvalTensor* GetEvalTensorImpl(const struct TfLiteContext* context,
                                        int tensor_idx) {
+  tflite_learn_40_instance* inst = instance_of(context);
 
-  tensor_idx = tflTensors_subgraph_index[current_subgraph_index] + tensor_idx;
+  tensor_idx = tflTensors_subgraph_index[inst->current_subgraph_index] + tensor_idx;
 
   for (size_t ix = 0; ix < MAX_TFL_EVAL_COUNT; ix++) {
     // already used? OK!
-    if (tflEvalTensors[ix].index == tensor_idx) {
-      return &tflEvalTensors[ix].tensor;
+    if (inst->tflEvalTensors[ix].index == tensor_idx) {
+      return &inst->tflEvalTensors[ix].tensor;
     }
     // passed all the ones we've used, so end of the list?
-    if (tflEvalTensors[ix].index == TENSOR_IX_UNUSED) {
+    if (inst->tflEvalTensors[ix].index == TENSOR_IX_UNUSED) {
       // init the tensor
-      init_tflite_eval_tensor(tensor_idx, &tflEvalTensors[ix].tensor);
-      tflEvalTensors[ix].index = tensor_idx;
-      return &tflEvalTensors[ix].tensor;
+      init_tflite_eval_tensor(inst->tensor_arena, tensor_idx, &inst->tflEvalTensors[ix].tensor);
+      inst->tflEvalTensors[ix].index = tensor_idx;
+      return &inst->tflEvalTensors[ix].tensor;
     }
   }
 
@@ -1073,135 +1242,184 @@ static TfLiteEvalTensor* GetEvalTensorImpl(const struct TfLiteContext* context,
   return nullptr;
 }
 
-class EonMicroContext : public MicroContext {
- public:
- 
-  EonMicroContext(): MicroContext(nullptr, nullptr, nullptr) { }
-
-  void* AllocatePersistentBuffer(size_t bytes) {
-    return AllocatePersistentBufferImpl(nullptr, bytes);
-  }
-
-  TfLiteStatus RequestScratchBufferInArena(size_t bytes,
-                                           int* buffer_index) {
-  return RequestScratchBufferInArenaImpl(nullptr, bytes, buffer_index);
-  }
-
-  void* GetScratchBuffer(int buffer_index) {
-    return GetScratchBufferImpl(nullptr, buffer_index);
-  }
- 
-  TfLiteTensor* AllocateTempTfLiteTensor(int tensor_index) {
-    return GetTensorImpl(nullptr, tensor_index);
-  }
-
-  void DeallocateTempTfLiteTensor(TfLiteTensor* tensor) {
-    return;
-  }
+void* EonMicroContext::AllocatePersistentBuffer(size_t bytes) {
+  return AllocatePersistentBufferImpl(&instance_->ctx, bytes);
+}
 
-  bool IsAllTempTfLiteTensorDeallocated() {
-    return true;
-  }
+TfLiteStatus EonMicroContext::RequestScratchBufferInArena(size_t bytes,
+                                                          int* buffer_index) {
+  return RequestScratchBufferInArenaImpl(&instance_->ctx, bytes, buffer_index);
+}
 
-  TfLiteEvalTensor* GetEvalTensor(int tensor_index) {
-    return GetEvalTensorImpl(nullptr, tensor_index);
-  }
+void* EonMicroContext::GetScratchBuffer(int buffer_index) {
+  return GetScratchBufferImpl(&instance_->ctx, buffer_index);
+}
 
-};
+TfLiteTensor* EonMicroContext::AllocateTempTfLiteTensor(int tensor_index) {
+  return GetTensorImpl(&instance_->ctx, tensor_index);
+}
 
+TfLiteEvalTensor* EonMicroContext::GetEvalTensor(int tensor_index) {
+  return GetEvalTensorImpl(&instance_->ctx, tensor_index);
+}
 
-} // namespace
+// Registrations are the same for every instance, fill them in once
+static bool register_ops() {
+  registrations[OP_RESHAPE] = Register_RESHAPE();
+  registrations[OP_CONV_2D] = Register_CONV_2D();
+  registrations[OP_MAX_POOL_2D] = Register_MAX_POOL_2D();
+  registrations[OP_FULLY_CONNECTED] = Register_FULLY_CONNECTED();
+  registrations[OP_SOFTMAX] = Register_SOFTMAX();
+#if EI_CLASSIFIER_TFLITE_SPECIALIZED_KERNELS
+  registrations[OP_CONV_2D_40_8] = Register_CONV_2D_SPECIALIZED<40, 8, 3, 1>();
+  registrations[OP_CONV_2D_8_16] = Register_CONV_2D_SPECIALIZED<8, 16, 3, 1>();
+  registrations[OP_FULLY_CONNECTED_1200_512] = Register_FULLY_CONNECTED_SPECIALIZED<1200, 512>();
+  registrations[OP_FULLY_CONNECTED_512_5] = Register_FULLY_CONNECTED_SPECIALIZED<512, 5>();
+#endif
+  return true;
+}
 
-TfLiteStatus tflite_learn_40_init( void*(*alloc_fnc)(size_t,size_t) ) {
-#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
-  tensor_arena = (uint8_t*) alloc_fnc(16, kTensorArenaSize);
-  if (!tensor_arena) {
-    ei_printf("ERR: failed to allocate tensor arena\n");
+// arena must hold kTensorArenaSize bytes, aligned to 16. It is not cleared, with the
+// unified memory plan the input tensor already holds the features at this point.
+static TfLiteStatus init_instance(tflite_learn_40_instance* inst, uint8_t* arena) {
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+  if (kTensorArenaSize != tflite_learn_40_arena_size) {
+    ei_printf("ERR: arena size in tflite_learn_40_compiled.h does not match the model\n");
     return kTfLiteError;
   }
-#else
-  memset(tensor_arena, 0, kTensorArenaSize);
 #endif
-  tensor_boundary = tensor_arena;
-  current_location = tensor_arena + kTensorArenaSize;
 
-  EonMicroContext micro_context_;
-  
+  inst->tensor_arena = arena;
+  inst->tensor_boundary = arena;
+  inst->current_location = arena + kTensorArenaSize;
+  inst->current_subgraph_index = 0;
+
   // Set microcontext as the context ptr
-  ctx.impl_ = static_cast<void*>(&micro_context_);
+  inst->ctx.impl_ = static_cast<void*>(&inst->micro_context);
   // Setup tflitecontext functions
-  ctx.AllocatePersistentBuffer = &AllocatePersistentBufferImpl;
-  ctx.RequestScratchBufferInArena = &RequestScratchBufferInArenaImpl;
-  ctx.GetScratchBuffer = &GetScratchBufferImpl;
-  ctx.GetTensor = &GetTensorImpl;
-  ctx.GetEvalTensor = &GetEvalTensorImpl;
-  ctx.ReportError = &MicroContextReportOpError;
-
-  ctx.tensors_size = 26;
+  inst->ctx.AllocatePersistentBuffer = &AllocatePersistentBufferImpl;
+  inst->ctx.RequestScratchBufferInArena = &RequestScratchBufferInArenaImpl;
+  inst->ctx.GetScratchBuffer = &GetScratchBufferImpl;
+  inst->ctx.GetTensor = &GetTensorImpl;
+  inst->ctx.GetEvalTensor = &GetEvalTensorImpl;
+  inst->ctx.ReportError = &MicroContextReportOpError;
+
+  inst->ctx.tensors_size = 26;
   for (size_t i = 0; i < 26; ++i) {
     TfLiteTensor tensor;
-    init_tflite_tensor(i, &tensor);
+    init_tflite_tensor(arena, i, &tensor);
     if (tensor.allocation_type == kTfLiteArenaRw) {
       auto data_end_ptr = (uint8_t*)tensor.data.data + tensorData[i].bytes;
-      if (data_end_ptr > tensor_boundary) {
-        tensor_boundary = data_end_ptr;
+      if (data_end_ptr > inst->tensor_boundary) {
+        inst->tensor_boundary = data_end_ptr;
       }
     }
   }
 
-  if (tensor_boundary > current_location /* end of arena size */) {
+  if (inst->tensor_boundary > inst->current_location /* end of arena size */) {
     ei_printf("ERR: tensor arena is too small, does not fit model - even without scratch buffers\n");
     return kTfLiteError;
   }
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+  if (inst->tensor_boundary != arena + tflite_learn_40_arena_tensor_size) {
+    ei_printf("ERR: tensor layout does not match the memory plan in tflite_learn_40_compiled.h\n");
+    return kTfLiteError;
+  }
+#endif
 
-  registrations[OP_RESHAPE] = Register_RESHAPE();
-  registrations[OP_CONV_2D] = Register_CONV_2D();
-  registrations[OP_MAX_POOL_2D] = Register_MAX_POOL_2D();
-  registrations[OP_FULLY_CONNECTED] = Register_FULLY_CONNECTED();
-  registrations[OP_SOFTMAX] = Register_SOFTMAX();
+  static const bool ops_registered = register_ops();
+  (void)ops_registered;
+
+  if (inst->nodes != tflNodes) {
+    memcpy(inst->nodes, tflNodes, sizeof(tflNodes));
+  }
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+  for (size_t i = 0; i < 12; ++i) {
+    ei_tflite_layer_stats_t* stats = &inst->layer_stats[i];
+    stats->tag = node_tags[i];
+    stats->op = op_names[used_ops[i]];
+    stats->output_bytes = 0;
+    for (int ix = 0; ix < tflNodes[i].outputs->size; ix++) {
+      stats->output_bytes += tensorData[tflNodes[i].outputs->data[ix]].bytes;
+    }
+    stats->persistent_bytes = 0;
+    stats->scratch_bytes = 0;
+    stats->overflow_bytes = 0;
+  }
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
 
   for (size_t g = 0; g < 1; ++g) {
-    current_subgraph_index = g;
+    inst->current_subgraph_index = g;
     for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
       if (registrations[used_ops[i]].init) {
-        tflNodes[i].user_data = registrations[used_ops[i]].init(&ctx, (const char*)tflNodes[i].builtin_data, 0);
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+        inst->profiling_node = (int)i;
+#endif
+        inst->nodes[i].user_data = registrations[used_ops[i]].init(&inst->ctx, (const char*)inst->nodes[i].builtin_data, 0);
       }
     }
   }
-  current_subgraph_index = 0;
+  inst->current_subgraph_index = 0;
 
   for(size_t g = 0; g < 1; ++g) {
-    current_subgraph_index = g;
+    inst->current_subgraph_index = g;
     for(size_t i = tflNodes_subgraph_index[g]; i < tflNodes_subgraph_index[g+1]; ++i) {
       if (registrations[used_ops[i]].prepare) {
-        ResetTensors();
-        TfLiteStatus status = registrations[used_ops[i]].prepare(&ctx, &tflNodes[i]);
+        ResetTensors(inst);
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+        inst->profiling_node = (int)i;
+#endif
+        TfLiteStatus status = registrations[used_ops[i]].prepare(&inst->ctx, &inst->nodes[i]);
         if (status != kTfLiteOk) {
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+          inst->profiling_node = -1;
+#endif
           return status;
         }
       }
     }
   }
-  current_subgraph_index = 0;
+  inst->current_subgraph_index = 0;
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+  inst->profiling_node = -1;
 
-  return kTfLiteOk;
-}
+  // the variants depend on the layer shapes only, so every instance gets the same tags
+  static const bool tags_built = build_node_tags(inst);
+  (void)tags_built;
+#endif
 
-TfLiteStatus tflite_learn_40_input(int index, TfLiteTensor *tensor) {
-  init_tflite_tensor(in_tensor_indices[index], tensor);
   return kTfLiteOk;
 }
 
-TfLiteStatus tflite_learn_40_output(int index, TfLiteTensor *tensor) {
-  init_tflite_tensor(out_tensor_indices[index], tensor);
-  return kTfLiteOk;
-}
+// Runs nodes [begin, end)
+static TfLiteStatus invoke_nodes(tflite_learn_40_instance* inst, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    ResetTensors(inst);
 
-TfLiteStatus tflite_learn_40_invoke() {
-  for (size_t i = 0; i < 12; ++i) {
-    ResetTensors();
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+    uint32_t event_handle = 0;
+    if (layer_profiler && inst == &default_instance) {
+      event_handle = layer_profiler->BeginEvent(node_tags[i]);
+    }
+    uint64_t start_us = ei_read_timer_us();
+#endif
 
-    TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
+    TfLiteStatus status = registrations[used_ops[i]].invoke(&inst->ctx, &inst->nodes[i]);
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+    uint32_t elapsed_us = (uint32_t)(ei_read_timer_us() - start_us);
+    if (layer_profiler && inst == &default_instance) {
+      layer_profiler->EndEvent(event_handle);
+    }
+    ei_tflite_layer_stats_t* stats = &inst->layer_stats[i];
+    stats->invoke_count++;
+    stats->total_us += elapsed_us;
+    stats->last_us = elapsed_us;
+    if (elapsed_us > stats->max_us) {
+      stats->max_us = elapsed_us;
+    }
+#endif
 
 #if EI_CLASSIFIER_PRINT_STATE
     ei_printf("layer %lu\n", i);
@@ -1209,11 +1427,7 @@ TfLiteStatus tflite_learn_40_invoke() {
     for (size_t ix = 0; ix < tflNodes[i].inputs->size; ix++) {
       auto d = tensorData[tflNodes[i].inputs->data[ix]];
 
-      size_t data_ptr = (size_t)d.data;
-
-      if (d.allocation_type == kTfLiteArenaRw) {
-        data_ptr = (size_t)tensor_arena + data_ptr;
-      }
+      size_t data_ptr = (size_t)tensor_data_ptr(inst->tensor_arena, tflNodes[i].inputs->data[ix]);
 
       if (d.type == TfLiteType::kTfLiteInt8) {
         int8_t* data = (int8_t*)data_ptr;
@@ -1237,11 +1451,7 @@ TfLiteStatus tflite_learn_40_invoke() {
     for (size_t ix = 0; ix < tflNodes[i].outputs->size; ix++) {
       auto d = tensorData[tflNodes[i].outputs->data[ix]];
 
-      size_t data_ptr = (size_t)d.data;
-
-      if (d.allocation_type == kTfLiteArenaRw) {
-        data_ptr = (size_t)tensor_arena + data_ptr;
-      }
+      size_t data_ptr = (size_t)tensor_data_ptr(inst->tensor_arena, tflNodes[i].outputs->data[ix]);
 
       if (d.type == TfLiteType::kTfLiteInt8) {
         int8_t* data = (int8_t*)data_ptr;
@@ -1269,18 +1479,403 @@ TfLiteStatus tflite_learn_40_invoke() {
   return kTfLiteOk;
 }
 
-TfLiteStatus tflite_learn_40_reset( void (*free_fnc)(void* ptr) ) {
-#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
-  free_fnc(tensor_arena);
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+// The head reads the input of this node (tensor 21, the pooled 75x16 activations)
+// and stands in for it and everything after it
+static const size_t kEarlyExitNode = 9;
+static const size_t kEarlyExitMaxChannels = 64;
+static const size_t kEarlyExitMaxOutputs = 16;
+
+static std::atomic<const ei_tflite_early_exit_head_t*> early_exit_head(nullptr);
+static std::atomic<uint32_t> early_exit_invokes(0);
+static std::atomic<uint32_t> early_exit_exits(0);
+
+// Runs the head on the activations, writes the model output and returns true if
+// its top-class margin is large enough
+static bool try_early_exit(tflite_learn_40_instance* inst, const ei_tflite_early_exit_head_t* head) {
+  const int in = tflNodes[kEarlyExitNode].inputs->data[0];
+  const int out = tflNodes[11].outputs->data[0];
+  const TfLiteAffineQuantization* in_q = static_cast<const TfLiteAffineQuantization*>(tensorData[in].quantization.params);
+  const TfLiteAffineQuantization* out_q = static_cast<const TfLiteAffineQuantization*>(tensorData[out].quantization.params);
+  const size_t outputs = tensorData[out].bytes;
+  const size_t rows = tensorData[in].bytes / head->channels;
+
+  // average over time, per channel
+  const int8_t* x = static_cast<const int8_t*>(tensor_data_ptr(inst->tensor_arena, in));
+  int32_t sums[kEarlyExitMaxChannels] = { 0 };
+  for (size_t r = 0; r < rows; r++) {
+    for (size_t c = 0; c < head->channels; c++) {
+      sums[c] += x[r * head->channels + c];
+    }
+  }
+  float pooled[kEarlyExitMaxChannels];
+  for (size_t c = 0; c < head->channels; c++) {
+    pooled[c] = in_q->scale->data[0] * ((float)sums[c] / (float)rows - (float)in_q->zero_point->data[0]);
+  }
+
+  float scores[kEarlyExitMaxOutputs];
+  float max_logit = -INFINITY;
+  for (size_t o = 0; o < outputs; o++) {
+    float logit = head->bias ? head->bias[o] : 0.0f;
+    for (size_t c = 0; c < head->channels; c++) {
+      logit += head->weights[o * head->channels + c] * pooled[c];
+    }
+    scores[o] = logit;
+    max_logit = logit > max_logit ? logit : max_logit;
+  }
+  float sum = 0.0f;
+  for (size_t o = 0; o < outputs; o++) {
+    scores[o] = expf(scores[o] - max_logit);
+    sum += scores[o];
+  }
+
+  float top = 0.0f, second = 0.0f;
+  for (size_t o = 0; o < outputs; o++) {
+    scores[o] /= sum;
+    if (scores[o] > top) {
+      second = top;
+      top = scores[o];
+    }
+    else if (scores[o] > second) {
+      second = scores[o];
+    }
+  }
+  if (top - second < head->margin) {
+    return false;
+  }
+
+  // same quantization as the softmax output
+  int8_t* y = static_cast<int8_t*>(tensor_data_ptr(inst->tensor_arena, out));
+  for (size_t o = 0; o < outputs; o++) {
+    int32_t q = (int32_t)roundf(scores[o] / out_q->scale->data[0]) + out_q->zero_point->data[0];
+    y[o] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+  }
+  return true;
+}
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
+static TfLiteStatus invoke_instance(tflite_learn_40_instance* inst) {
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+  const ei_tflite_early_exit_head_t* head = early_exit_head.load();
+  if (head) {
+    TfLiteStatus status = invoke_nodes(inst, 0, kEarlyExitNode);
+    if (status != kTfLiteOk) {
+      return status;
+    }
+    early_exit_invokes++;
+    if (try_early_exit(inst, head)) {
+      early_exit_exits++;
+      return kTfLiteOk;
+    }
+    return invoke_nodes(inst, kEarlyExitNode, 12);
+  }
+#endif
+  return invoke_nodes(inst, 0, 12);
+}
+
+static TfLiteStatus prepare_batch(tflite_learn_40_instance* inst) {
+  for (size_t i = kBatchFirstNode; i < kBatchEndNode; ++i) {
+    const TfLiteNode* node = &tflNodes[i];
+    const auto params = static_cast<const TfLiteFullyConnectedParams*>(node->builtin_data);
+    ResetTensors(inst);
+    TfLiteTensor* input = GetTensorImpl(&inst->ctx, node->inputs->data[kFullyConnectedInputTensor]);
+    TfLiteTensor* filter = GetTensorImpl(&inst->ctx, node->inputs->data[kFullyConnectedWeightsTensor]);
+    TfLiteTensor* bias = GetTensorImpl(&inst->ctx, node->inputs->data[kFullyConnectedBiasTensor]);
+    TfLiteTensor* output = GetTensorImpl(&inst->ctx, node->outputs->data[kFullyConnectedOutputTensor]);
+    if (!input || !filter || !bias || !output ||
+        input->type != kTfLiteInt8 || filter->type != kTfLiteInt8 || output->type != kTfLiteInt8) {
+      ei_printf("ERR: node %d can not be batched\n", (int)i);
+      return kTfLiteError;
+    }
+    TfLiteStatus status = CalculateOpDataFullyConnected(&inst->ctx, params->activation, input->type,
+      input, filter, bias, output, &inst->batch_fc[i - kBatchFirstNode]);
+    if (status != kTfLiteOk) {
+      return status;
+    }
+  }
+  inst->batch_fc_ready = true;
+  return kTfLiteOk;
+}
+
+static TfLiteStatus invoke_batch(tflite_learn_40_instance* inst, size_t batch_size,
+                                 TfLiteStatus (*set_input)(void* user, size_t ix),
+                                 TfLiteStatus (*on_output)(void* user, size_t ix), void* user) {
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+  // inputs that exit early would leave holes in the batch, run them one by one
+  if (early_exit_head.load()) {
+    TfLiteStatus status = kTfLiteOk;
+    for (size_t ix = 0; ix < batch_size && status == kTfLiteOk; ix++) {
+      status = set_input(user, ix);
+      if (status == kTfLiteOk) {
+        status = invoke_instance(inst);
+      }
+      if (status == kTfLiteOk) {
+        status = on_output(user, ix);
+      }
+    }
+    return status;
+  }
+#endif
+
+  if (!inst->batch_fc_ready && prepare_batch(inst) != kTfLiteOk) {
+    return kTfLiteError;
+  }
+
+  const int first_input = tflNodes[kBatchFirstNode].inputs->data[kFullyConnectedInputTensor];
+  const int last_output = tflNodes[kBatchEndNode - 1].outputs->data[kFullyConnectedOutputTensor];
+
+  // ping-pong buffers for the activations of a chunk, [chunk, depth]
+  size_t max_depth = tensorData[first_input].bytes;
+  for (size_t i = kBatchFirstNode; i < kBatchEndNode; ++i) {
+    size_t depth = tensorData[tflNodes[i].outputs->data[kFullyConnectedOutputTensor]].bytes;
+    if (depth > max_depth) {
+      max_depth = depth;
+    }
+  }
+  size_t chunk_size = batch_size < kMaxBatch ? batch_size : kMaxBatch;
+  int8_t* buffers = (int8_t*)ei_malloc(2 * chunk_size * max_depth);
+  if (!buffers) {
+    ei_printf("ERR: failed to allocate batch buffers (%d bytes)\n", (int)(2 * chunk_size * max_depth));
+    return kTfLiteError;
+  }
+
+  TfLiteStatus status = kTfLiteOk;
+  for (size_t start = 0; start < batch_size && status == kTfLiteOk; start += chunk_size) {
+    size_t count = batch_size - start < chunk_size ? batch_size - start : chunk_size;
+    int8_t* in = buffers;
+    int8_t* out = buffers + chunk_size * max_depth;
+
+    // everything up to the fully connected layers, one input at a time
+    for (size_t b = 0; b < count && status == kTfLiteOk; b++) {
+      status = set_input(user, start + b);
+      if (status == kTfLiteOk) {
+        status = invoke_nodes(inst, 0, kBatchFirstNode);
+      }
+      if (status == kTfLiteOk) {
+        memcpy(in + b * tensorData[first_input].bytes, tensor_data_ptr(inst->tensor_arena, first_input),
+          tensorData[first_input].bytes);
+      }
+    }
+
+    // the fully connected layers, once for the chunk
+    for (size_t i = kBatchFirstNode; i < kBatchEndNode && status == kTfLiteOk; ++i) {
+      const TfLiteNode* node = &tflNodes[i];
+      const int filter_ix = node->inputs->data[kFullyConnectedWeightsTensor];
+      const int bias_ix = node->inputs->data[kFullyConnectedBiasTensor];
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+      uint64_t start_us = ei_read_timer_us();
+#endif
+      FullyConnectedInt8Batched(inst->batch_fc[i - kBatchFirstNode], (int)count,
+        tensorData[filter_ix].dims->data[1], tensorData[filter_ix].dims->data[0], in,
+        (const int8_t*)tensor_data_ptr(inst->tensor_arena, filter_ix),
+        (const int32_t*)tensor_data_ptr(inst->tensor_arena, bias_ix), out);
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+      uint32_t elapsed_us = (uint32_t)(ei_read_timer_us() - start_us);
+      ei_tflite_layer_stats_t* stats = &inst->layer_stats[i];
+      stats->invoke_count++;
+      stats->total_us += elapsed_us;
+      stats->last_us = elapsed_us;
+      if (elapsed_us > stats->max_us) {
+        stats->max_us = elapsed_us;
+      }
 #endif
+      int8_t* tmp = in;
+      in = out;
+      out = tmp;
+    }
+
+    // and the rest of the graph, one input at a time
+    for (size_t b = 0; b < count && status == kTfLiteOk; b++) {
+      memcpy(tensor_data_ptr(inst->tensor_arena, last_output), in + b * tensorData[last_output].bytes,
+        tensorData[last_output].bytes);
+      status = invoke_nodes(inst, kBatchEndNode, 12);
+      if (status == kTfLiteOk) {
+        status = on_output(user, start + b);
+      }
+    }
+  }
+
+  ei_free(buffers);
+  return status;
+}
 
+// Releases everything but the arena
+static void reset_instance(tflite_learn_40_instance* inst) {
   // scratch buffers are allocated within the arena, so just reset the counter so memory can be reused
-  scratch_buffers_ix = 0;
+  inst->scratch_buffers_ix = 0;
 
   // overflow buffers are on the heap, so free them first
-  for (size_t ix = 0; ix < overflow_buffers_ix; ix++) {
-    ei_free(overflow_buffers[ix]);
+  for (size_t ix = 0; ix < inst->overflow_buffers_ix; ix++) {
+    ei_free(inst->overflow_buffers[ix]);
+  }
+  inst->overflow_buffers_ix = 0;
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+  inst->overflow_bytes = 0;
+#endif
+}
+
+} // namespace
+
+TfLiteStatus tflite_learn_40_init( void*(*alloc_fnc)(size_t,size_t) ) {
+  default_instance.nodes = tflNodes;
+#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
+  uint8_t* arena = (uint8_t*) alloc_fnc(16, kTensorArenaSize);
+  if (!arena) {
+    ei_printf("ERR: failed to allocate tensor arena\n");
+    return kTfLiteError;
+  }
+#else
+  uint8_t* arena = tensor_arena;
+  memset(arena, 0, kTensorArenaSize);
+#endif
+  return init_instance(&default_instance, arena);
+}
+
+TfLiteStatus tflite_learn_40_input(int index, TfLiteTensor *tensor) {
+  init_tflite_tensor(default_instance.tensor_arena, in_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_40_output(int index, TfLiteTensor *tensor) {
+  init_tflite_tensor(default_instance.tensor_arena, out_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_40_invoke() {
+  return invoke_instance(&default_instance);
+}
+
+TfLiteStatus tflite_learn_40_reset( void (*free_fnc)(void* ptr) ) {
+#ifdef EI_CLASSIFIER_ALLOCATION_HEAP
+  free_fnc(default_instance.tensor_arena);
+  default_instance.tensor_arena = nullptr;
+#endif
+
+  reset_instance(&default_instance);
+  return kTfLiteOk;
+}
+
+void* tflite_learn_40_create( void*(*alloc_fnc)(size_t,size_t), void (*free_fnc)(void* ptr) ) {
+  // the node copies go right behind the instance
+  void* mem = ei_calloc(1, sizeof(tflite_learn_40_instance) + sizeof(tflNodes));
+  if (!mem) {
+    ei_printf("ERR: failed to allocate model instance\n");
+    return nullptr;
+  }
+  tflite_learn_40_instance* inst = new (mem) tflite_learn_40_instance();
+  inst->nodes = reinterpret_cast<TfLiteNode*>(inst + 1);
+
+  uint8_t* arena = (uint8_t*) alloc_fnc(16, kTensorArenaSize);
+  if (!arena) {
+    ei_printf("ERR: failed to allocate tensor arena\n");
+    inst->~tflite_learn_40_instance();
+    ei_free(mem);
+    return nullptr;
+  }
+
+  if (init_instance(inst, arena) != kTfLiteOk) {
+    tflite_learn_40_destroy(inst, free_fnc);
+    return nullptr;
+  }
+  return inst;
+}
+
+TfLiteStatus tflite_learn_40_instance_input(void* instance, int index, TfLiteTensor *tensor) {
+  tflite_learn_40_instance* inst = static_cast<tflite_learn_40_instance*>(instance);
+  init_tflite_tensor(inst->tensor_arena, in_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_40_instance_output(void* instance, int index, TfLiteTensor *tensor) {
+  tflite_learn_40_instance* inst = static_cast<tflite_learn_40_instance*>(instance);
+  init_tflite_tensor(inst->tensor_arena, out_tensor_indices[index], tensor);
+  return kTfLiteOk;
+}
+
+TfLiteStatus tflite_learn_40_instance_invoke(void* instance) {
+  return invoke_instance(static_cast<tflite_learn_40_instance*>(instance));
+}
+
+TfLiteStatus tflite_learn_40_invoke_batch(void* instance, size_t batch_size,
+                                          TfLiteStatus (*set_input)(void* user, size_t ix),
+                                          TfLiteStatus (*on_output)(void* user, size_t ix), void* user) {
+  tflite_learn_40_instance* inst = instance ? static_cast<tflite_learn_40_instance*>(instance) : &default_instance;
+  return invoke_batch(inst, batch_size, set_input, on_output, user);
+}
+
+TfLiteStatus tflite_learn_40_destroy(void* instance, void (*free_fnc)(void* ptr)) {
+  tflite_learn_40_instance* inst = static_cast<tflite_learn_40_instance*>(instance);
+  if (!inst) {
+    return kTfLiteOk;
+  }
+  free_fnc(inst->tensor_arena);
+  reset_instance(inst);
+  inst->~tflite_learn_40_instance();
+  ei_free(inst);
+  return kTfLiteOk;
+}
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+size_t tflite_learn_40_layer_count() {
+  return 12;
+}
+
+TfLiteStatus tflite_learn_40_layer_stats(void* instance, size_t index, ei_tflite_layer_stats_t* stats) {
+  tflite_learn_40_instance* inst = instance ? static_cast<tflite_learn_40_instance*>(instance) : &default_instance;
+  if (index >= 12 || !stats) {
+    return kTfLiteError;
   }
-  overflow_buffers_ix = 0;
+  *stats = inst->layer_stats[index];
   return kTfLiteOk;
 }
+
+void tflite_learn_40_reset_layer_stats(void* instance) {
+  tflite_learn_40_instance* inst = instance ? static_cast<tflite_learn_40_instance*>(instance) : &default_instance;
+  for (size_t i = 0; i < 12; ++i) {
+    inst->layer_stats[i].invoke_count = 0;
+    inst->layer_stats[i].total_us = 0;
+    inst->layer_stats[i].last_us = 0;
+    inst->layer_stats[i].max_us = 0;
+  }
+}
+
+void tflite_learn_40_set_profiler(tflite::MicroProfilerInterface* profiler) {
+  layer_profiler = profiler;
+}
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+TfLiteStatus tflite_learn_40_set_early_exit(const ei_tflite_early_exit_head_t* head) {
+  if (head) {
+    const size_t in_bytes = tensorData[tflNodes[kEarlyExitNode].inputs->data[0]].bytes;
+    const size_t outputs = tensorData[tflNodes[11].outputs->data[0]].bytes;
+    if (!head->weights || head->channels == 0 || head->channels > kEarlyExitMaxChannels ||
+        in_bytes % head->channels != 0 || outputs > kEarlyExitMaxOutputs) {
+      ei_printf("ERR: early exit head does not fit the model (%u channels)\n", (unsigned)head->channels);
+      return kTfLiteError;
+    }
+  }
+  early_exit_head = head;
+  return kTfLiteOk;
+}
+
+void tflite_learn_40_early_exit_stats(ei_tflite_early_exit_stats_t* stats) {
+  stats->invokes = early_exit_invokes.load();
+  stats->exits = early_exit_exits.load();
+}
+
+void tflite_learn_40_reset_early_exit_stats() {
+  early_exit_invokes = 0;
+  early_exit_exits = 0;
+}
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+void tflite_learn_40_arena_usage(size_t* used_bytes, size_t* arena_bytes, size_t* overflow_bytes_out) {
+  const tflite_learn_40_instance* inst = &default_instance;
+  // tensors grow up from the start of the arena, persistent / scratch buffers down from the end
+  *used_bytes = inst->tensor_arena ? (size_t)(inst->tensor_boundary - inst->tensor_arena) + (size_t)(inst->tensor_arena + kTensorArenaSize - inst->current_location) : 0;
+  *arena_bytes = kTensorArenaSize;
+  *overflow_bytes_out = inst->overflow_bytes;
+}
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
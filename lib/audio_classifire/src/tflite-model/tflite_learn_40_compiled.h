@@ -34,6 +34,11 @@
 #define tflite_learn_40_GEN_H
 
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/classifier/ei_classifier_config.h"
+#include "edge-impulse-sdk/classifier/ei_arena_plan.h"
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING || EI_CLASSIFIER_TFLITE_EARLY_EXIT
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#endif
 
 // Sets up the model with init and prepare steps.
 TfLiteStatus tflite_learn_40_init( void*(*alloc_fnc)(size_t,size_t) );
@@ -46,6 +51,94 @@ TfLiteStatus tflite_learn_40_invoke();
 //Frees memory allocated
 TfLiteStatus tflite_learn_40_reset( void (*free)(void* ptr) );
 
+// Independent instances of the model, each with its own arena and context. The
+// weights are shared, so instances can be invoked from different threads at once.
+// Sets up a new instance, returns NULL if allocating or preparing it failed.
+void* tflite_learn_40_create( void*(*alloc_fnc)(size_t,size_t), void (*free_fnc)(void* ptr) );
+// Returns the input tensor of the instance with the given index.
+TfLiteStatus tflite_learn_40_instance_input(void* instance, int index, TfLiteTensor* tensor);
+// Returns the output tensor of the instance with the given index.
+TfLiteStatus tflite_learn_40_instance_output(void* instance, int index, TfLiteTensor* tensor);
+// Runs inference on the instance.
+TfLiteStatus tflite_learn_40_instance_invoke(void* instance);
+// Frees the instance and its arena.
+TfLiteStatus tflite_learn_40_destroy(void* instance, void (*free_fnc)(void* ptr));
+
+// Runs the model over batch_size inputs on an instance (NULL for the one set up by
+// tflite_learn_40_init). set_input fills the input tensor for input ix, on_output is
+// called while the output tensor holds the result of input ix. The fully connected
+// layers run once per chunk of inputs, so their weights are read once per chunk.
+TfLiteStatus tflite_learn_40_invoke_batch(void* instance, size_t batch_size,
+                                          TfLiteStatus (*set_input)(void* user, size_t ix),
+                                          TfLiteStatus (*on_output)(void* user, size_t ix), void* user);
+
+#if EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+// Returns the number of nodes that statistics are kept for.
+size_t tflite_learn_40_layer_count();
+// Returns timing and arena usage of the node with the given index, for an instance
+// (NULL for the one set up by tflite_learn_40_init). Every instance keeps its own.
+TfLiteStatus tflite_learn_40_layer_stats(void* instance, size_t index, ei_tflite_layer_stats_t* stats);
+// Clears the accumulated timings of an instance (arena usage is refreshed on every init).
+void tflite_learn_40_reset_layer_stats(void* instance);
+// Forwards an event per node of the default instance to the profiler; pass nullptr to detach.
+void tflite_learn_40_set_profiler(tflite::MicroProfilerInterface* profiler);
+#endif // EI_CLASSIFIER_TFLITE_LAYER_PROFILING
+
+#if EI_CLASSIFIER_TFLITE_EARLY_EXIT
+// Lets invokes exit through the head after the conv stack (before FULLY_CONNECTED/9)
+// when it is confident enough. The head must outlive the model; nullptr disables it.
+TfLiteStatus tflite_learn_40_set_early_exit(const ei_tflite_early_exit_head_t* head);
+// Returns how many invokes ran the head and how many of them exited.
+void tflite_learn_40_early_exit_stats(ei_tflite_early_exit_stats_t* stats);
+// Clears the early exit counters.
+void tflite_learn_40_reset_early_exit_stats();
+#endif // EI_CLASSIFIER_TFLITE_EARLY_EXIT
+
+#if EI_CLASSIFIER_MEMORY_ACCOUNTING
+// Returns the arena bytes used by tensors and persistent / scratch buffers
+// since the last init, the arena size and the bytes that overflowed to the heap.
+void tflite_learn_40_arena_usage(size_t* used_bytes, size_t* arena_bytes, size_t* overflow_bytes);
+#endif // EI_CLASSIFIER_MEMORY_ACCOUNTING
+
+// Non-persistent tensors: index, offset in the arena, size and the nodes they are
+// live for, as planned by the exporter (classifier/ei_arena_plan.h).
+constexpr ei_arena_plan_tensor_t tflite_learn_40_arena_tensors[] = {
+  { 0, 11968, 11960, 0, 0 },
+  { 14, 0, 11960, 0, 1 },
+  { 15, 11968, 2392, 1, 2 },
+  { 16, 0, 2392, 2, 3 },
+  { 17, 2400, 1200, 3, 4 },
+  { 18, 0, 1200, 4, 5 },
+  { 19, 2400, 2400, 5, 6 },
+  { 20, 0, 2400, 6, 7 },
+  { 21, 2400, 1200, 7, 8 },
+  { 22, 0, 1200, 8, 9 },
+  { 23, 1200, 512, 9, 10 },
+  { 24, 16, 5, 10, 11 },
+  { 25, 0, 5, 11, 11 },
+};
+constexpr size_t tflite_learn_40_arena_tensor_count = sizeof(tflite_learn_40_arena_tensors) / sizeof(tflite_learn_40_arena_tensors[0]);
+
+// Offset of the non-persistent tensor with the given index in the arena.
+constexpr size_t tflite_learn_40_tensor_offset(int index) {
+  return tflite_learn_40_arena_tensors[
+    ei_arena_plan_slot(tflite_learn_40_arena_tensors, tflite_learn_40_arena_tensor_count, index)].offset;
+}
+// End of the non-persistent tensors, persistent buffers are allocated above it.
+constexpr size_t tflite_learn_40_arena_tensor_size = ei_arena_plan_size(tflite_learn_40_arena_tensors, tflite_learn_40_arena_tensor_count);
+
+#if EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+// Arena layout, used to plan the arena together with the DSP buffers.
+#if defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX) || defined(EI_CLASSIFIER_ALLOCATION_STATIC_HIMAX_GNU)
+constexpr size_t tflite_learn_40_arena_size = 26208;
+#else
+constexpr size_t tflite_learn_40_arena_size = 25184;
+#endif
+constexpr size_t tflite_learn_40_input_offset = tflite_learn_40_tensor_offset(0);
+constexpr size_t tflite_learn_40_input_bytes = tflite_learn_40_arena_tensors[
+  ei_arena_plan_slot(tflite_learn_40_arena_tensors, tflite_learn_40_arena_tensor_count, 0)].bytes;
+#endif // EI_CLASSIFIER_UNIFIED_MEMORY_PLAN
+
 
 // Returns the number of input tensors.
 inline size_t tflite_learn_40_inputs() {
@@ -0,0 +1,158 @@
+#ifndef I2S_CAPTURE_H
+#define I2S_CAPTURE_H
+
+// I2S ingestion for the INMP441: reads whole DMA buffers and converts the 24-in-32-bit
+// words to the int16 mono samples the DSP consumes, with a digital gain (shift) and an
+// optional DC-blocking filter, all in integer arithmetic.
+//
+// Header only, like the classifier: the SDK headers can only be included by one file.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <driver/i2s.h>
+#include "edge-impulse-sdk/classifier/ei_continuous_scheduler.h"
+
+// Words per DMA buffer, used as dma_buf_len and as the unit of every read
+#define I2S_CAPTURE_BLOCK 1024
+
+struct I2SCapture {
+  i2s_port_t port;
+  uint8_t shift;        // bits dropped from the 24-bit sample, 8 = plain 24 -> 16 bit, less = more gain
+  uint8_t dcPoleBits;   // DC blocker pole at 1 - 2^-dcPoleBits (8: ~10 Hz at 16 kHz), 0 = off
+  int32_t dcPrev;       // previous 24-bit input
+  bool dcPrimed;        // dcPrev holds a real sample, so a start on a DC offset is no step
+  int32_t dcAcc;        // filter output, Q4
+  uint32_t overrunSamples;
+  int32_t raw[I2S_CAPTURE_BLOCK];
+};
+
+static inline void i2sCaptureInit(I2SCapture* cap, i2s_port_t port, uint8_t shift = 8, uint8_t dcPoleBits = 0) {
+  cap->port = port;
+  cap->shift = shift;
+  cap->dcPoleBits = dcPoleBits;
+  cap->dcPrev = 0;
+  cap->dcPrimed = false;
+  cap->dcAcc = 0;
+  cap->overrunSamples = 0;
+}
+
+// Clears the DC blocker, e.g. after I2S was stopped
+static inline void i2sCaptureReset(I2SCapture* cap) {
+  cap->dcPrev = 0;
+  cap->dcPrimed = false;
+  cap->dcAcc = 0;
+}
+
+static inline int16_t i2sCaptureSaturate(int32_t v) {
+  return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+// Converts count I2S words to int16. Without the DC blocker and with shift 8 this is
+// exactly (int16_t)(word >> 16).
+static inline void i2sCaptureConvert(I2SCapture* cap, const int32_t* in, int16_t* out, size_t count) {
+  const uint32_t shift = cap->shift;
+  size_t i = 0;
+
+  if (cap->dcPoleBits == 0 || count == 0) {
+    for (; i + 4 <= count; i += 4) {
+      out[i + 0] = i2sCaptureSaturate((in[i + 0] >> 8) >> shift);
+      out[i + 1] = i2sCaptureSaturate((in[i + 1] >> 8) >> shift);
+      out[i + 2] = i2sCaptureSaturate((in[i + 2] >> 8) >> shift);
+      out[i + 3] = i2sCaptureSaturate((in[i + 3] >> 8) >> shift);
+    }
+    for (; i < count; i++) {
+      out[i] = i2sCaptureSaturate((in[i] >> 8) >> shift);
+    }
+    return;
+  }
+
+  // y[n] = x[n] - x[n-1] + (1 - 2^-k) * y[n-1], y kept with 4 fractional bits
+  const uint32_t k = cap->dcPoleBits;
+  const uint32_t outShift = shift + 4;
+  int32_t prev = cap->dcPrimed ? cap->dcPrev : (in[0] >> 8);
+  int32_t acc = cap->dcAcc;
+
+#define I2S_CAPTURE_DC_STEP(j) {                        \
+    const int32_t x = in[j] >> 8;                       \
+    acc += ((x - prev) * 16) - (acc >> k);              \
+    prev = x;                                           \
+    out[j] = i2sCaptureSaturate(acc >> outShift);       \
+  }
+
+  for (; i + 4 <= count; i += 4) {
+    I2S_CAPTURE_DC_STEP(i + 0)
+    I2S_CAPTURE_DC_STEP(i + 1)
+    I2S_CAPTURE_DC_STEP(i + 2)
+    I2S_CAPTURE_DC_STEP(i + 3)
+  }
+  for (; i < count; i++) {
+    I2S_CAPTURE_DC_STEP(i)
+  }
+
+#undef I2S_CAPTURE_DC_STEP
+
+  cap->dcPrev = prev;
+  cap->dcPrimed = true;
+  cap->dcAcc = acc;
+}
+
+// Reads up to one DMA buffer (at most maxSamples) and converts it into out.
+// Returns the number of samples written, 0 on a read error or timeout.
+static inline size_t i2sCaptureRead(I2SCapture* cap, int16_t* out, size_t maxSamples, TickType_t timeout = portMAX_DELAY) {
+  size_t words = maxSamples < I2S_CAPTURE_BLOCK ? maxSamples : I2S_CAPTURE_BLOCK;
+  size_t bytesRead = 0;
+
+  if (i2s_read(cap->port, cap->raw, words * sizeof(int32_t), &bytesRead, timeout) != ESP_OK) {
+    return 0;
+  }
+
+  words = bytesRead / sizeof(int32_t);
+  i2sCaptureConvert(cap, cap->raw, out, words);
+  return words;
+}
+
+#if EIDSP_SIGNAL_C_FN_POINTER == 0
+// Reads one DMA buffer and converts it straight into the slice ring of the scheduler.
+// The buffer is always read so DMA never stalls; samples that do not fit are counted as
+// overrun by the scheduler. Returns the number of samples handed over.
+static inline size_t i2sCaptureToScheduler(I2SCapture* cap, ei_continuous_scheduler_t* sched, TickType_t timeout = portMAX_DELAY) {
+  size_t bytesRead = 0;
+
+  if (i2s_read(cap->port, cap->raw, sizeof(cap->raw), &bytesRead, timeout) != ESP_OK) {
+    return 0;
+  }
+
+  const uint32_t words = bytesRead / sizeof(int32_t);
+  uint32_t written = 0;
+
+  // at most two spans: up to the end of the ring, then from its start
+  for (int span = 0; span < 2 && written < words; span++) {
+    int16_t* dest;
+    uint32_t n = ei_scheduler_reserve(sched, &dest);
+    if (n == 0) {
+      break;
+    }
+    if (n > words - written) {
+      n = words - written;
+    }
+    i2sCaptureConvert(cap, cap->raw + written, dest, n);
+    ei_scheduler_commit(sched, n);
+    written += n;
+  }
+
+  if (written < words) {
+    // keep the DC blocker running over the audio that is dropped
+    int16_t scratch[64];
+    for (uint32_t i = written; i < words; i += 64) {
+      uint32_t n = words - i < 64 ? words - i : 64;
+      i2sCaptureConvert(cap, cap->raw + i, scratch, n);
+    }
+    ei_scheduler_commit(sched, 0, words - written);
+    cap->overrunSamples += words - written;
+  }
+
+  return written;
+}
+#endif // EIDSP_SIGNAL_C_FN_POINTER == 0
+
+#endif // I2S_CAPTURE_H
@@ -5,6 +5,9 @@
 // #include <NimBLE2902.h>
 #include "audio_classifire.h"
 #include <driver/i2s.h>
+#include "i2s_capture.h"
+#include <esp_timer.h>
+#include <freertos/event_groups.h>
 #include <math.h>
 
 #define SAMPLE_FREQ 16000                      
@@ -13,6 +16,8 @@
 #define I2S_WS 15    // Word Select (LRCL)
 #define I2S_SCK 13   // Bit Clock (BCLK) 
 #define I2S_SD 32 
+#define I2S_GAIN_SHIFT 8      // 24 -> 16 bit, lower for more digital gain
+#define I2S_DC_BLOCK_BITS 8   // DC blocker at ~10 Hz, 0 = off
 
 // BLE UUIDs
 #define SERVICE_UUID        "12345678-1234-1234-1234-123456789abc"
@@ -23,6 +28,7 @@ TFT_eSPI tft = TFT_eSPI();
 // Static buffer for audio data - using 16-bit integers (2 bytes per sample)
 static int16_t* audioBuffer = nullptr;
 static bool debug_nn = false;
+static I2SCapture i2sCapture;
 
 // BLE variables
 NimBLEServer* pServer = nullptr;
@@ -32,11 +38,71 @@ bool oldDeviceConnected = false;
 
 int currentTestStep = 0;
 int totalTestSteps = 6;
-String lastClassification = "None";
+const char* lastClassification = NULL;  // label of the last result, NULL before the first
 float lastConfidence = 0.0;
 unsigned long lastUpdateTime = 0;
 
-void displayTextClear(String text, int x = 20, int y = 100, uint16_t textColor = TFT_WHITE, uint16_t bgColor = TFT_BLACK, uint8_t textSize = 2) {
+// Boot: I2S comes up first in setup(), TFT, BLE and the model are brought up in their own tasks
+static EventGroupHandle_t bootEvents = nullptr;
+#define BOOT_TFT_READY   (1 << 0)
+#define BOOT_BLE_READY   (1 << 1)
+#define BOOT_MODEL_READY (1 << 2)
+
+// Boot profile, microseconds since reset per phase (0 = not reached). Send "boot" over serial to print it.
+enum BootPhase {
+  BOOT_SETUP_START,
+  BOOT_BUFFER_ALLOCATED,
+  BOOT_I2S_STARTED,
+  BOOT_TFT_DONE,
+  BOOT_BLE_DONE,
+  BOOT_MODEL_DONE,
+  BOOT_SETUP_DONE,
+  BOOT_FIRST_RESULT,
+  BOOT_PHASE_COUNT
+};
+static const char* bootPhaseNames[BOOT_PHASE_COUNT] = {
+  "setup start", "buffer allocated", "i2s started", "tft ready",
+  "ble ready", "model ready", "setup done", "first result"
+};
+static volatile int64_t bootProfile[BOOT_PHASE_COUNT] = { 0 };
+
+void bootMark(BootPhase phase) {
+  if (bootProfile[phase] == 0) {
+    bootProfile[phase] = esp_timer_get_time();
+  }
+}
+
+void printBootProfile() {
+  Serial.println("Boot profile (ms since reset):");
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    if (bootProfile[i] == 0) {
+      Serial.printf("  %-17s -\n", bootPhaseNames[i]);
+    } else {
+      Serial.printf("  %-17s %8.1f\n", bootPhaseNames[i], bootProfile[i] / 1000.0f);
+    }
+  }
+}
+
+// Serial commands, only "boot" for now
+void pollSerialCommands() {
+  static char line[16];
+  static size_t lineLen = 0;
+
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    if (c == '\r' || c == '\n') {
+      line[lineLen] = '\0';
+      if (strcmp(line, "boot") == 0) {
+        printBootProfile();
+      }
+      lineLen = 0;
+    } else if (lineLen < sizeof(line) - 1) {
+      line[lineLen++] = c;
+    }
+  }
+}
+
+void displayTextClear(const char* text, int x = 20, int y = 100, uint16_t textColor = TFT_WHITE, uint16_t bgColor = TFT_BLACK, uint8_t textSize = 2) {
   tft.fillScreen(bgColor);
   tft.setTextColor(textColor, bgColor);
   tft.setTextSize(textSize);
@@ -59,18 +125,20 @@ class MyServerCallbacks: public NimBLEServerCallbacks {
 
 
 // Function to send BLE message
-void sendBLEMessage(String message) {
+void sendBLEMessage(const char* message) {
   if (pCharacteristic != nullptr) {
-    pCharacteristic->setValue(message.c_str());
+    char text[96];
+    pCharacteristic->setValue(message);
     pCharacteristic->notify();
-    displayTextClear("BLE Sent: " + message, 10, 220, TFT_BLUE, TFT_BLACK, 1);
+    snprintf(text, sizeof(text), "BLE Sent: %s", message);
+    displayTextClear(text, 10, 220, TFT_BLUE, TFT_BLACK, 1);
   }
 }
 
 // Function to initialize BLE
+// Runs in its own task during boot, so it only reports over serial (the TFT belongs to the TFT task)
 void initBLE() {
-  
-  displayTextClear("Initializing BLE...", 10, 10, TFT_CYAN);
+  Serial.println("Initializing BLE...");
   
   NimBLEDevice::init("...");
   // NimBLEDevice::setDeviceName("Audio Classifier");
@@ -99,7 +167,7 @@ void initBLE() {
   // set value to 0x00 to not advertise this parameter
   NimBLEDevice::startAdvertising();
   
-  displayTextClear("BLE Ready - Advertising", 10, 10, TFT_GREEN);
+  Serial.println("BLE Ready - Advertising");
 }
 
 
@@ -119,7 +187,8 @@ void drawProgressBar(int x, int y, int width, int height, int progress, int tota
   }
   
   // Draw percentage text
-  String percentText = String((progress * 100) / total) + "%";
+  char percentText[8];
+  snprintf(percentText, sizeof(percentText), "%d%%", (progress * 100) / total);
   tft.setTextSize(1);
   tft.setTextColor(TFT_WHITE);
   int textWidth = tft.textWidth(percentText);
@@ -154,7 +223,8 @@ void drawStepIndicator(int x, int y, int currentStep, int totalSteps) {
     // Draw step number
     tft.setTextSize(1);
     tft.setTextColor(TFT_BLACK);
-    String stepNum = String(i + 1);
+    char stepNum[4];
+    snprintf(stepNum, sizeof(stepNum), "%d", i + 1);
     int textWidth = tft.textWidth(stepNum);
     tft.drawString(stepNum, stepX + (stepWidth - textWidth) / 2, y + 6);
   }
@@ -170,10 +240,11 @@ void drawHeader() {
   tft.drawString("Audio Classifier", 10, 5);
   
   // Draw last classification result
-  if (lastClassification != "None") {
+  if (lastClassification != NULL) {
     tft.setTextSize(1);
     tft.setTextColor(TFT_GREEN);
-    String result = "Last: " + lastClassification + " (" + String(lastConfidence, 1) + "%)";
+    char result[48];
+    snprintf(result, sizeof(result), "Last: %s (%.1f%%)", lastClassification, lastConfidence);
     tft.drawString(result, 10, 30);
   }
   
@@ -189,7 +260,8 @@ void drawHeader() {
   
   // Draw time
   unsigned long currentTime = millis();
-  String timeStr = "Time: " + String(currentTime / 1000) + "s";
+  char timeStr[24];
+  snprintf(timeStr, sizeof(timeStr), "Time: %lus", currentTime / 1000);
   tft.setTextColor(TFT_WHITE);
   tft.drawString(timeStr, 200, 20);
   
@@ -197,7 +269,7 @@ void drawHeader() {
   tft.drawLine(0, 60, 320, 60, TFT_WHITE);
 }
 
-void drawMainDisplay(String mainText, String subText = "", uint16_t mainColor = TFT_WHITE, uint16_t subColor = TFT_DARKGREY) {
+void drawMainDisplay(const char* mainText, const char* subText = "", uint16_t mainColor = TFT_WHITE, uint16_t subColor = TFT_DARKGREY) {
   // Clear main display area (below header and above footer)
   tft.fillRect(0, 61, 320, 120, TFT_BLACK);
   
@@ -208,7 +280,7 @@ void drawMainDisplay(String mainText, String subText = "", uint16_t mainColor =
   tft.drawString(mainText, (320 - mainTextWidth) / 2, 80);
   
   // Draw sub text if provided
-  if (subText != "") {
+  if (subText[0] != '\0') {
     tft.setTextSize(1);
     tft.setTextColor(subColor);
     int subTextWidth = tft.textWidth(subText);
@@ -230,18 +302,29 @@ void drawFooter() {
   drawStepIndicator(10, 205, currentTestStep, totalTestSteps);
   
   // Draw memory info
-  String memInfo = "Free: " + String(ESP.getFreeHeap()) + " bytes";
+  char memInfo[32];
+  snprintf(memInfo, sizeof(memInfo), "Free: %u bytes", (unsigned)ESP.getFreeHeap());
   tft.setTextColor(TFT_CYAN);
   tft.drawString(memInfo, 200, 190);
 }
 
-void updateDisplay(String mainText, String subText = "", uint16_t mainColor = TFT_WHITE, uint16_t subColor = TFT_DARKGREY) {
+void updateDisplay(const char* mainText, const char* subText = "", uint16_t mainColor = TFT_WHITE, uint16_t subColor = TFT_DARKGREY) {
   drawHeader();
   drawMainDisplay(mainText, subText, mainColor, subColor);
   drawFooter();
 }
 
-void configureI2S() {
+// I2S_WS shares GPIO15 with TFT_CS (platformio.ini). tft.init() turns the pin back into
+// a plain GPIO output, so the pins are routed to I2S again once the TFT is up.
+const i2s_pin_config_t i2sPinConfig = {
+  .bck_io_num = I2S_SCK,
+  .ws_io_num = I2S_WS,
+  .data_out_num = I2S_PIN_NO_CHANGE,
+  .data_in_num = I2S_SD
+};
+
+// Called before the TFT and BLE are up, so it only reports over serial
+bool configureI2S() {
   const i2s_config_t i2s_config = {
     .mode = i2s_mode_t(I2S_MODE_MASTER | I2S_MODE_RX),
     .sample_rate = SAMPLE_FREQ,
@@ -250,81 +333,110 @@ void configureI2S() {
     .communication_format = I2S_COMM_FORMAT_STAND_I2S,
     .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
     .dma_buf_count = 4,
-    .dma_buf_len = 1024,
+    .dma_buf_len = I2S_CAPTURE_BLOCK,
     .use_apll = false,
     .tx_desc_auto_clear = false,
     .fixed_mclk = 0
   };
 
-  const i2s_pin_config_t pin_config = {
-    .bck_io_num = I2S_SCK,
-    .ws_io_num = I2S_WS,
-    .data_out_num = I2S_PIN_NO_CHANGE,
-    .data_in_num = I2S_SD
-  };
-
   esp_err_t result = i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL);
   if (result != ESP_OK) {
-    updateDisplay("I2S Error!", "Driver install failed", TFT_RED, TFT_WHITE);
-    return;
+    Serial.println("I2S Error! Driver install failed");
+    return false;
   }
 
-  result = i2s_set_pin(I2S_NUM_0, &pin_config);
+  result = i2s_set_pin(I2S_NUM_0, &i2sPinConfig);
   if (result != ESP_OK) {
-    updateDisplay("I2S Error!", "Pin config failed", TFT_RED, TFT_WHITE);
-    return;
+    Serial.println("I2S Error! Pin config failed");
+    return false;
   }
 
   result = i2s_zero_dma_buffer(I2S_NUM_0);
   if (result != ESP_OK) {
-    updateDisplay("I2S Error!", "DMA clear failed", TFT_RED, TFT_WHITE);
-    return;
+    Serial.println("I2S Error! DMA clear failed");
+    return false;
   }
 
-  updateDisplay("I2S Ready", "Microphone configured", TFT_GREEN, TFT_WHITE);
-  sendBLEMessage("I2S microphone configured successfully");
+  i2sCaptureInit(&i2sCapture, I2S_NUM_0, I2S_GAIN_SHIFT, I2S_DC_BLOCK_BITS);
+  Serial.println("I2S Ready - Microphone configured");
+  return true;
+}
+
+void tftInitTask(void* param) {
+  tft.init();
+  tft.setRotation(1);
+  tft.fillScreen(TFT_BLACK);
+  updateDisplay("Audio Classifier", "Starting...", TFT_GREEN, TFT_WHITE);
+
+  bootMark(BOOT_TFT_DONE);
+  xEventGroupSetBits(bootEvents, BOOT_TFT_READY);
+  vTaskDelete(NULL);
+}
+
+void bleInitTask(void* param) {
+  initBLE();
+
+  bootMark(BOOT_BLE_DONE);
+  xEventGroupSetBits(bootEvents, BOOT_BLE_READY);
+  vTaskDelete(NULL);
+}
+
+static int zero_signal_get_data(size_t offset, size_t length, float *out_ptr) {
+  memset(out_ptr, 0, length * sizeof(float));
+  return 0;
+}
+
+// Warms the model up while the first window is recorded: one throw-away inference on
+// silence pays the one-time costs (ESP-NN kernel autotune, lazily built DSP tables,
+// allocator pool setup), so the first real run_classifier() does not
+void modelInitTask(void* param) {
+  signal_t signal;
+  signal.total_length = TOTAL_SAMPLES;
+  signal.get_data = &zero_signal_get_data;
+
+  ei_impulse_result_t result = { 0 };
+  EI_IMPULSE_ERROR r = run_classifier(&signal, &result, false);
+  if (r != EI_IMPULSE_OK) {
+    Serial.printf("Model warm-up failed (%d)\n", r);
+  }
+
+  // forget the warm-up in the impulse and postprocessing state
+  run_classifier_init();
+
+  bootMark(BOOT_MODEL_DONE);
+  xEventGroupSetBits(bootEvents, BOOT_MODEL_READY);
+  vTaskDelete(NULL);
 }
 
 // Function to generate dummy audio data
 void sampleAudioData(int16_t* buffer, int samples) {
+  char message[64];
   updateDisplay("Recording...", "Sampling audio from mic", TFT_YELLOW, TFT_WHITE);
   sendBLEMessage("Starting audio recording...");
   
   int progressUpdateInterval = samples / 20; // Update 20 times
-  int32_t i2s_buffer[1024]; // Temporary buffer for I2S data
-  size_t bytes_read = 0;
+  int nextProgressUpdate = progressUpdateInterval;
   int samplesRead = 0;
   
   // Start I2S
   i2s_start(I2S_NUM_0);
+  i2sCaptureReset(&i2sCapture);
   
   while (samplesRead < samples) {
-    // Calculate how many samples to read this iteration
-    int samplesToRead = min(1024, samples - samplesRead);
-    
-    // Read from I2S
-    esp_err_t result = i2s_read(I2S_NUM_0, i2s_buffer, samplesToRead * sizeof(int32_t), &bytes_read, portMAX_DELAY);
+    // Read a DMA buffer and convert it straight into the audio buffer
+    size_t got = i2sCaptureRead(&i2sCapture, buffer + samplesRead, samples - samplesRead);
     
-    if (result != ESP_OK) {
+    if (got == 0) {
       updateDisplay("I2S Error!", "Read failed", TFT_RED, TFT_WHITE);
       sendBLEMessage("ERROR: I2S read failed");
       break;
     }
-    
-    int actualSamples = bytes_read / sizeof(int32_t);
-    
-    // Convert 32-bit I2S data to 16-bit and store in buffer
-    for (int i = 0; i < actualSamples && samplesRead < samples; i++) {
-      // INMP441 data is in the upper 24 bits of the 32-bit word
-      // Shift right by 16 to get 16-bit data
-      buffer[samplesRead] = (int16_t)(i2s_buffer[i] >> 16);
-      Serial.printf("Sample %d: %d\n", samplesRead, buffer[samplesRead]);
-      samplesRead++;
-    }
+    samplesRead += got;
     
     // Update progress display
-    if (samplesRead % progressUpdateInterval == 0 || samplesRead >= samples) {
+    if (samplesRead >= nextProgressUpdate || samplesRead >= samples) {
       int progress = (samplesRead * 100) / samples;
+      nextProgressUpdate += progressUpdateInterval;
       
       // Clear progress area
       tft.fillRect(0, 140, 320, 40, TFT_BLACK);
@@ -335,19 +447,22 @@ void sampleAudioData(int16_t* buffer, int samples) {
       // Draw progress text
       tft.setTextSize(1);
       tft.setTextColor(TFT_WHITE);
-      String progressText = "Recording audio...";
+      const char* progressText = "Recording audio...";
       int textWidth = tft.textWidth(progressText);
       tft.drawString(progressText, (320 - textWidth) / 2, 130);
       
-      sendBLEMessage("Recording: " + String(progress) + "% (" + String(samplesRead) + "/" + String(samples) + ")");
+      snprintf(message, sizeof(message), "Recording: %d%% (%d/%d)", progress, samplesRead, samples);
+      sendBLEMessage(message);
     }
   }
   
   // Stop I2S
   i2s_stop(I2S_NUM_0);
   
-  updateDisplay("Recording Complete", String(samplesRead) + " samples captured", TFT_GREEN, TFT_WHITE);
-  sendBLEMessage("Audio recording completed - " + String(samplesRead) + " samples");
+  snprintf(message, sizeof(message), "%d samples captured", samplesRead);
+  updateDisplay("Recording Complete", message, TFT_GREEN, TFT_WHITE);
+  snprintf(message, sizeof(message), "Audio recording completed - %d samples", samplesRead);
+  sendBLEMessage(message);
   delay(1000);
 }
 
@@ -371,6 +486,7 @@ static int audio_signal_get_data(size_t offset, size_t length, float *out_ptr) {
 // Enhanced function to generate dummy audio data with progress
 // Enhanced classification function
 void classifyRealAudio() {
+    char message[64];
     currentTestStep = 0;
     
     updateDisplay("Prepare to Record", "Audio will be captured for 3 seconds", TFT_CYAN, TFT_WHITE);
@@ -388,39 +504,48 @@ void classifyRealAudio() {
     signal.total_length = TOTAL_SAMPLES;
     signal.get_data = &audio_signal_get_data;
     
-    // Run classifier
+    // Run classifier (once the model task is done)
+    xEventGroupWaitBits(bootEvents, BOOT_MODEL_READY, pdFALSE, pdTRUE, portMAX_DELAY);
     ei_impulse_result_t result = { 0 };
     EI_IMPULSE_ERROR r = run_classifier(&signal, &result, debug_nn);
     
     if (r != EI_IMPULSE_OK) {
         updateDisplay("Error!", "Classification failed", TFT_RED, TFT_WHITE);
-        sendBLEMessage("Error: Classification failed (" + String(r) + ")");
+        snprintf(message, sizeof(message), "Error: Classification failed (%d)", (int)r);
+        sendBLEMessage(message);
         delay(2000);
         return;
     }
     
-    // Find the class with highest confidence
+    if (bootProfile[BOOT_FIRST_RESULT] == 0) {
+        bootMark(BOOT_FIRST_RESULT);
+        printBootProfile();
+    }
+    
+    // Find the class with highest confidence (ranked on the quantized scores)
     float maxConfidence = 0.0;
-    String bestClass = "Unknown";
+    const char *bestLabel = "Unknown";
+    ei_classifier_top_t top;
     
-    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
-        float confidence = result.classification[ix].value;
+    if (ei_classifier_top_k(&result, &top, 1, 0.0f) > 0) {
+        float confidence = ei_classifier_score(&result, top.index);
         
-        if (confidence > maxConfidence) {
+        if (confidence > 0.0f) {
             maxConfidence = confidence;
-            bestClass = String(result.classification[ix].label);
+            bestLabel = result.classification[top.index].label;
         }
     }
     
     // Update global variables for header display
-    lastClassification = bestClass;
+    lastClassification = bestLabel;
     lastConfidence = maxConfidence * 100;
     
     // Display results
-    String confidenceText = String(maxConfidence * 100, 1) + "% confidence";
-    updateDisplay(bestClass, confidenceText, TFT_GREEN, TFT_WHITE);
+    snprintf(message, sizeof(message), "%.1f%% confidence", maxConfidence * 100);
+    updateDisplay(bestLabel, message, TFT_GREEN, TFT_WHITE);
     
-    sendBLEMessage("Result: " + bestClass + " (" + String(maxConfidence * 100, 1) + "%)");
+    snprintf(message, sizeof(message), "Result: %s (%.1f%%)", bestLabel, maxConfidence * 100);
+    sendBLEMessage(message);
     
     // Show all classification results
     delay(2000);
@@ -428,71 +553,78 @@ void classifyRealAudio() {
     delay(1000);
     
     for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
-        String className = String(result.classification[ix].label);
-        float confidence = result.classification[ix].value * 100;
+        const char* className = result.classification[ix].label;
+        float confidence = ei_classifier_score(&result, ix) * 100;
         
-        updateDisplay(className, String(confidence, 1) + "%", 
+        snprintf(message, sizeof(message), "%.1f%%", confidence);
+        updateDisplay(className, message, 
                      confidence > 50 ? TFT_GREEN : TFT_WHITE, TFT_DARKGREY);
-        sendBLEMessage(className + ": " + String(confidence, 1) + "%");
+        snprintf(message, sizeof(message), "%s: %.1f%%", className, confidence);
+        sendBLEMessage(message);
         delay(1500);
     }
     
     // Show timing info
-    String timingInfo = "DSP: " + String(result.timing.dsp) + "ms, Class: " + String(result.timing.classification) + "ms";
+    char timingInfo[48];
+    snprintf(timingInfo, sizeof(timingInfo), "DSP: %dms, Class: %dms", result.timing.dsp, result.timing.classification);
     updateDisplay("Timing Info", timingInfo, TFT_YELLOW, TFT_CYAN);
-    sendBLEMessage("Timing - " + timingInfo);
+    snprintf(message, sizeof(message), "Timing - %s", timingInfo);
+    sendBLEMessage(message);
     
     delay(3000);
 }
 void setup() {
+  bootMark(BOOT_SETUP_START);
   Serial.begin(115200);
-  while(!Serial);
-  tft.init();
-  tft.setRotation(1);
-  tft.fillScreen(TFT_BLACK);
+  bootEvents = xEventGroupCreate();
 
-  updateDisplay("Audio Classifier", "Initializing...", TFT_GREEN, TFT_WHITE);
-  
-  // Initialize BLE
-  initBLE();
-  
-  updateDisplay("Memory Check", "Free: " + String(ESP.getFreeHeap()) + " bytes", TFT_CYAN, TFT_WHITE);
-  delay(1000);
-  
-  // Calculate required memory size
+  // Allocate the audio buffer before BLE fragments the heap
   size_t bufferSize = TOTAL_SAMPLES * sizeof(int16_t);
-  updateDisplay("Allocating Memory", String(bufferSize) + " bytes needed", TFT_YELLOW, TFT_WHITE);
-  
-  // Allocate buffer dynamically
   audioBuffer = (int16_t*)malloc(bufferSize);
-  
+  bootMark(BOOT_BUFFER_ALLOCATED);
+
+  // Microphone first, it settles while the rest comes up
+  bool i2sOk = configureI2S();
+  bootMark(BOOT_I2S_STARTED);
+
+  xTaskCreate(tftInitTask, "boot_tft", 4096, NULL, 2, NULL);
+  xTaskCreate(bleInitTask, "boot_ble", 8192, NULL, 2, NULL);
+  xTaskCreate(modelInitTask, "boot_model", 8192, NULL, 1, NULL);
+
+  // The model task may still be running, classifyRealAudio() waits for it
+  xEventGroupWaitBits(bootEvents, BOOT_TFT_READY | BOOT_BLE_READY, pdFALSE, pdTRUE, portMAX_DELAY);
+
+  // take GPIO15 back from the TFT, see i2sPinConfig
+  if (i2sOk && i2s_set_pin(I2S_NUM_0, &i2sPinConfig) != ESP_OK) {
+    Serial.println("I2S Error! Pin config failed");
+    i2sOk = false;
+  }
+
   if (audioBuffer == NULL) {
-    updateDisplay("MEMORY ERROR!", "Not enough heap space", TFT_RED, TFT_WHITE);
+    char needed[32];
+    snprintf(needed, sizeof(needed), "%u bytes needed", (unsigned)bufferSize);
+    updateDisplay("MEMORY ERROR!", needed, TFT_RED, TFT_WHITE);
     sendBLEMessage("ERROR: Memory allocation failed!");
     while(1); // Stop execution
   }
-  
-  updateDisplay("Memory OK!", "Buffer allocated successfully", TFT_GREEN, TFT_WHITE);
-  sendBLEMessage("Memory allocated successfully");
-  delay(1000);
-  
-
-   // Configure I2S for INMP441 microphone
-  configureI2S();
-  delay(1000);
-
-  // Display model info
-  String modelInfo = String(TOTAL_SAMPLES) + " samples, " + String((float)TOTAL_SAMPLES / SAMPLE_FREQ, 1) + "s";
-  updateDisplay("Model Ready", modelInfo, TFT_CYAN, TFT_WHITE);
-  sendBLEMessage("Model Info - " + modelInfo);
-  delay(2000);
+  if (!i2sOk) {
+    updateDisplay("I2S Error!", "Microphone setup failed", TFT_RED, TFT_WHITE);
+  }
 
-  updateDisplay("Starting Tests", "6 signal types to test", TFT_WHITE, TFT_CYAN);
-  sendBLEMessage("System ready - Starting classification tests");
-  delay(1000);
+  // the model may still be warming up, the first classification waits for it
+  char modelInfo[40];
+  snprintf(modelInfo, sizeof(modelInfo), "%d samples, %.1fs", TOTAL_SAMPLES, (float)TOTAL_SAMPLES / SAMPLE_FREQ);
+  if (xEventGroupGetBits(bootEvents) & BOOT_MODEL_READY) {
+    updateDisplay("Model Ready", modelInfo, TFT_CYAN, TFT_WHITE);
+  } else {
+    updateDisplay("Loading Model", modelInfo, TFT_CYAN, TFT_WHITE);
+  }
+  bootMark(BOOT_SETUP_DONE);
 }
 
 void loop() {
+  pollSerialCommands();
+
   // Handle BLE connection changes
   if (!deviceConnected && oldDeviceConnected) {
     delay(500);
@@ -507,6 +639,7 @@ void loop() {
   // Test different signal types
   for (int signalType = 0; signalType < 6; signalType++) {
     classifyRealAudio();
+    pollSerialCommands();
     delay(1000);
   }
   
@@ -517,6 +650,6 @@ void loop() {
   
   // Reset for next cycle
   currentTestStep = 0;
-  lastClassification = "None";
+  lastClassification = NULL;
   lastConfidence = 0.0;
 }